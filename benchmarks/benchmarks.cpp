@@ -0,0 +1,642 @@
+#include "basic_trade_system.h"
+#include "matching_engine.h"
+#include "order_flow.h"
+#include "risk_controller.h"
+#include "snapshot.h"
+#include "trade_system.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// benchmarks.cpp 对撮合引擎、风控引擎和 TradeSystem 的热路径做微基准测试。
+// 每项在不同的订单簿深度下运行，逐次计时，报告吞吐量和延迟分位数。
+// 被测操作之外的准备工作（如撤掉刚入簿的订单以保持深度不变）不计时。
+//
+// 用法: benchmarks [--depths 10,1000,...] [--ops N] [--filter 名称子串]
+//   depths 缺省为 10 到 10^6 的各个数量级，ops 缺省为 200000。
+//   应使用 Release 构建（-DCMAKE_BUILD_TYPE=Release）。
+
+using namespace hdf;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<size_t> depths = {10, 100, 1000, 10000, 100000, 1000000};
+    size_t ops = 200000;
+    std::string_view filter;
+};
+
+/**
+ * @brief 逐次记录被测操作的耗时。
+ * 耗时数组预先分配，记录时不分配内存。
+ */
+class LatencyRecorder {
+  public:
+    explicit LatencyRecorder(size_t ops) { samples_.reserve(ops); }
+
+    void start() { begin_ = Clock::now(); }
+    void stop() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      Clock::now() - begin_)
+                      .count();
+        samples_.push_back(static_cast<uint64_t>(ns));
+        total_ += ns;
+    }
+
+    /**
+     * @brief 打印一行结果，吞吐量按被测操作的累计耗时计算。
+     */
+    void report(std::string_view name, size_t depth) {
+        if (samples_.empty()) {
+            return;
+        }
+        std::sort(samples_.begin(), samples_.end());
+        auto pct = [this](double p) {
+            size_t i = static_cast<size_t>(p * (samples_.size() - 1));
+            return static_cast<unsigned long long>(samples_[i]);
+        };
+        double seconds = total_ * 1e-9;
+        std::printf("%-38.*s %8zu %9zu %10.3f %7llu %7llu %7llu %8llu %9llu\n",
+                    static_cast<int>(name.size()), name.data(), depth,
+                    samples_.size(),
+                    seconds > 0 ? samples_.size() / seconds / 1e6 : 0.0,
+                    pct(0.50), pct(0.90), pct(0.99), pct(0.999),
+                    static_cast<unsigned long long>(samples_.back()));
+        std::fflush(stdout);
+    }
+
+  private:
+    std::vector<uint64_t> samples_;
+    Clock::time_point begin_;
+    int64_t total_ = 0;
+};
+
+// 价位以最小变动价位为单位，买卖两边围绕 MID_TICK 分布
+constexpr int64_t MID_TICK = 5000;
+// 单边最多的价位数，深度更大时同一价位排多笔挂单
+constexpr size_t MAX_LEVELS = 1000;
+constexpr uint32_t LOT = 100;
+
+ClOrderId makeId(char prefix, uint64_t n) {
+    char buf[ClOrderId::CAPACITY];
+    buf[0] = prefix;
+    auto [end, ec] = std::to_chars(buf + 1, buf + sizeof(buf), n);
+    return ClOrderId(std::string_view(buf, end - buf));
+}
+
+ShareholderId makeShareholder(char prefix, uint64_t n) {
+    char buf[ShareholderId::CAPACITY];
+    buf[0] = prefix;
+    auto [end, ec] = std::to_chars(buf + 1, buf + sizeof(buf), n);
+    return ShareholderId(std::string_view(buf, end - buf));
+}
+
+SecurityId makeSecurity(uint64_t n) {
+    char buf[8];
+    std::snprintf(buf, sizeof(buf), "%06llu",
+                  static_cast<unsigned long long>(600000 + n));
+    return SecurityId(buf);
+}
+
+Order makeOrder(const ClOrderId &id, Side side, int64_t tick, uint32_t qty,
+                const ShareholderId &shareholder,
+                const SecurityId &security = "600000") {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = security;
+    order.side = side;
+    order.price = Price::fromRaw(tick * Price::TICK);
+    order.qty = qty;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+// 第 i 笔卖方挂单的价位：从最优价向外依次铺开
+int64_t askTick(size_t i, size_t depth) {
+    size_t levels = std::min(std::max<size_t>(depth / 2, 1), MAX_LEVELS);
+    return MID_TICK + 1 + static_cast<int64_t>(i % levels);
+}
+
+int64_t bidTick(size_t i, size_t depth) {
+    size_t levels = std::min(std::max<size_t>(depth / 2, 1), MAX_LEVELS);
+    return MID_TICK - 1 - static_cast<int64_t>(i % levels);
+}
+
+/**
+ * @brief 买卖两边共 depth 笔挂单，挂单方股东只卖或只买，不触发对敲。
+ */
+std::vector<Order> makeBook(size_t depth, uint32_t qty) {
+    std::vector<Order> orders;
+    orders.reserve(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        bool ask = i % 2 == 0;
+        orders.push_back(makeOrder(
+            makeId('M', i), ask ? Side::SELL : Side::BUY,
+            ask ? askTick(i / 2, depth) : bidTick(i / 2, depth), qty,
+            makeShareholder(ask ? 'S' : 'B', i % 1000)));
+    }
+    return orders;
+}
+
+bool selected(const Options &options, std::string_view name) {
+    return options.filter.empty() ||
+           name.find(options.filter) != std::string_view::npos;
+}
+
+// ---------------------------------------------------------------------------
+// MatchingEngine
+
+void benchMatchingAddOrder(size_t depth, const Options &options) {
+    MatchingEngine engine;
+    EngineConfig config;
+    config.expectedOrders = depth + 1;
+    engine.reserve(config);
+    for (const Order &order : makeBook(depth, LOT)) {
+        engine.addOrder(order);
+    }
+    std::mt19937_64 rng(1);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order order = makeOrder(makeId('N', i), Side::SELL,
+                                askTick(rng() % depth, depth), LOT, "S0");
+        rec.start();
+        engine.addOrder(order);
+        rec.stop();
+        engine.cancelOrder(order.clOrderId);
+    }
+    rec.report("matching.addOrder", depth);
+}
+
+void benchMatchingCancelOrder(size_t depth, const Options &options) {
+    MatchingEngine engine;
+    EngineConfig config;
+    config.expectedOrders = depth;
+    engine.reserve(config);
+    std::vector<Order> book = makeBook(depth, LOT);
+    for (const Order &order : book) {
+        engine.addOrder(order);
+    }
+    std::mt19937_64 rng(2);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        const Order &order = book[rng() % depth];
+        rec.start();
+        engine.cancelOrder(order.clOrderId);
+        rec.stop();
+        engine.addOrder(order);
+    }
+    rec.report("matching.cancelOrder", depth);
+}
+
+void benchMatchingMatch(size_t depth, const Options &options) {
+    MatchingEngine engine;
+    EngineConfig config;
+    config.expectedOrders = depth;
+    engine.reserve(config);
+    for (const Order &order : makeBook(depth, LOT)) {
+        engine.addOrder(order);
+    }
+    // 主动买单吃掉最优卖价队头的一笔挂单，再在同价位补回一笔
+    int64_t best = askTick(0, depth);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order taker =
+            makeOrder(makeId('T', i), Side::BUY, best, LOT, "T0");
+        rec.start();
+        engine.match(taker);
+        rec.stop();
+        engine.addOrder(
+            makeOrder(makeId('R', i), Side::SELL, best, LOT, "S0"));
+    }
+    rec.report("matching.match", depth);
+}
+
+void benchMatchingReduceOrderQty(size_t depth, const Options &options) {
+    MatchingEngine engine;
+    EngineConfig config;
+    config.expectedOrders = depth;
+    engine.reserve(config);
+    // 数量足够大，减量不会把挂单减到0
+    std::vector<Order> book = makeBook(depth, 1'000'000'000);
+    for (const Order &order : book) {
+        engine.addOrder(order);
+    }
+    std::mt19937_64 rng(3);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        const ClOrderId &id = book[rng() % depth].clOrderId;
+        rec.start();
+        engine.reduceOrderQty(id, 1);
+        rec.stop();
+    }
+    rec.report("matching.reduceOrderQty", depth);
+}
+
+// ---------------------------------------------------------------------------
+// RiskController
+
+// 风控的订单分布在 100 只股票和 depth / 10 个股东上
+constexpr size_t RISK_SECURITIES = 100;
+
+std::vector<Order> makeRiskOrders(size_t depth, SymbolTable &symbols) {
+    size_t shareholders = std::max<size_t>(depth / 10, 1);
+    std::vector<Order> orders;
+    orders.reserve(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        Order order = makeOrder(makeId('M', i), i % 2 ? Side::BUY : Side::SELL,
+                                MID_TICK, LOT,
+                                makeShareholder('H', i % shareholders),
+                                makeSecurity(i % RISK_SECURITIES));
+        symbols.intern(order);
+        orders.push_back(order);
+    }
+    return orders;
+}
+
+void benchRiskCheckOrder(size_t depth, const Options &options) {
+    SymbolTable symbols;
+    RiskController risk(symbols);
+    EngineConfig config;
+    config.expectedOrders = depth;
+    risk.reserve(config);
+    std::vector<Order> orders = makeRiskOrders(depth, symbols);
+    for (const Order &order : orders) {
+        risk.onOrderAccepted(order);
+    }
+    // 检查与已有订单同股东、同股票的订单，一半方向相反
+    std::mt19937_64 rng(4);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order order = orders[rng() % depth];
+        if (i % 2) {
+            order.side = order.side == Side::BUY ? Side::SELL : Side::BUY;
+        }
+        rec.start();
+        risk.checkOrder(order);
+        rec.stop();
+    }
+    rec.report("risk.checkOrder", depth);
+}
+
+void benchRiskOnOrderAccepted(size_t depth, const Options &options) {
+    SymbolTable symbols;
+    RiskController risk(symbols);
+    EngineConfig config;
+    config.expectedOrders = depth + 1;
+    risk.reserve(config);
+    std::vector<Order> orders = makeRiskOrders(depth, symbols);
+    for (const Order &order : orders) {
+        risk.onOrderAccepted(order);
+    }
+    std::mt19937_64 rng(5);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order order = orders[rng() % depth];
+        order.clOrderId = makeId('N', i);
+        rec.start();
+        risk.onOrderAccepted(order);
+        rec.stop();
+        risk.onOrderCanceled(order.clOrderId);
+    }
+    rec.report("risk.onOrderAccepted", depth);
+}
+
+void benchRiskOnOrderCanceled(size_t depth, const Options &options) {
+    SymbolTable symbols;
+    RiskController risk(symbols);
+    EngineConfig config;
+    config.expectedOrders = depth;
+    risk.reserve(config);
+    std::vector<Order> orders = makeRiskOrders(depth, symbols);
+    for (const Order &order : orders) {
+        risk.onOrderAccepted(order);
+    }
+    std::mt19937_64 rng(6);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        const Order &order = orders[rng() % depth];
+        rec.start();
+        risk.onOrderCanceled(order.clOrderId);
+        rec.stop();
+        risk.onOrderAccepted(order);
+    }
+    rec.report("risk.onOrderCanceled", depth);
+}
+
+void benchRiskOnOrderExecuted(size_t depth, const Options &options) {
+    SymbolTable symbols;
+    RiskController risk(symbols);
+    EngineConfig config;
+    config.expectedOrders = depth;
+    risk.reserve(config);
+    std::vector<Order> orders = makeRiskOrders(depth, symbols);
+    for (Order &order : orders) {
+        order.qty = 1'000'000'000;
+        risk.onOrderAccepted(order);
+    }
+    std::mt19937_64 rng(7);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        const ClOrderId &id = orders[rng() % depth].clOrderId;
+        rec.start();
+        risk.onOrderExecuted(id, 1);
+        rec.stop();
+    }
+    rec.report("risk.onOrderExecuted", depth);
+}
+
+// ---------------------------------------------------------------------------
+// TradeSystem
+
+// 记下最近一笔撤单请求，用于回复内部撮合的撤单
+class LastCancelSink final : public ExchangeSink {
+  public:
+    void onOrder(const Order &) override {}
+    void onCancel(const CancelOrder &cancel) override { last = cancel; }
+    CancelOrder last;
+};
+
+void fillSystem(TradeSystem &system, size_t depth) {
+    for (const Order &order : makeBook(depth, LOT)) {
+        system.handleOrder(order);
+    }
+}
+
+// 不成交的买单入簿，之后撤掉以保持深度
+void benchExchangeRest(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth + 1;
+    TradeSystem system(config);
+    fillSystem(system, depth);
+    std::mt19937_64 rng(8);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order order = makeOrder(makeId('N', i), Side::BUY,
+                                bidTick(rng() % depth, depth), LOT, "B0");
+        rec.start();
+        system.handleOrder(order);
+        rec.stop();
+        CancelOrder cancel;
+        cancel.clOrderId = makeId('C', i);
+        cancel.origClOrderId = order.clOrderId;
+        system.handleCancel(cancel);
+    }
+    rec.report("system.exchange.handleOrder.rest", depth);
+}
+
+// 买单吃掉最优卖价的一笔挂单，之后补回
+void benchExchangeMatch(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth;
+    TradeSystem system(config);
+    fillSystem(system, depth);
+    int64_t best = askTick(0, depth);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order taker = makeOrder(makeId('T', i), Side::BUY, best, LOT, "T0");
+        rec.start();
+        system.handleOrder(taker);
+        rec.stop();
+        system.handleOrder(
+            makeOrder(makeId('R', i), Side::SELL, best, LOT, "S0"));
+    }
+    rec.report("system.exchange.handleOrder.match", depth);
+}
+
+// 不成交的买单入簿并转发交易所，之后以交易所成交回报移出
+void benchPreExchangeRest(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth + 1;
+    TradeSystem system(config);
+    LastCancelSink exchange;
+    system.setExchangeSink(&exchange);
+    fillSystem(system, depth);
+    std::mt19937_64 rng(9);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order order = makeOrder(makeId('N', i), Side::BUY,
+                                bidTick(rng() % depth, depth), LOT, "B0");
+        rec.start();
+        system.handleOrder(order);
+        rec.stop();
+        OrderResponse fill = detail::makeConfirm(order, order.qty);
+        fill.type = OrderResponse::EXECUTION;
+        fill.execQty = order.qty;
+        fill.execPrice = order.price;
+        system.handleResponse(fill);
+    }
+    rec.report("system.pre_exchange.handleOrder.rest", depth);
+}
+
+// 买单与最优卖价内部撮合，发出撤单；之后回复撤单确认结算并补回挂单
+void benchPreExchangeMatch(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth;
+    config.expectedPendingMatches = 16;
+    TradeSystem system(config);
+    LastCancelSink exchange;
+    system.setExchangeSink(&exchange);
+    fillSystem(system, depth);
+    int64_t best = askTick(0, depth);
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        Order taker = makeOrder(makeId('T', i), Side::BUY, best, LOT, "T0");
+        rec.start();
+        system.handleOrder(taker);
+        rec.stop();
+        CancelResponse confirm;
+        confirm.clOrderId = exchange.last.clOrderId;
+        confirm.origClOrderId = exchange.last.origClOrderId;
+        confirm.type = CancelResponse::CONFIRM;
+        system.handleResponse(confirm);
+        system.handleOrder(
+            makeOrder(makeId('R', i), Side::SELL, best, LOT, "S0"));
+    }
+    rec.report("system.pre_exchange.handleOrder.match", depth);
+}
+
+// 合成订单流：先送入 depth 条消息预热，再逐条计时 ops 条消息，
+// 订单和撤单混合，含可成交、零股和对敲被拒的订单
+void benchExchangeFlow(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth + options.ops;
+    TradeSystem system(config);
+    OrderFlowGenerator generator{OrderFlowConfig{}};
+    auto handle = [&system](const OrderFlowGenerator::Message &message) {
+        if (message.kind == OrderFlowGenerator::Message::Kind::ORDER) {
+            system.handleOrder(message.order);
+        } else {
+            system.handleCancel(message.cancel);
+        }
+    };
+    for (size_t i = 0; i < depth; ++i) {
+        handle(generator.next());
+    }
+    LatencyRecorder rec(options.ops);
+    for (size_t i = 0; i < options.ops; ++i) {
+        const OrderFlowGenerator::Message &message = generator.next();
+        rec.start();
+        handle(message);
+        rec.stop();
+    }
+    rec.report("system.exchange.flow", depth);
+}
+
+// 快照拷贝在处理线程上进行，期间撮合暂停；耗时与挂单数成正比，
+// 每次拷贝都很慢，次数取 ops/10000（至少10次）
+void benchSnapshotCapture(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth;
+    TradeCore core(config);
+    NullClientSink sink;
+    using Logic = detail::TradeLogic<TradeMode::EXCHANGE, NullClientSink,
+                                     NullExchangeSink>;
+    for (const Order &order : makeBook(depth, LOT)) {
+        Logic::handleOrder(core, sink, nullptr, order);
+    }
+    std::vector<uint8_t> image;
+    snapshot::capture(core, 0, image);
+    size_t runs = std::max<size_t>(10, options.ops / 10000);
+    LatencyRecorder rec(runs);
+    for (size_t i = 0; i < runs; ++i) {
+        rec.start();
+        snapshot::capture(core, i, image);
+        rec.stop();
+    }
+    rec.report("snapshot.capture", depth);
+}
+
+// SnapshotWriter::capture 在处理线程上的暂停：只有 fork，
+// 子进程写文件的时间不计入（每次之间等待写完）
+void benchSnapshotWriter(size_t depth, const Options &options) {
+    EngineConfig config;
+    config.expectedOrders = depth;
+    TradeCore core(config);
+    NullClientSink sink;
+    using Logic = detail::TradeLogic<TradeMode::EXCHANGE, NullClientSink,
+                                     NullExchangeSink>;
+    for (const Order &order : makeBook(depth, LOT)) {
+        Logic::handleOrder(core, sink, nullptr, order);
+    }
+    std::string path = (std::filesystem::temp_directory_path() /
+                        "hdf_benchmark_snapshot.hds")
+                           .string();
+    SnapshotWriter writer(path);
+    size_t runs = std::max<size_t>(10, options.ops / 100000);
+    LatencyRecorder rec(runs);
+    for (size_t i = 0; i < runs; ++i) {
+        rec.start();
+        writer.capture(core, i);
+        rec.stop();
+        writer.wait();
+    }
+    rec.report("snapshot.writer", depth);
+    std::filesystem::remove(path);
+}
+
+struct Benchmark {
+    const char *name;
+    void (*run)(size_t depth, const Options &options);
+};
+
+constexpr Benchmark BENCHMARKS[] = {
+    {"matching.addOrder", benchMatchingAddOrder},
+    {"matching.cancelOrder", benchMatchingCancelOrder},
+    {"matching.match", benchMatchingMatch},
+    {"matching.reduceOrderQty", benchMatchingReduceOrderQty},
+    {"risk.checkOrder", benchRiskCheckOrder},
+    {"risk.onOrderAccepted", benchRiskOnOrderAccepted},
+    {"risk.onOrderCanceled", benchRiskOnOrderCanceled},
+    {"risk.onOrderExecuted", benchRiskOnOrderExecuted},
+    {"system.exchange.handleOrder.rest", benchExchangeRest},
+    {"system.exchange.handleOrder.match", benchExchangeMatch},
+    {"system.pre_exchange.handleOrder.rest", benchPreExchangeRest},
+    {"system.pre_exchange.handleOrder.match", benchPreExchangeMatch},
+    {"system.exchange.flow", benchExchangeFlow},
+    {"snapshot.capture", benchSnapshotCapture},
+    {"snapshot.writer", benchSnapshotWriter},
+};
+
+bool parseDepths(std::string_view list, std::vector<size_t> &depths) {
+    depths.clear();
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        size_t depth = 0;
+        auto [end, ec] =
+            std::from_chars(item.data(), item.data() + item.size(), depth);
+        if (ec != std::errc() || end != item.data() + item.size() ||
+            depth == 0) {
+            return false;
+        }
+        depths.push_back(depth);
+        list = comma == std::string_view::npos ? std::string_view()
+                                               : list.substr(comma + 1);
+    }
+    return !depths.empty();
+}
+
+// steady_clock 一次读数的开销，计入每次测得的延迟
+uint64_t clockOverheadNs() {
+    constexpr int N = 100000;
+    auto start = Clock::now();
+    for (int i = 0; i < N; ++i) {
+        (void)Clock::now();
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  Clock::now() - start)
+                  .count();
+    return static_cast<uint64_t>(ns / N);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    bool ok = true;
+    for (int i = 1; i < argc && ok; i++) {
+        if (std::strcmp(argv[i], "--depths") == 0 && i + 1 < argc) {
+            ok = parseDepths(argv[++i], options.depths);
+        } else if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            options.ops = std::strtoull(argv[++i], nullptr, 10);
+            ok = options.ops > 0;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok) {
+        std::fprintf(stderr,
+                     "usage: %s [--depths 10,1000,...] [--ops N] "
+                     "[--filter name]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::printf("# clock overhead ~%llu ns per reading, included in latencies\n",
+                static_cast<unsigned long long>(clockOverheadNs()));
+    std::printf("%-38s %8s %9s %10s %7s %7s %7s %8s %9s\n", "benchmark",
+                "depth", "ops", "Mops/s", "p50", "p90", "p99", "p99.9",
+                "max(ns)");
+    for (const Benchmark &benchmark : BENCHMARKS) {
+        if (!selected(options, benchmark.name)) {
+            continue;
+        }
+        for (size_t depth : options.depths) {
+            benchmark.run(depth, options);
+        }
+    }
+    return 0;
+}
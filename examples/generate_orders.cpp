@@ -0,0 +1,133 @@
+#include "buffered_writer.h"
+#include "json_writer.h"
+#include "order_flow.h"
+#include "wire_protocol.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <unistd.h>
+
+// generate_orders.cpp 用 OrderFlowGenerator 生成合成订单流，
+// 输出可直接交给 replay 回放。相同参数和种子输出逐字节相同
+// （Zipf 权重依赖平台数学库，跨平台时见 order_flow.h）。
+//
+// 用法: generate_orders [output] [--messages N] [--seed S]
+//                       [--securities N] [--zipf S] [--shareholders N]
+//                       [--cancel-ratio R] [--aggressiveness R]
+//                       [--odd-lot-sells R] [--self-cross R]
+//                       [--format jsonl|wire]
+//   output 缺省为标准输出；wire 格式为 wire_protocol.h 定义的二进制消息首尾相接。
+
+namespace {
+
+void usage(const char *argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [output] [--messages N] [--seed S] "
+                 "[--securities N] [--zipf S] [--shareholders N] "
+                 "[--cancel-ratio R] [--aggressiveness R] "
+                 "[--odd-lot-sells R] [--self-cross R] "
+                 "[--format jsonl|wire]\n",
+                 argv0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    hdf::OrderFlowConfig config;
+    uint64_t messages = 1'000'000;
+    bool wire = false;
+    const char *outputPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--messages" && hasValue) {
+            messages = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--securities" && hasValue) {
+            config.securities = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--zipf" && hasValue) {
+            config.zipfExponent = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--shareholders" && hasValue) {
+            config.shareholders = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--cancel-ratio" && hasValue) {
+            config.cancelRatio = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--aggressiveness" && hasValue) {
+            config.aggressiveness = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--odd-lot-sells" && hasValue) {
+            config.oddLotSellRatio = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--self-cross" && hasValue) {
+            config.selfCrossRatio = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--format" && hasValue) {
+            std::string_view format = argv[++i];
+            if (format != "jsonl" && format != "wire") {
+                usage(argv[0]);
+                return 2;
+            }
+            wire = format == "wire";
+        } else if (!outputPath && !arg.starts_with("--")) {
+            outputPath = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (config.securities > hdf::OrderFlowConfig::MAX_SECURITIES ||
+        config.shareholders > hdf::OrderFlowConfig::MAX_SHAREHOLDERS) {
+        std::fprintf(stderr, "--securities must be at most %zu, "
+                             "--shareholders at most %zu\n",
+                     hdf::OrderFlowConfig::MAX_SECURITIES,
+                     hdf::OrderFlowConfig::MAX_SHAREHOLDERS);
+        return 2;
+    }
+
+    int outputFd = STDOUT_FILENO;
+    if (outputPath) {
+        outputFd = ::open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (outputFd < 0) {
+            std::perror(outputPath);
+            return 1;
+        }
+    }
+
+    hdf::OrderFlowGenerator generator(config);
+    uint64_t orders = 0;
+    uint64_t cancels = 0;
+    {
+        hdf::BufferedWriter out(outputFd);
+        for (uint64_t n = 0; n < messages; n++) {
+            const auto &message = generator.next();
+            bool isOrder =
+                message.kind == hdf::OrderFlowGenerator::Message::Kind::ORDER;
+            if (isOrder) {
+                orders++;
+            } else {
+                cancels++;
+            }
+            if (!wire) {
+                if (isOrder) {
+                    hdf::writeJsonLine(out, message.order);
+                } else {
+                    hdf::writeJsonLine(out, message.cancel);
+                }
+                continue;
+            }
+            auto *p = reinterpret_cast<uint8_t *>(
+                out.reserve(hdf::wire::MAX_MESSAGE_SIZE));
+            out.commit(isOrder ? hdf::wire::encode(message.order, p)
+                               : hdf::wire::encode(message.cancel, p));
+        }
+    }
+    if (outputPath) {
+        ::close(outputFd);
+    }
+
+    std::fprintf(stderr, "generated %llu messages (%llu orders, %llu cancels)\n",
+                 static_cast<unsigned long long>(orders + cancels),
+                 static_cast<unsigned long long>(orders),
+                 static_cast<unsigned long long>(cancels));
+    return 0;
+}
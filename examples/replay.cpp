@@ -0,0 +1,227 @@
+#include "buffered_writer.h"
+#include "json_writer.h"
+#include "trade_system.h"
+#include "wire_protocol.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// replay.cpp 把 JSONL 文件中的订单、撤单和行情逐行送入交易系统，
+// 回报经缓冲写入输出文件，结束时打印吞吐量。
+//
+// 用法: replay <input> [output.jsonl] [--exchange exchange.jsonl] [--wire]
+//   output 缺省为标准输出；
+//   指定 --exchange 时系统以交易所前置模式运行，发往交易所的指令写入该文件；
+//   指定 --wire 时输入为首尾相接的二进制协议消息（generate_orders --format
+//   wire 的输出），按消息头分帧后交给 handleWire。
+// 以 HDF_LATENCY_STATS 构建时，结束时另外打印各阶段的耗时分位数。
+
+namespace {
+
+// 按行内出现的字段判断消息类型，不解析整行
+enum class LineKind { ORDER, CANCEL, MARKET_DATA };
+
+LineKind classify(std::string_view line) {
+    if (line.find("\"origClOrderId\"") != std::string_view::npos) {
+        return LineKind::CANCEL;
+    }
+    if (line.find("\"bidPrice\"") != std::string_view::npos ||
+        line.find("\"askPrice\"") != std::string_view::npos) {
+        return LineKind::MARKET_DATA;
+    }
+    return LineKind::ORDER;
+}
+
+int openOutput(const char *path) {
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::perror(path);
+    }
+    return fd;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const char *inputPath = nullptr;
+    const char *outputPath = nullptr;
+    const char *exchangePath = nullptr;
+    bool wireInput = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--exchange") == 0 && i + 1 < argc) {
+            exchangePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--wire") == 0) {
+            wireInput = true;
+        } else if (!inputPath) {
+            inputPath = argv[i];
+        } else if (!outputPath) {
+            outputPath = argv[i];
+        } else {
+            inputPath = nullptr;
+            break;
+        }
+    }
+    if (!inputPath) {
+        std::fprintf(stderr,
+                     "usage: %s <input> [output.jsonl] "
+                     "[--exchange exchange.jsonl] [--wire]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    int inputFd = ::open(inputPath, O_RDONLY);
+    if (inputFd < 0) {
+        std::perror(inputPath);
+        return 1;
+    }
+    struct stat st;
+    if (::fstat(inputFd, &st) != 0) {
+        std::perror(inputPath);
+        return 1;
+    }
+    size_t inputSize = static_cast<size_t>(st.st_size);
+    const char *data = "";
+    if (inputSize > 0) {
+        void *mapped =
+            ::mmap(nullptr, inputSize, PROT_READ, MAP_PRIVATE, inputFd, 0);
+        if (mapped == MAP_FAILED) {
+            std::perror("mmap");
+            return 1;
+        }
+        ::madvise(mapped, inputSize, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapped);
+    }
+
+    int outputFd = outputPath ? openOutput(outputPath) : STDOUT_FILENO;
+    int exchangeFd = exchangePath ? openOutput(exchangePath) : -1;
+    if (outputFd < 0 || (exchangePath && exchangeFd < 0)) {
+        return 1;
+    }
+
+    uint64_t orders = 0;
+    uint64_t cancels = 0;
+    uint64_t marketData = 0;
+    uint64_t responses = 0;
+    uint64_t malformed = 0;
+    std::chrono::duration<double> elapsed{};
+    {
+        hdf::BufferedWriter clientOut(outputFd);
+        hdf::JsonLineClientSink clientSink(clientOut);
+        std::unique_ptr<hdf::BufferedWriter> exchangeOut;
+        std::unique_ptr<hdf::JsonLineExchangeSink> exchangeSink;
+
+        hdf::TradeSystem system;
+        system.setClientSink(&clientSink);
+        if (exchangeFd >= 0) {
+            exchangeOut = std::make_unique<hdf::BufferedWriter>(exchangeFd);
+            exchangeSink =
+                std::make_unique<hdf::JsonLineExchangeSink>(*exchangeOut);
+            system.setExchangeSink(exchangeSink.get());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        const char *p = data;
+        const char *end = data + inputSize;
+        while (wireInput && p < end) {
+            std::span<const uint8_t> rest(
+                reinterpret_cast<const uint8_t *>(p), end - p);
+            hdf::wire::MessageHeader header;
+            size_t length = 0;
+            try {
+                length = hdf::wire::decodeHeader(rest, header);
+            } catch (const std::invalid_argument &) {
+            }
+            if (length == 0) {
+                // 消息头非法或文件末尾截断，之后的数据无法分帧
+                malformed++;
+                break;
+            }
+            p += length;
+            try {
+                system.handleWire(rest.first(length));
+            } catch (const std::invalid_argument &) {
+                malformed++;
+                continue;
+            }
+            switch (header.templateId) {
+            case hdf::wire::TemplateId::NEW_ORDER:
+                orders++;
+                break;
+            case hdf::wire::TemplateId::CANCEL_ORDER:
+                cancels++;
+                break;
+            default:
+                responses++;
+                break;
+            }
+        }
+        while (!wireInput && p < end) {
+            const char *newline =
+                static_cast<const char *>(std::memchr(p, '\n', end - p));
+            const char *lineEnd = newline ? newline : end;
+            std::string_view line(p, lineEnd - p);
+            p = lineEnd + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (line.find_first_not_of(" \t") == std::string_view::npos) {
+                continue;
+            }
+
+            switch (classify(line)) {
+            case LineKind::ORDER:
+                system.handleOrderRaw(line);
+                orders++;
+                break;
+            case LineKind::CANCEL:
+                system.handleCancelRaw(line);
+                cancels++;
+                break;
+            case LineKind::MARKET_DATA:
+                try {
+                    system.handleMarketData(nlohmann::json::parse(line));
+                    marketData++;
+                } catch (const nlohmann::json::exception &) {
+                    malformed++;
+                }
+                break;
+            }
+        }
+        clientOut.flush();
+        if (exchangeOut) {
+            exchangeOut->flush();
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        if constexpr (hdf::LATENCY_STATS_ENABLED) {
+            std::fputs(system.latencyStats().format().c_str(), stderr);
+        }
+    }
+
+    uint64_t total = orders + cancels + marketData + responses;
+    double seconds = elapsed.count();
+    std::fprintf(stderr,
+                 "replayed %llu messages (%llu orders, %llu cancels, "
+                 "%llu market data, %llu responses, %llu malformed) "
+                 "in %.3f s, %.0f msgs/s\n",
+                 static_cast<unsigned long long>(total),
+                 static_cast<unsigned long long>(orders),
+                 static_cast<unsigned long long>(cancels),
+                 static_cast<unsigned long long>(marketData),
+                 static_cast<unsigned long long>(responses),
+                 static_cast<unsigned long long>(malformed), seconds,
+                 seconds > 0 ? total / seconds : 0.0);
+
+    if (inputSize > 0) {
+        ::munmap(const_cast<char *>(data), inputSize);
+    }
+    ::close(inputFd);
+    return 0;
+}
@@ -0,0 +1,603 @@
+#pragma once
+
+#include "constants.h"
+#include "engine_config.h"
+#include "engine_metrics.h"
+#include "latency_stats.h"
+#include "matching_engine.h"
+#include "order_parser.h"
+#include "pending_match.h"
+#include "risk_controller.h"
+#include "snapshot.h"
+#include "symbol_table.h"
+#include "timer_wheel.h"
+#include "trade_sink.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 交易系统的工作模式。
+ * EXCHANGE 为纯撮合交易所，PRE_EXCHANGE 为交易所前置。
+ */
+enum class TradeMode : uint8_t { EXCHANGE, PRE_EXCHANGE };
+
+/**
+ * @brief 丢弃所有输出的 sink。
+ * 声明为 final，作为模板参数时调用可内联为空操作。
+ */
+class NullClientSink final : public ClientSink {
+  public:
+    void onOrderResponse(const OrderResponse &) override {}
+    void onCancelResponse(const CancelResponse &) override {}
+};
+
+class NullExchangeSink final : public ExchangeSink {
+  public:
+    void onOrder(const Order &) override {}
+    void onCancel(const CancelOrder &) override {}
+};
+
+/**
+ * @brief 生成格式错误的订单/撤单拒绝回报（ORDER_INVALID_FORMAT_REJECT_CODE）。
+ * 各入口（JSON、原始文本、二进制、流水线）共用。
+ */
+OrderResponse makeInvalidOrderReject(const ClOrderId &clOrderId,
+                                     std::string_view reason);
+CancelResponse makeInvalidCancelReject(const ClOrderId &clOrderId,
+                                       const ClOrderId &origClOrderId,
+                                       std::string_view reason);
+
+/**
+ * @brief 交易系统的全部状态：驻留表、风控、撮合和前置模式下的待定撮合。
+ * 与工作模式和 sink 类型无关，由 BasicTradeSystem 和 TradeSystem 共用。
+ */
+struct TradeCore {
+    TradeCore();
+    /**
+     * @brief 按配置预分配各模块的对象池和哈希表。
+     */
+    explicit TradeCore(const EngineConfig &config);
+
+    TradeCore(const TradeCore &) = delete;
+    TradeCore &operator=(const TradeCore &) = delete;
+
+    // 风控和撮合共享的驻留表，订单在入口处分配编号
+    SymbolTable symbols;
+    RiskController riskController;
+    MatchingEngine matchingEngine;
+
+    /**
+     * 前置模式下内部撮合成功后，需要先向交易所发送撤单请求，
+     * 等待交易所返回所有撤单确认后才能向客户端发送成交回报。
+     *
+     * 一个主动方订单可能匹配多个对手方订单，要等所有对手方的
+     * 撤单回报都回来后，才能确定最终成交结果：
+     * - 撤单确认的部分 → 成交生效，发成交回报
+     * - 撤单被拒的部分 → 对手方已在交易所被他人成交，该部分作废
+     * - 若有作废部分未成交的量，需重新转发给交易所
+     */
+    PendingMatchTable pendingMatches;
+
+    // 撤单回报超时，定时器数据为待定撮合的槽号
+    TimerWheel pendingTimeouts;
+    uint64_t pendingCancelTimeoutNs = 0;
+    // 调用方最近一次提供的时间
+    uint64_t nowNs = 0;
+
+    // 各阶段耗时，构建时未开启 HDF_LATENCY_STATS 则不记录
+    LatencyStats latency;
+    // 运行指标，为空时不统计
+    EngineMetrics *metrics = nullptr;
+
+    // 处理线程复用的撮合结果，稳态下撮合不再分配内存
+    MatchingEngine::MatchResult matchResult;
+    // 预先填好拒绝码和拒绝原因的对敲拒绝回报，每次只改写订单字段，
+    // 避免逐笔构造拒绝原因字符串
+    OrderResponse crossTradeReject;
+};
+
+namespace detail {
+
+// 以订单填写回报的订单字段，其余字段不变
+inline void fillOrderFields(OrderResponse &response, const Order &order,
+                            uint32_t qty) {
+    response.clOrderId = order.clOrderId;
+    response.market = order.market;
+    response.securityId = order.securityId;
+    response.side = order.side;
+    response.qty = qty;
+    response.price = order.price;
+    response.shareholderId = order.shareholderId;
+}
+
+// 订单确认回报，qty 为入簿数量
+inline OrderResponse makeConfirm(const Order &order, uint32_t qty) {
+    OrderResponse response;
+    fillOrderFields(response, order, qty);
+    response.type = OrderResponse::CONFIRM;
+    return response;
+}
+
+/**
+ * @brief 交易系统的处理逻辑，按模式和 sink 类型实例化。
+ *
+ * 模式分支全部为 if constexpr，实例化后只保留本模式的代码；
+ * sink 以具体类型调用，类型为 final 或非虚类时调用可以内联。
+ * 纯撮合模式下 exchangeSink 可为空，不会被访问。
+ */
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+struct TradeLogic {
+    static constexpr bool PRE_EXCHANGE = Mode == TradeMode::PRE_EXCHANGE;
+
+    static void handleOrder(TradeCore &core, ClientSinkT &clientSink,
+                            ExchangeSinkT *exchangeSink, const Order &input);
+    static void handleCancel(TradeCore &core, ClientSinkT &clientSink,
+                             ExchangeSinkT *exchangeSink,
+                             const CancelOrder &cancel);
+    static void handleResponse(TradeCore &core, ClientSinkT &clientSink,
+                               const OrderResponse &response);
+    static void handleResponse(TradeCore &core, ClientSinkT &clientSink,
+                               ExchangeSinkT *exchangeSink,
+                               const CancelResponse &response);
+
+    /**
+     * @brief 推进时间，前置模式下结算撤单回报超时的内部撮合
+     */
+    static void advanceTime(TradeCore &core, ClientSinkT &clientSink,
+                            ExchangeSinkT *exchangeSink, uint64_t nowNs);
+
+    /**
+     * @brief 所有撤单回报都回来（或超时）后，处理最终结果
+     */
+    static void resolvePendingMatch(TradeCore &core, ClientSinkT &clientSink,
+                                    ExchangeSinkT *exchangeSink,
+                                    uint32_t slot);
+    /**
+     * @brief 向客户端发送一笔成交的被动方和主动方两条成交回报
+     */
+    static void sendExecution(ClientSinkT &clientSink,
+                              const OrderResponse &exec,
+                              const Order &activeOrder);
+};
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::handleOrder(
+    TradeCore &core, ClientSinkT &clientSink, ExchangeSinkT *exchangeSink,
+    const Order &input) {
+    LatencyTimer timer(core.latency, LatencyMessage::ORDER);
+    if (core.metrics) {
+        core.metrics->count(MetricCounter::ORDERS);
+    }
+    // 类型化订单不经过解析器，在此补做取值校验：
+    // 非整数价位会被档位换算截断，零数量订单会产生零数量成交
+    if (const char *error = validateOrder(input)) {
+        if (core.metrics) {
+            core.metrics->countReject(ORDER_INVALID_FORMAT_REJECT_CODE);
+        }
+        clientSink.onOrderResponse(
+            makeInvalidOrderReject(input.clOrderId, error));
+        return;
+    }
+
+    Order order = input;
+    core.symbols.intern(order);
+
+    // 价格离本边挂单太远，订单簿无法容纳，直接拒绝
+    if (!core.matchingEngine.canRest(order)) {
+        OrderResponse response = makeConfirm(order, order.qty);
+        response.rejectCode = ORDER_PRICE_OUT_OF_RANGE_REJECT_CODE;
+        response.rejectText = ORDER_PRICE_OUT_OF_RANGE_REJECT_REASON;
+        response.type = OrderResponse::REJECT;
+        if (core.metrics) {
+            core.metrics->countReject(response.rejectCode);
+        }
+        clientSink.onOrderResponse(response);
+        return;
+    }
+
+    // 风控
+    auto riskResult = core.riskController.checkOrder(order);
+    timer.lap(LatencyStage::RISK_CHECK);
+
+    if (riskResult == RiskController::RiskCheckResult::CROSS_TRADE) {
+        // 检测到对敲，生成对敲非法回报，并传给客户端
+        OrderResponse &response = core.crossTradeReject;
+        fillOrderFields(response, order, order.qty);
+        if (core.metrics) {
+            core.metrics->countReject(response.rejectCode);
+        }
+        clientSink.onOrderResponse(response);
+        timer.lap(LatencyStage::RESPONSE);
+        return;
+    }
+
+    // 尝试撮合交易
+    auto &matchResult = core.matchResult;
+    bool matched = core.matchingEngine.match(order, matchResult);
+    timer.lap(LatencyStage::MATCH);
+    if (!matched) {
+        // 没有匹配成功：订单入簿（前置模式下供后续内部撮合）；
+        // 前置模式转发给交易所，纯撮合模式生成确认回报。
+        core.matchingEngine.addOrder(order);
+        // 更新风控系统订单状态
+        core.riskController.onOrderAccepted(order);
+        timer.lap(LatencyStage::ADD_ORDER);
+        if constexpr (PRE_EXCHANGE) {
+            exchangeSink->onOrder(order);
+        } else {
+            clientSink.onOrderResponse(makeConfirm(order, order.qty));
+        }
+        timer.lap(LatencyStage::RESPONSE);
+        return;
+    }
+
+    auto &executions = matchResult.executions;
+    if constexpr (PRE_EXCHANGE) {
+        // 交易所前置模式：对手方订单之前已转发给交易所，
+        // 需要先向交易所发送撤单请求，等待所有撤单确认后才发成交回报。
+        uint32_t slot = core.pendingMatches.acquire(
+            order, executions, matchResult.remainingQty);
+        if (core.metrics) {
+            // 只用于监控，没有设置指标时不读时钟
+            core.pendingMatches.at(slot).acquiredNs = EngineMetrics::clockNs();
+        }
+        if (core.pendingCancelTimeoutNs > 0) {
+            core.pendingMatches.at(slot).timer = core.pendingTimeouts.schedule(
+                core.nowNs + core.pendingCancelTimeoutNs, slot);
+        }
+
+        for (size_t i = 0; i < executions.size(); i++) {
+            const auto &exec = executions[i];
+            // 向交易所发送撤单请求，撤单编号指向本次撮合的槽位
+            CancelOrder cancelRequest;
+            cancelRequest.clOrderId = core.pendingMatches.cancelId(slot, i);
+            cancelRequest.origClOrderId = exec.clOrderId;
+            cancelRequest.market = exec.market;
+            cancelRequest.securityId = exec.securityId;
+            cancelRequest.shareholderId = exec.shareholderId;
+            cancelRequest.side = exec.side;
+            exchangeSink->onCancel(cancelRequest);
+        }
+        timer.lap(LatencyStage::RESPONSE);
+    } else {
+        // 纯撮合模式：无需等待，直接发送成交回报
+        uint32_t totalExecQty = 0;
+        for (const auto &exec : executions) {
+            // 更新对手方（被动方）风控状态
+            core.riskController.onOrderExecuted(exec.clOrderId, exec.execQty);
+            totalExecQty += exec.execQty;
+            sendExecution(clientSink, exec, order);
+        }
+        // 更新主动方风控状态
+        core.riskController.onOrderExecuted(order.clOrderId, totalExecQty);
+        timer.lap(LatencyStage::RESPONSE);
+
+        // 部分成交：剩余数量需要显式入簿，并生成确认回报
+        if (matchResult.remainingQty > 0) {
+            Order remainingOrder = order;
+            remainingOrder.qty = matchResult.remainingQty;
+            core.matchingEngine.addOrder(remainingOrder);
+            timer.lap(LatencyStage::ADD_ORDER);
+            clientSink.onOrderResponse(
+                makeConfirm(order, matchResult.remainingQty));
+            timer.lap(LatencyStage::RESPONSE);
+        }
+    }
+}
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::handleCancel(
+    TradeCore &core, ClientSinkT &clientSink, ExchangeSinkT *exchangeSink,
+    const CancelOrder &cancel) {
+    LatencyTimer timer(core.latency, LatencyMessage::CANCEL);
+    if (core.metrics) {
+        core.metrics->count(MetricCounter::CANCELS);
+    }
+    if constexpr (PRE_EXCHANGE) {
+        // 系统是交易所前置，转发给交易所
+        exchangeSink->onCancel(cancel);
+        timer.lap(LatencyStage::RESPONSE);
+    } else {
+        // 更新撮合引擎订单状态
+        CancelResponse result =
+            core.matchingEngine.cancelOrder(cancel.origClOrderId);
+        result.clOrderId = cancel.clOrderId;
+        if (result.type != CancelResponse::REJECT) {
+            // 更新风控系统订单状态
+            core.riskController.onOrderCanceled(cancel.origClOrderId);
+        } else if (core.metrics) {
+            core.metrics->countReject(result.rejectCode);
+        }
+        timer.lap(LatencyStage::CANCEL);
+        // 撤单确认，或原订单不在簿中（已成交或不存在）时的撤单拒绝
+        clientSink.onCancelResponse(result);
+        timer.lap(LatencyStage::RESPONSE);
+    }
+}
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::handleResponse(
+    TradeCore &core, ClientSinkT &clientSink, const OrderResponse &response) {
+    LatencyTimer timer(core.latency, LatencyMessage::ORDER_RESPONSE);
+    if (core.metrics) {
+        core.metrics->count(MetricCounter::ORDER_RESPONSES);
+    }
+    // 确认、拒绝和成交回报都直接转发给客户端
+    clientSink.onOrderResponse(response);
+    timer.lap(LatencyStage::RESPONSE);
+    if (response.type == OrderResponse::EXECUTION) {
+        // 交易所主动成交了订单，需要从内部订单簿中减少对应订单数量
+        // 同时更新风控状态
+        core.matchingEngine.reduceOrderQty(response.clOrderId,
+                                           response.execQty);
+        core.riskController.onOrderExecuted(response.clOrderId,
+                                            response.execQty);
+        timer.lap(LatencyStage::CANCEL);
+    }
+}
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::handleResponse(
+    TradeCore &core, ClientSinkT &clientSink, ExchangeSinkT *exchangeSink,
+    const CancelResponse &response) {
+    LatencyTimer timer(core.latency, LatencyMessage::CANCEL_RESPONSE);
+    if (core.metrics) {
+        core.metrics->count(MetricCounter::CANCEL_RESPONSES);
+    }
+    if constexpr (PRE_EXCHANGE) {
+        // 检查是否是内部撮合触发的撤单回报
+        uint32_t slot;
+        switch (core.pendingMatches.answer(
+            response.clOrderId, response.type != CancelResponse::REJECT,
+            slot)) {
+        case PendingMatchTable::Answer::NOT_OURS:
+            break;
+        case PendingMatchTable::Answer::STALE:
+            // 重复的回报，撮合已结算
+            return;
+        case PendingMatchTable::Answer::LATE: {
+            // 超时时按被拒结算，即认为对手方已在交易所成交；被拒的回报与之一致
+            if (response.type == CancelResponse::REJECT) {
+                return;
+            }
+            // 交易所其实撤掉了对手方订单，之后不会再有它的成交回报：
+            // 从内部簿和风控中移除，并把撤单确认转发给订单所有者
+            CancelResponse late = response;
+            late.origClOrderId = core.pendingMatches.expiredOrder(slot);
+            core.matchingEngine.cancelOrder(late.origClOrderId);
+            core.riskController.onOrderCanceled(late.origClOrderId);
+            clientSink.onCancelResponse(late);
+            timer.lap(LatencyStage::RESPONSE);
+            return;
+        }
+        case PendingMatchTable::Answer::PENDING:
+            return;
+        case PendingMatchTable::Answer::COMPLETE:
+            // 所有撤单回报都回来了，处理最终结果
+            resolvePendingMatch(core, clientSink, exchangeSink, slot);
+            return;
+        }
+    }
+    // 普通撤单回报（用户主动撤单的确认），直接转发
+    clientSink.onCancelResponse(response);
+    timer.lap(LatencyStage::RESPONSE);
+    // TODO: 更新风控状态
+    // core.riskController.onOrderCanceled(response.origClOrderId);
+}
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::advanceTime(
+    TradeCore &core, ClientSinkT &clientSink, ExchangeSinkT *exchangeSink,
+    uint64_t nowNs) {
+    core.nowNs = nowNs;
+    if constexpr (PRE_EXCHANGE) {
+        core.pendingTimeouts.advance(nowNs, [&](uint64_t data) {
+            // 超时未回的撤单按被拒处理：对手方视为已在交易所成交
+            uint32_t slot = static_cast<uint32_t>(data);
+            core.pendingMatches.at(slot).timer = 0;
+            core.pendingMatches.expire(slot);
+            resolvePendingMatch(core, clientSink, exchangeSink, slot);
+        });
+    }
+}
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::sendExecution(
+    ClientSinkT &clientSink, const OrderResponse &exec,
+    const Order &activeOrder) {
+    // 对手方（被动方）成交回报
+    clientSink.onOrderResponse(exec);
+
+    // 主动方（taker）成交回报，成交信息与被动方相同
+    OrderResponse activeResponse = exec;
+    activeResponse.clOrderId = activeOrder.clOrderId;
+    activeResponse.market = activeOrder.market;
+    activeResponse.securityId = activeOrder.securityId;
+    activeResponse.side = activeOrder.side;
+    activeResponse.qty = activeOrder.qty;
+    activeResponse.price = activeOrder.price;
+    activeResponse.shareholderId = activeOrder.shareholderId;
+    clientSink.onOrderResponse(activeResponse);
+}
+
+template <TradeMode Mode, typename ClientSinkT, typename ExchangeSinkT>
+void TradeLogic<Mode, ClientSinkT, ExchangeSinkT>::resolvePendingMatch(
+    TradeCore &core, ClientSinkT &clientSink, ExchangeSinkT *exchangeSink,
+    uint32_t slot) {
+    auto &pending = core.pendingMatches.at(slot);
+    if (pending.timer != 0) {
+        core.pendingTimeouts.cancel(pending.timer);
+    }
+
+    uint32_t rejectedQty = 0;
+
+    // 对于撤单确认的部分，发送成交回报
+    for (size_t i = 0; i < pending.executions.size(); i++) {
+        const auto &exec = pending.executions[i];
+        if (pending.isConfirmed(i)) {
+            // 撤单确认 → 成交生效
+            core.riskController.onOrderExecuted(exec.clOrderId, exec.execQty);
+            sendExecution(clientSink, exec, pending.activeOrder);
+        } else {
+            // 撤单被拒 → 该部分作废，累计未成交量
+            rejectedQty += exec.execQty;
+        }
+    }
+
+    // 若有作废部分或撮合时的剩余量，将未成交的量转发给交易所并入内部簿
+    uint32_t totalUnfilledQty = rejectedQty + pending.remainingQty;
+    if (totalUnfilledQty > 0) {
+        Order remainingOrder = pending.activeOrder;
+        remainingOrder.qty = totalUnfilledQty;
+        // 入内部簿，供后续内部撮合
+        core.matchingEngine.addOrder(remainingOrder);
+        // 主动方此前未登记到风控，只登记未成交的部分；
+        // 已成交的部分不再参与对敲检测
+        core.riskController.onOrderAccepted(remainingOrder);
+        // TODO: 可能需要生成新的 clOrderId
+        exchangeSink->onOrder(remainingOrder);
+    }
+
+    core.pendingMatches.release(slot);
+}
+
+// TradeSystem 使用的类型擦除实例在 trade_system.cpp 中显式实例化
+extern template struct TradeLogic<TradeMode::EXCHANGE, ClientSink,
+                                  ExchangeSink>;
+extern template struct TradeLogic<TradeMode::PRE_EXCHANGE, ClientSink,
+                                  ExchangeSink>;
+
+} // namespace detail
+
+/**
+ * @brief 编译期确定工作模式和 sink 类型的交易系统。
+ *
+ * 与 TradeSystem 行为相同，但不在每条消息上判断是否设置了交易所接口，
+ * 另一模式的分支在编译期消除；sink 以具体类型直接调用，不经过
+ * std::function，sink 类型为 final 或非虚类时可以完全内联。
+ * ClientSinkT 须提供 onOrderResponse/onCancelResponse，
+ * ExchangeSinkT 须提供 onOrder/onCancel，签名同 ClientSink/ExchangeSink。
+ *
+ * sink 不转移所有权，须在系统析构前保持有效。
+ *
+ *   MySink sink;
+ *   BasicTradeSystem<TradeMode::EXCHANGE, MySink> system(sink);
+ */
+template <TradeMode Mode, typename ClientSinkT,
+          typename ExchangeSinkT = NullExchangeSink>
+class BasicTradeSystem {
+    using Logic = detail::TradeLogic<Mode, ClientSinkT, ExchangeSinkT>;
+
+  public:
+    static constexpr TradeMode MODE = Mode;
+
+    /**
+     * @brief 构造纯撮合系统，不需要交易所接口。
+     */
+    explicit BasicTradeSystem(ClientSinkT &clientSink,
+                              const EngineConfig &config = {})
+        requires(Mode == TradeMode::EXCHANGE)
+        : core_(config), clientSink_(clientSink), exchangeSink_(nullptr) {}
+
+    BasicTradeSystem(ClientSinkT &clientSink, ExchangeSinkT &exchangeSink,
+                     const EngineConfig &config = {})
+        : core_(config), clientSink_(clientSink),
+          exchangeSink_(&exchangeSink) {}
+
+    /**
+     * @brief 处理来自客户端的订单指令
+     */
+    void handleOrder(const Order &order) {
+        Logic::handleOrder(core_, clientSink_, exchangeSink_, order);
+    }
+    /**
+     * @brief 直接从 JSON 文本处理订单指令，规则同 TradeSystem::handleOrderRaw。
+     */
+    void handleOrderRaw(std::string_view input) {
+        uint64_t start = latency::now();
+        Order order;
+        const char *error = parseOrder(input, order);
+        core_.latency.record(LatencyMessage::ORDER, LatencyStage::PARSE,
+                             latency::now() - start);
+        if (error) {
+            if (core_.metrics) {
+                core_.metrics->countReject(ORDER_INVALID_FORMAT_REJECT_CODE);
+            }
+            clientSink_.onOrderResponse(makeInvalidOrderReject(
+                findIdField(input, "clOrderId"), error));
+            return;
+        }
+        handleOrder(order);
+    }
+    /**
+     * @brief 处理来自客户端的撤单指令
+     */
+    void handleCancel(const CancelOrder &cancel) {
+        Logic::handleCancel(core_, clientSink_, exchangeSink_, cancel);
+    }
+    void handleCancelRaw(std::string_view input) {
+        uint64_t start = latency::now();
+        CancelOrder cancel;
+        const char *error = parseCancelOrder(input, cancel);
+        core_.latency.record(LatencyMessage::CANCEL, LatencyStage::PARSE,
+                             latency::now() - start);
+        if (error) {
+            if (core_.metrics) {
+                core_.metrics->countReject(ORDER_INVALID_FORMAT_REJECT_CODE);
+            }
+            clientSink_.onCancelResponse(makeInvalidCancelReject(
+                findIdField(input, "clOrderId"),
+                findIdField(input, "origClOrderId"), error));
+            return;
+        }
+        handleCancel(cancel);
+    }
+    /**
+     * @brief 处理来自交易所的回报
+     */
+    void handleResponse(const OrderResponse &response) {
+        Logic::handleResponse(core_, clientSink_, response);
+    }
+    void handleResponse(const CancelResponse &response) {
+        Logic::handleResponse(core_, clientSink_, exchangeSink_, response);
+    }
+    /**
+     * @brief 推进时间，规则同 TradeSystem::advanceTime。
+     */
+    void advanceTime(uint64_t nowNs) {
+        Logic::advanceTime(core_, clientSink_, exchangeSink_, nowNs);
+    }
+    /**
+     * @brief 快照，规则同 TradeSystem::takeSnapshot/restoreSnapshot。
+     */
+    bool takeSnapshot(SnapshotWriter &writer, uint64_t journalSequence = 0) {
+        return writer.capture(core_, journalSequence);
+    }
+    uint64_t restoreSnapshot(const SnapshotReader &reader) {
+        reader.restore(core_);
+        return reader.journalSequence();
+    }
+    /**
+     * @brief 各阶段耗时统计，规则同 TradeSystem::latencyStats。
+     */
+    LatencyStats &latencyStats() { return core_.latency; }
+    /**
+     * @brief 运行指标，规则同 TradeSystem::setMetrics/publishMetrics。
+     */
+    void setMetrics(EngineMetrics *metrics) { core_.metrics = metrics; }
+    void publishMetrics() {
+        if (core_.metrics) {
+            core_.metrics->publish(core_);
+        }
+    }
+
+  private:
+    TradeCore core_;
+    ClientSinkT &clientSink_;
+    ExchangeSinkT *exchangeSink_;
+};
+
+} // namespace hdf
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+
+namespace hdf {
+
+/**
+ * @brief 带大缓冲区的文件描述符写入器。
+ *
+ * 输出先追加到内存缓冲区，缓冲区写满或显式 flush 时才调用一次 write(2)，
+ * 避免逐行刷新带来的系统调用开销。析构时自动 flush。
+ * 不持有文件描述符，不负责关闭。非线程安全。
+ */
+class BufferedWriter {
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufferedWriter(int fd, size_t capacity = DEFAULT_CAPACITY)
+        : fd_(fd), capacity_(capacity),
+          buffer_(std::make_unique<char[]>(capacity)) {}
+
+    ~BufferedWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    /**
+     * @brief 返回至少 n 字节的可写空间，写入后须调用 commit。
+     * n 不能超过缓冲区容量。
+     */
+    char *reserve(size_t n) {
+        if (capacity_ - size_ < n) {
+            flush();
+        }
+        return buffer_.get() + size_;
+    }
+
+    void commit(size_t n) { size_ += n; }
+
+    void write(std::string_view s) {
+        if (s.size() > capacity_ - size_) {
+            flush();
+            if (s.size() > capacity_) {
+                writeAll(s.data(), s.size());
+                return;
+            }
+        }
+        std::memcpy(buffer_.get() + size_, s.data(), s.size());
+        size_ += s.size();
+    }
+
+    void put(char c) {
+        if (size_ == capacity_) {
+            flush();
+        }
+        buffer_[size_++] = c;
+    }
+
+    /**
+     * @brief 将缓冲区内容全部写出。
+     * @throws std::system_error 写入失败
+     */
+    void flush() {
+        if (size_ > 0) {
+            size_t n = size_;
+            size_ = 0;
+            writeAll(buffer_.get(), n);
+        }
+    }
+
+    size_t bytesWritten() const { return bytesWritten_ + size_; }
+
+  private:
+    int fd_;
+    size_t capacity_;
+    std::unique_ptr<char[]> buffer_;
+    size_t size_ = 0;
+    size_t bytesWritten_ = 0;
+
+    void writeAll(const char *data, size_t n) {
+        while (n > 0) {
+            ssize_t written = ::write(fd_, data, n);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(),
+                                        "BufferedWriter");
+            }
+            data += written;
+            n -= static_cast<size_t>(written);
+            bytesWritten_ += static_cast<size_t>(written);
+        }
+    }
+};
+
+} // namespace hdf
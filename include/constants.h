@@ -10,4 +10,11 @@ const std::string ORDER_CROSS_TRADE_REJECT_REASON = "Cross trade detected";
 const int32_t ORDER_INVALID_FORMAT_REJECT_CODE = 0x02;
 const std::string ORDER_INVALID_FORMAT_REJECT_REASON = "Invalid order format";
 
+const int32_t CANCEL_ORDER_NOT_FOUND_REJECT_CODE = 0x03;
+const std::string CANCEL_ORDER_NOT_FOUND_REJECT_REASON = "Order not found";
+
+// 订单价格距本边已有挂单太远，超出订单簿的价格档位范围（MatchingEngine::canRest）
+const int32_t ORDER_PRICE_OUT_OF_RANGE_REJECT_CODE = 0x04;
+const std::string ORDER_PRICE_OUT_OF_RANGE_REJECT_REASON = "Price out of range";
+
 } // namespace hdf
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hdf {
+
+/**
+ * @brief 引擎启动配置。
+ *
+ * 用于在启动时按预计规模预分配对象池和哈希表，
+ * 避免开盘高峰期间频繁向系统申请内存和触发缺页。
+ * 全部为0时不做预分配，行为与默认构造相同。
+ */
+struct EngineConfig {
+    size_t expectedOrders = 0;         // 预计同时存活的订单数（簿内挂单）
+    size_t expectedPendingMatches = 0; // 前置模式下预计同时等待撤单回报的撮合数
+    bool hugePages = false;            // 对象池是否使用大页内存
+
+    // 前置模式下等待交易所撤单回报的时限，超时未回的撤单按被拒处理；0 表示不超时。
+    // 时间由调用方通过 advanceTime 提供
+    uint64_t pendingCancelTimeoutNs = 0;
+    uint64_t timerTickNs = 1'000'000; // 定时器刻度
+
+    // 分片模式下本实例的分片号和分片总数，用于生成不重复的成交编号
+    uint32_t shardIndex = 0;
+    uint32_t shardCount = 1;
+};
+
+} // namespace hdf
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "spsc_ring.h"
+#include "trade_sink.h"
+#include "trade_system.h"
+#include <cstdint>
+#include <variant>
+
+namespace hdf {
+
+/**
+ * @brief 多线程模式下送入核心线程的消息。
+ * 格式错误的拒绝回报也经入站队列转发，保证与其他回报的先后顺序不变。
+ */
+struct InboundMessage {
+    enum Kind : uint8_t {
+        ORDER,           // 客户端订单
+        CANCEL,          // 客户端撤单
+        ORDER_RESPONSE,  // 交易所订单回报
+        CANCEL_RESPONSE, // 交易所撤单回报
+        ORDER_REJECT,    // 入口格式校验失败，直接转发给客户端
+        CANCEL_REJECT,
+    } kind = ORDER;
+    std::variant<Order, CancelOrder, OrderResponse, CancelResponse> payload;
+};
+
+/**
+ * @brief 核心线程产生的输出。
+ * std::monostate 是分片模式下的结束标记，表示一条入站消息的输出已全部给出。
+ */
+struct OutboundMessage {
+    std::variant<std::monostate, OrderResponse, CancelResponse, Order,
+                 CancelOrder>
+        payload;
+};
+
+/**
+ * @brief 核心线程上的 sink，把 TradeSystem 的输出放入出站队列。
+ */
+class RingEgressSink : public ClientSink, public ExchangeSink {
+  public:
+    explicit RingEgressSink(SpscRing<OutboundMessage> &ring) : ring_(ring) {}
+
+    void onOrderResponse(const OrderResponse &response) override;
+    void onCancelResponse(const CancelResponse &response) override;
+    void onOrder(const Order &order) override;
+    void onCancel(const CancelOrder &cancel) override;
+
+  private:
+    SpscRing<OutboundMessage> &ring_;
+};
+
+/**
+ * @brief 核心线程驱动 TradeSystem::advanceTime 使用的时钟（steady_clock，纳秒）。
+ */
+uint64_t steadyNowNs();
+
+/**
+ * @brief 交给 system 处理一条入站消息；格式错误的拒绝回报直接交给 rejectSink。
+ */
+void dispatchInbound(TradeSystem &system, ClientSink &rejectSink,
+                     InboundMessage &message);
+
+/**
+ * @brief 把一条出站消息交给对应的 sink，结束标记被忽略。
+ */
+void deliverOutbound(OutboundMessage &message, ClientSink &clientSink,
+                     ExchangeSink *exchangeSink);
+
+} // namespace hdf
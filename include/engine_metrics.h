@@ -0,0 +1,169 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hdf {
+
+struct TradeCore;
+
+/**
+ * @brief 处理线程逐条累加的计数。
+ */
+enum class MetricCounter : uint8_t {
+    ORDERS,           // 进入处理逻辑的订单
+    CANCELS,          // 进入处理逻辑的撤单
+    ORDER_RESPONSES,  // 交易所的订单回报
+    CANCEL_RESPONSES, // 交易所的撤单回报
+    COUNT
+};
+
+/**
+ * @brief 由 EngineMetrics::publish 采样的状态量。
+ */
+enum class MetricGauge : uint8_t {
+    RESTING_ORDERS,          // 撮合引擎中的挂单笔数
+    RISK_ORDERS,             // 风控中的活跃订单数
+    RISK_BUCKETS,            // 风控中有活跃订单的 (股东, 股票) 桶数
+    PENDING_MATCHES,         // 前置模式下等待撤单回报的内部撮合数
+    PENDING_CANCELS,         // 其中还未回报的撤单数
+    OLDEST_PENDING_AGE_NS,   // 最早一笔待定撮合已等待的时间（设置指标后撮合的）
+    SECURITIES,              // 驻留表中的股票数
+    SHAREHOLDERS,            // 驻留表中的股东数
+    SYMBOL_TABLE_BYTES,      // 各模块占用的内存字节数
+    RISK_BYTES,
+    MATCHING_BYTES,
+    PENDING_MATCH_BYTES,
+    COUNT
+};
+
+const char *toString(MetricCounter counter);
+const char *toString(MetricGauge gauge);
+
+/**
+ * @brief 某一时刻的指标拷贝，可在任意线程上格式化输出。
+ */
+struct MetricsSnapshot {
+    struct SecurityDepth {
+        Market market;
+        SecurityId securityId;
+        uint64_t restingOrders;
+    };
+
+    uint64_t publishedNs = 0; // 采样时间（EngineMetrics::clockNs）
+    uint64_t publishCount = 0;
+    std::array<uint64_t, static_cast<size_t>(MetricCounter::COUNT)> counters{};
+    std::array<uint64_t, static_cast<size_t>(MetricGauge::COUNT)> gauges{};
+    // 按拒绝码（constants.h）统计的拒绝回报，下标为拒绝码，0 为其他拒绝码
+    std::vector<uint64_t> rejects;
+    // 每只股票的挂单笔数，按股票编号排列，超出登记容量的股票不在其中
+    std::vector<SecurityDepth> securities;
+
+    uint64_t counter(MetricCounter c) const {
+        return counters[static_cast<size_t>(c)];
+    }
+    uint64_t gauge(MetricGauge g) const {
+        return gauges[static_cast<size_t>(g)];
+    }
+
+    /**
+     * @brief 每行一个指标，形如 `hdf_resting_orders{security="XSHG.600030"} 5`，
+     * 可直接作为 Prometheus 文本格式抓取。
+     */
+    std::string toText() const;
+    std::string toJson() const;
+};
+
+/**
+ * @brief 引擎运行指标的登记表：处理线程写，任意线程无锁读取。
+ *
+ * 计数（消息数、拒绝数）由处理逻辑逐条累加；状态量（挂单深度、
+ * 待定撮合、内存占用等）须遍历各模块，由调用方的主循环在处理线程上
+ * 两条消息之间调用 publish 采样，耗时与股票数和待定撮合槽数成正比。
+ *
+ * 所有值都是 atomic，只有处理线程写入，累加不需要加锁指令。状态量的一次
+ * 采样由版本号（seqlock）保护：读取方发现采样进行中或读取期间发生了采样
+ * 就重读，从不阻塞处理线程，读到的状态量来自同一次采样。
+ * 计数与状态量之间、各计数之间不保证是同一时刻的值。
+ *
+ * 表的大小在构造时确定，之后不再分配内存。
+ */
+class EngineMetrics {
+  public:
+    // 拒绝码的统计范围，更大的拒绝码计入下标0
+    static constexpr size_t MAX_REJECT_CODE = 15;
+
+    /**
+     * @param maxSecurities 单独统计挂单深度的股票数，按股票编号取前 maxSecurities 只
+     */
+    explicit EngineMetrics(size_t maxSecurities = 4096);
+    ~EngineMetrics();
+
+    EngineMetrics(const EngineMetrics &) = delete;
+    EngineMetrics &operator=(const EngineMetrics &) = delete;
+
+    /**
+     * @brief 指标使用的时钟：单调时钟（steady_clock）的纳秒数。
+     * 与 TradeCore::nowNs 无关，不需要调用方驱动 advanceTime；
+     * 不随系统时间调整而倒退，但只在同一进程内可比。
+     */
+    static uint64_t clockNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // 以下在处理线程上调用
+
+    void count(MetricCounter counter) {
+        increment(counters_[static_cast<size_t>(counter)]);
+    }
+    void countReject(int32_t rejectCode) {
+        size_t index = rejectCode > 0 &&
+                               static_cast<size_t>(rejectCode) <= MAX_REJECT_CODE
+                           ? static_cast<size_t>(rejectCode)
+                           : 0;
+        increment(rejects_[index]);
+    }
+    void publish(const TradeCore &core);
+
+    // 以下可在任意线程上调用
+
+    MetricsSnapshot snapshot() const;
+
+  private:
+    struct SecuritySlot {
+        Market market = Market::UNKNOWN;
+        SecurityId securityId;
+        std::atomic<uint64_t> restingOrders{0};
+    };
+
+    // 单写者，读-加-写即可，不需要 lock 前缀的原子加
+    static void increment(std::atomic<uint64_t> &value) {
+        value.store(value.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(MetricCounter::COUNT)>
+        counters_{};
+    std::array<std::atomic<uint64_t>, MAX_REJECT_CODE + 1> rejects_{};
+
+    // 奇数表示采样进行中
+    std::atomic<uint64_t> version_{0};
+    std::atomic<uint64_t> publishedNs_{0};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(MetricGauge::COUNT)>
+        gauges_{};
+    size_t maxSecurities_;
+    std::unique_ptr<SecuritySlot[]> securities_;
+    // 已写好名称的股票数，名称写入后以 release 发布，之后不再修改
+    std::atomic<size_t> namedSecurities_{0};
+};
+
+} // namespace hdf
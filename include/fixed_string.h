@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace hdf {
+
+/**
+ * @brief 定长内联字符串，用于订单号、股票代码、股东号等协议标识符。
+ *
+ * 字符直接存放在对象内部，构造、拷贝都不分配堆内存。
+ * 未使用的字节始终补0，因此相等比较和哈希可以按整块内存进行。
+ * 超出容量的输入会抛出 std::invalid_argument，解析阶段据此拒绝订单。
+ *
+ * @tparam N 最大字符数。
+ */
+template <size_t N> class FixedString {
+    static_assert(N > 0 && N < 256, "FixedString capacity must fit in uint8_t");
+
+  public:
+    static constexpr size_t CAPACITY = N;
+
+    constexpr FixedString() = default;
+    FixedString(const char *s) { assign(std::string_view(s)); }
+    FixedString(const std::string &s) { assign(std::string_view(s)); }
+    FixedString(std::string_view s) { assign(s); }
+
+    void assign(std::string_view s) {
+        if (s.size() > N) {
+            throw std::invalid_argument("identifier longer than " +
+                                        std::to_string(N) +
+                                        " chars: " + std::string(s));
+        }
+        std::memcpy(data_, s.data(), s.size());
+        std::memset(data_ + s.size(), 0, N - s.size());
+        size_ = static_cast<uint8_t>(s.size());
+    }
+
+    constexpr size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr const char *data() const { return data_; }
+    constexpr std::string_view view() const { return {data_, size_}; }
+    std::string str() const { return std::string(view()); }
+
+    operator std::string_view() const { return view(); }
+
+    /**
+     * @brief 按8字节分块的乘法哈希，补0的尾部参与计算不影响结果正确性。
+     */
+    size_t hash() const {
+        uint64_t h = 0x9E3779B97F4A7C15ULL ^ size_;
+        for (size_t i = 0; i < N; i += 8) {
+            uint64_t word = 0;
+            std::memcpy(&word, data_ + i, N - i < 8 ? N - i : 8);
+            h = (h ^ word) * 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 32;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    friend bool operator==(const FixedString &a, const FixedString &b) {
+        return a.size_ == b.size_ && std::memcmp(a.data_, b.data_, N) == 0;
+    }
+    friend bool operator==(const FixedString &a, std::string_view b) {
+        return a.view() == b;
+    }
+    friend bool operator==(const FixedString &a, const std::string &b) {
+        return a.view() == b;
+    }
+    friend bool operator==(const FixedString &a, const char *b) {
+        return a.view() == b;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const FixedString &s) {
+        return os << s.view();
+    }
+
+  private:
+    char data_[N] = {};
+    uint8_t size_ = 0;
+};
+
+template <size_t N>
+void to_json(nlohmann::json &j, const FixedString<N> &s) {
+    j = s.view();
+}
+
+template <size_t N>
+void from_json(const nlohmann::json &j, FixedString<N> &s) {
+    s.assign(j.get_ref<const std::string &>());
+}
+
+} // namespace hdf
+
+template <size_t N> struct std::hash<hdf::FixedString<N>> {
+    size_t operator()(const hdf::FixedString<N> &s) const { return s.hash(); }
+};
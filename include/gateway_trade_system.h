@@ -0,0 +1,161 @@
+#pragma once
+
+#include "engine_config.h"
+#include "engine_messages.h"
+#include "mpsc_queue.h"
+#include "trade_sink.h"
+#include "trade_system.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+namespace hdf {
+
+/**
+ * @brief 多个网关线程共用一个撮合核心的交易系统。
+ *
+ *   网关线程0 ─┐
+ *   网关线程1 ─┼─MPSC─> 核心线程（风控+撮合）──> sink
+ *   ...       ─┘
+ *
+ * 每个客户端会话一个网关线程，各自通过 openGateway() 取得的 Gateway
+ * 提交消息，网关之间不加锁，只在无锁入站队列的写位置上竞争。
+ * 每条消息带有网关号和该网关内从1开始递增的序号；同一网关的消息按提交顺序
+ * 处理，不同网关之间按入队先后处理。
+ *
+ * 核心线程按批取出消息交给独占的 TradeSystem，sink 在核心线程上调用。
+ * 核心线程处理完一条消息后更新该网关的已处理序号，网关可据此确认进度。
+ *
+ * 配置了 pendingCancelTimeoutNs 时，核心线程每批用 steady_clock 推进一次时间。
+ *
+ * stats() 报告队列深度和入队到出队的等待时间，可由任意线程调用。
+ */
+class GatewayTradeSystem {
+  public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 1 << 16;
+    static constexpr size_t DEFAULT_MAX_GATEWAYS = 64;
+    // 每批最多处理的消息数，限制单批占用时间
+    static constexpr size_t MAX_BATCH = 256;
+
+    /**
+     * @brief 入站队列的统计信息。
+     */
+    struct Stats {
+        size_t depth = 0;            // 当前排队的消息数
+        uint64_t dequeued = 0;       // 累计出队的消息数
+        uint64_t batches = 0;        // 累计处理的批数
+        uint64_t totalLatencyNs = 0; // 累计入队到出队的等待时间
+        uint64_t maxLatencyNs = 0;   // 单条消息的最大等待时间
+    };
+
+    /**
+     * @brief 一个网关的提交接口，只能由一个线程使用。
+     * 所有 submit* 返回本条消息的序号。
+     */
+    class Gateway {
+      public:
+        Gateway(Gateway &&) = default;
+        Gateway &operator=(Gateway &&) = default;
+
+        uint32_t id() const { return id_; }
+
+        uint64_t submitOrder(const Order &order);
+        uint64_t submitCancel(const CancelOrder &cancel);
+        uint64_t submitResponse(const OrderResponse &response);
+        uint64_t submitResponse(const CancelResponse &response);
+        /**
+         * @brief 在网关线程上解析 JSON 文本后提交，规则同 TradeSystem 的 *Raw 接口。
+         */
+        uint64_t submitOrderRaw(std::string_view input);
+        uint64_t submitCancelRaw(std::string_view input);
+
+        /**
+         * @brief 核心线程已处理完的本网关最大序号。
+         */
+        uint64_t processedSequence() const;
+
+      private:
+        friend class GatewayTradeSystem;
+        Gateway(GatewayTradeSystem &system, uint32_t id)
+            : system_(&system), id_(id) {}
+
+        GatewayTradeSystem *system_;
+        uint32_t id_;
+        uint64_t nextSequence_ = 1;
+
+        uint64_t submit(InboundMessage &&message);
+    };
+
+    /**
+     * @brief 构造并启动核心线程。
+     * @param clientSink 客户端回报，在核心线程上调用，不可为空
+     * @param exchangeSink 交易所指令，在核心线程上调用；为空时是纯撮合系统
+     * @param maxGateways openGateway() 最多可调用的次数
+     */
+    GatewayTradeSystem(ClientSink &clientSink, ExchangeSink *exchangeSink,
+                       const EngineConfig &config = {},
+                       size_t maxGateways = DEFAULT_MAX_GATEWAYS,
+                       size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+    /**
+     * @brief 等价于 stop()。
+     */
+    ~GatewayTradeSystem();
+
+    GatewayTradeSystem(const GatewayTradeSystem &) = delete;
+    GatewayTradeSystem &operator=(const GatewayTradeSystem &) = delete;
+
+    /**
+     * @brief 分配一个新网关，可由任意线程调用。
+     * @throws std::length_error 网关数超过 maxGateways
+     */
+    Gateway openGateway();
+
+    Stats stats() const;
+
+    /**
+     * @brief 停止接收输入，等待已提交的消息全部处理完毕后结束核心线程。
+     * 须在所有网关停止提交后调用；重复调用无副作用。
+     */
+    void stop();
+
+  private:
+    struct Envelope {
+        uint32_t gateway = 0;
+        uint64_t sequence = 0;
+        uint64_t enqueueNs = 0;
+        InboundMessage message;
+    };
+
+    // 每个网关的已处理序号独占一个缓存行，网关轮询时不互相干扰
+    struct alignas(CACHE_LINE_SIZE) GatewayProgress {
+        std::atomic<uint64_t> processed{0};
+    };
+
+    ClientSink &clientSink_;
+
+    MpscQueue<Envelope> inbound_;
+    const size_t maxGateways_;
+    std::unique_ptr<GatewayProgress[]> progress_;
+    std::atomic<uint32_t> gatewayCount_{0};
+    // 只在核心线程上访问
+    TradeSystem core_;
+    // 配置了撤单回报超时，核心线程每批推进一次时间
+    const bool timed_;
+
+    // 由核心线程写入，任意线程读取
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dequeued_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> totalLatencyNs_{0};
+    std::atomic<uint64_t> maxLatencyNs_{0};
+
+    std::atomic<bool> inputClosed_{false};
+    bool stopped_ = false;
+
+    std::thread coreThread_;
+
+    void coreLoop();
+};
+
+} // namespace hdf
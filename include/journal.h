@@ -0,0 +1,295 @@
+#pragma once
+
+#include "types.h"
+#include "wire_protocol.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace hdf {
+
+/**
+ * 预写事件日志（write-ahead journal）。
+ *
+ * 交易系统在处理每条入站消息（订单、撤单、交易所回报）之前把它追加到日志，
+ * 重启时按顺序重放即可确定性地重建撮合簿、风控索引和前置模式的待定撮合。
+ * 配置了撤单回报超时的前置系统还会记录 advanceTime 的时间，
+ * 保证重放时超时在同样的位置发生。
+ *
+ * 文件格式（小端）：
+ *
+ *   文件头: | magic:u32 "HDJ1" | version:u32 |
+ *   记录:   | payloadSize:u32 | checksum:u32 | sequence:u64 | kind:u8 | payload |
+ *
+ * WIRE 记录的 payload 是一条完整的二进制协议消息（见 wire_protocol.h），
+ * TIME 记录的 payload 是 u64 纳秒时间。checksum 覆盖 sequence、kind 和
+ * payload。sequence 从1开始连续递增，读取时序号不连续即报错。
+ *
+ * 写入时记录先进入内存缓冲区，按组提交：一次 write(2) 写出整组，
+ * 再按 JournalSync 决定是否 fdatasync。读取时遇到不完整或校验失败的记录
+ * （崩溃时写了一半的尾部）即停止，重新打开写入时截掉这部分。
+ * 提交失败时组可能只写出一部分，写入器进入失败状态，之后的追加和提交
+ * 都抛出异常，不再跳过丢失的记录继续编号；须重新打开日志（截掉不完整的
+ * 尾部）并重放恢复。
+ */
+enum class JournalSync : uint8_t {
+    NONE,  // 只 write，进程崩溃不丢数据，掉电可能丢失最近的组
+    GROUP, // 每组提交后 fdatasync 一次
+    EACH,  // 每条记录都立即提交并 fdatasync，延迟最高
+};
+
+struct JournalOptions {
+    JournalSync sync = JournalSync::GROUP;
+    // 缓冲的记录数达到该值时自动提交一组；调用方也可以在每批处理后显式 commit()
+    size_t groupRecords = 256;
+    size_t bufferBytes = 1 << 20;
+};
+
+namespace journal {
+
+constexpr uint32_t MAGIC = 0x314A4448; // "HDJ1"
+constexpr uint32_t VERSION = 1;
+constexpr size_t FILE_HEADER_SIZE = 8;
+constexpr size_t RECORD_HEADER_SIZE = 4 + 4 + 8 + 1;
+
+enum class RecordKind : uint8_t { WIRE = 1, TIME = 2 };
+
+uint32_t checksum(const uint8_t *data, size_t size);
+
+inline uint32_t loadU32(const uint8_t *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    if constexpr (std::endian::native == std::endian::big) {
+        v = std::byteswap(v);
+    }
+    return v;
+}
+
+inline uint64_t loadU64(const uint8_t *p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    if constexpr (std::endian::native == std::endian::big) {
+        v = std::byteswap(v);
+    }
+    return v;
+}
+
+} // namespace journal
+
+/**
+ * @brief 日志扫描结果。
+ */
+struct JournalScan {
+    uint64_t records = 0;      // 有效记录数
+    uint64_t lastSequence = 0; // 最后一条有效记录的序号，空日志为0
+    size_t validBytes = 0;     // 有效部分（含文件头）的字节数
+    bool truncated = false;    // 尾部有不完整或损坏的记录
+};
+
+/**
+ * @brief 日志写入器。
+ *
+ * 打开已有的日志时先扫描，截掉损坏的尾部，序号接着最后一条有效记录继续。
+ * 非线程安全，应由处理消息的线程使用。
+ */
+class JournalWriter {
+  public:
+    /**
+     * @throws std::system_error 打开、读取或截断文件失败
+     * @throws std::runtime_error 文件不是日志，或记录序号不连续
+     */
+    explicit JournalWriter(const std::string &path,
+                           const JournalOptions &options = {});
+    /**
+     * @brief 提交缓冲中的记录并关闭文件。
+     */
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter &) = delete;
+    JournalWriter &operator=(const JournalWriter &) = delete;
+
+    /**
+     * @brief 追加一条记录，返回其序号。
+     * @throws std::system_error 自动提交时写入失败
+     * @throws std::runtime_error 之前的提交失败过
+     */
+    uint64_t append(const Order &order);
+    uint64_t append(const CancelOrder &cancel);
+    uint64_t append(const OrderResponse &response);
+    uint64_t append(const CancelResponse &response);
+    uint64_t appendTime(uint64_t nowNs);
+
+    /**
+     * @brief 把缓冲中的记录作为一组写出，并按 JournalSync 刷盘。
+     * 缓冲为空时不做任何事。写入或刷盘失败后缓冲保留，写入器进入失败状态。
+     * @throws std::system_error 写入或刷盘失败
+     * @throws std::runtime_error 之前的提交失败过
+     */
+    void commit();
+
+    uint64_t nextSequence() const { return nextSequence_; }
+    // 已写出（并按配置刷盘）的最大序号
+    uint64_t committedSequence() const { return committedSequence_; }
+    // 提交失败过，之后不能再使用
+    bool failed() const { return failed_; }
+
+  private:
+    int fd_ = -1;
+    JournalOptions options_;
+    std::unique_ptr<uint8_t[]> buffer_;
+    size_t size_ = 0;
+    size_t pendingRecords_ = 0;
+    uint64_t nextSequence_ = 1;
+    uint64_t committedSequence_ = 0;
+    bool failed_ = false;
+
+    void checkFailed() const;
+    uint8_t *beginRecord(size_t maxPayload);
+    uint64_t endRecord(uint8_t *record, journal::RecordKind kind,
+                       size_t payloadSize);
+    void writeAll(const uint8_t *data, size_t n);
+};
+
+/**
+ * @brief 日志读取器，把文件只读映射到内存后顺序解码。
+ */
+class JournalReader {
+  public:
+    /**
+     * @throws std::system_error 打开或映射文件失败
+     * @throws std::runtime_error 文件不是日志
+     */
+    explicit JournalReader(const std::string &path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+
+    /**
+     * @brief 按顺序对每条有效记录调用 onRecord(sequence, kind, payload)，
+     * 遇到不完整或损坏的记录时停止。
+     * @throws std::runtime_error 记录序号不是上一条加1（中间有记录丢失）
+     */
+    template <typename F> JournalScan forEach(F &&onRecord) const;
+
+    /**
+     * @brief 把日志重放到交易系统，返回扫描结果。
+     *
+     * System 可以是 TradeSystem 或 BasicTradeSystem。重放时系统的输出
+     * 通常应丢弃：纯撮合模式不设置 sink，前置模式把交易所接口设为
+     * NullExchangeSink（模式由是否设置交易所接口决定）。
+     * 重放完成后再换上真实的 sink 并开始写日志。
+     * 从快照恢复后只需重放快照之后的记录：afterSequence 取
+     * SnapshotReader::journalSequence()，序号不大于它的记录跳过。
+     *
+     * @throws std::runtime_error 记录的 payload 无法解码，或记录序号不连续
+     * @throws std::invalid_argument 记录的消息头非法
+     */
+    template <typename System>
+    JournalScan replay(System &system, uint64_t afterSequence = 0) const;
+
+  private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename F> JournalScan JournalReader::forEach(F &&onRecord) const {
+    JournalScan scan;
+    size_t pos = journal::FILE_HEADER_SIZE;
+    scan.validBytes = pos;
+    while (pos < size_) {
+        if (size_ - pos < journal::RECORD_HEADER_SIZE) {
+            scan.truncated = true;
+            break;
+        }
+        const uint8_t *record = data_ + pos;
+        uint32_t payloadSize = journal::loadU32(record);
+        if (size_ - pos - journal::RECORD_HEADER_SIZE < payloadSize) {
+            scan.truncated = true;
+            break;
+        }
+        // 校验范围：sequence、kind、payload
+        if (journal::checksum(record + 8, 9 + payloadSize) !=
+            journal::loadU32(record + 4)) {
+            scan.truncated = true;
+            break;
+        }
+        uint64_t sequence = journal::loadU64(record + 8);
+        if (sequence != scan.lastSequence + 1) {
+            // 校验通过但序号跳跃：中间的记录丢失，继续重放会得到错误的状态
+            throw std::runtime_error("journal: sequence gap");
+        }
+        auto kind = static_cast<journal::RecordKind>(record[16]);
+        onRecord(sequence, kind,
+                 std::span<const uint8_t>(
+                     record + journal::RECORD_HEADER_SIZE, payloadSize));
+        pos += journal::RECORD_HEADER_SIZE + payloadSize;
+        scan.records++;
+        scan.lastSequence = sequence;
+        scan.validBytes = pos;
+    }
+    return scan;
+}
+
+template <typename System>
+JournalScan JournalReader::replay(System &system,
+                                  uint64_t afterSequence) const {
+    return forEach([&system, afterSequence](uint64_t sequence,
+                                            journal::RecordKind kind,
+                                            std::span<const uint8_t> payload) {
+        if (sequence <= afterSequence) {
+            return;
+        }
+        if (kind == journal::RecordKind::TIME) {
+            system.advanceTime(journal::loadU64(payload.data()));
+            return;
+        }
+        wire::MessageHeader header;
+        if (wire::decodeHeader(payload, header) == 0) {
+            throw std::runtime_error("journal: incomplete wire message");
+        }
+        // 日志中是系统实际处理过的消息，照原样重放，不做字段校验；
+        // 未知的市场和方向保持 UNKNOWN
+        switch (header.templateId) {
+        case wire::TemplateId::NEW_ORDER: {
+            Order order;
+            order.market = Market::UNKNOWN;
+            order.side = Side::UNKNOWN;
+            wire::decode(payload, order);
+            system.handleOrder(order);
+            return;
+        }
+        case wire::TemplateId::CANCEL_ORDER: {
+            CancelOrder cancel;
+            cancel.market = Market::UNKNOWN;
+            cancel.side = Side::UNKNOWN;
+            wire::decode(payload, cancel);
+            system.handleCancel(cancel);
+            return;
+        }
+        case wire::TemplateId::ORDER_CONFIRM:
+        case wire::TemplateId::ORDER_REJECT:
+        case wire::TemplateId::EXECUTION_REPORT: {
+            OrderResponse response;
+            wire::decode(payload, response);
+            system.handleResponse(response);
+            return;
+        }
+        case wire::TemplateId::CANCEL_CONFIRM:
+        case wire::TemplateId::CANCEL_REJECT: {
+            CancelResponse response;
+            wire::decode(payload, response);
+            system.handleResponse(response);
+            return;
+        }
+        }
+        throw std::runtime_error("journal: unknown wire template");
+    });
+}
+
+} // namespace hdf
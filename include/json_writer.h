@@ -0,0 +1,51 @@
+#pragma once
+
+#include "buffered_writer.h"
+#include "trade_sink.h"
+#include "types.h"
+
+namespace hdf {
+
+/**
+ * 不经过 nlohmann::json，直接把消息格式化为一行 JSON 文本（以换行结尾）。
+ *
+ * 字段集合与 types.h 中的 to_json 相同，键按字母序输出，
+ * 与 nlohmann::json::dump() 的结果逐字节一致。
+ * 价格由定点整数直接格式化，不经过浮点数。
+ */
+void writeJsonLine(BufferedWriter &out, const Order &order);
+void writeJsonLine(BufferedWriter &out, const CancelOrder &cancel);
+void writeJsonLine(BufferedWriter &out, const OrderResponse &response);
+void writeJsonLine(BufferedWriter &out, const CancelResponse &response);
+
+// 把回报和指令逐行写入 BufferedWriter 的 sink，用于批量回放等场景
+
+class JsonLineClientSink : public ClientSink {
+  public:
+    explicit JsonLineClientSink(BufferedWriter &out) : out_(out) {}
+
+    void onOrderResponse(const OrderResponse &response) override {
+        writeJsonLine(out_, response);
+    }
+    void onCancelResponse(const CancelResponse &response) override {
+        writeJsonLine(out_, response);
+    }
+
+  private:
+    BufferedWriter &out_;
+};
+
+class JsonLineExchangeSink : public ExchangeSink {
+  public:
+    explicit JsonLineExchangeSink(BufferedWriter &out) : out_(out) {}
+
+    void onOrder(const Order &order) override { writeJsonLine(out_, order); }
+    void onCancel(const CancelOrder &cancel) override {
+        writeJsonLine(out_, cancel);
+    }
+
+  private:
+    BufferedWriter &out_;
+};
+
+} // namespace hdf
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace hdf {
+
+// 构建时定义 HDF_LATENCY_STATS（CMake 选项 -DHDF_LATENCY_STATS=ON）才记录，
+// 否则计时和记录都是空的内联函数，编译后不留下任何代码
+#ifdef HDF_LATENCY_STATS
+inline constexpr bool LATENCY_STATS_ENABLED = true;
+#else
+inline constexpr bool LATENCY_STATS_ENABLED = false;
+#endif
+
+/**
+ * @brief 处理一条消息的各个阶段。TOTAL 为进入处理逻辑到返回的总耗时，
+ * 不含 PARSE（解析在处理逻辑之前，由各文本/二进制入口记录）。
+ */
+enum class LatencyStage : uint8_t {
+    PARSE,      // JSON/文本/二进制消息解析为结构体
+    RISK_CHECK, // 驻留编号和对敲检查
+    MATCH,      // 撮合
+    ADD_ORDER,  // 入簿并登记风控
+    CANCEL,     // 撤单或交易所成交后更新订单簿和风控
+    RESPONSE,   // 生成回报和发往交易所的指令，交给 sink
+    TOTAL,
+    COUNT
+};
+
+enum class LatencyMessage : uint8_t {
+    ORDER,
+    CANCEL,
+    ORDER_RESPONSE,  // 交易所的订单回报
+    CANCEL_RESPONSE, // 交易所的撤单回报
+    COUNT
+};
+
+const char *toString(LatencyStage stage);
+const char *toString(LatencyMessage message);
+
+namespace latency {
+
+/**
+ * @brief 当前时间戳：x86 上为 TSC 计数，其他平台为 steady_clock 纳秒。
+ * 未开启统计时恒为0。
+ */
+inline uint64_t now() {
+    if constexpr (!LATENCY_STATS_ENABLED) {
+        return 0;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @brief 每个时间戳单位对应的纳秒数。x86 上首次调用时对照 steady_clock
+ * 校准 TSC 频率（约10毫秒），只在输出统计时使用。
+ */
+double nsPerTick();
+
+} // namespace latency
+
+/**
+ * @brief 对数分桶的耗时直方图（HDR 直方图的简化版）。
+ *
+ * 小于 2^SUB_BITS 的值每个值一个桶；更大的值按最高位所在的二进制数量级
+ * 分组，每组再线性细分为 2^SUB_BITS 个桶，相对误差不超过 2^-SUB_BITS。
+ * 超过 2^MAX_BITS 的值计入最后一个桶。桶数组固定大小，记录时只做加法，
+ * 不分配内存。
+ */
+class LatencyHistogram {
+  public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr unsigned MAX_BITS = 40;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BITS;
+    static constexpr size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value) {
+        counts_[bucketOf(value)]++;
+        count_++;
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+
+    /**
+     * @brief 分位数 q（0 到 1）所在桶的上界，不超过最大值；无记录时返回0。
+     */
+    uint64_t percentile(double q) const;
+
+    void reset();
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        unsigned exponent = std::bit_width(value) - 1;
+        if (exponent >= MAX_BITS) {
+            return BUCKETS - 1;
+        }
+        unsigned shift = exponent - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS +
+               static_cast<size_t>((value >> shift) - SUB_BUCKETS);
+    }
+    // 桶内最大的值
+    static uint64_t bucketUpperBound(size_t bucket);
+
+  private:
+    std::array<uint64_t, BUCKETS> counts_{};
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+};
+
+/**
+ * @brief 单个（消息类型, 阶段）的统计结果，单位为纳秒。
+ */
+struct LatencySummary {
+    uint64_t count = 0;
+    double p50Ns = 0;
+    double p99Ns = 0;
+    double p999Ns = 0;
+    double maxNs = 0;
+};
+
+/**
+ * @brief 按消息类型和阶段分别记录的耗时直方图。
+ *
+ * 直方图在构造时一次性分配，记录时不分配内存；未开启统计时不分配，
+ * record 为空操作，summary 返回全0。由处理线程记录，
+ * 读取和 reset 须在同一线程上或处理暂停时进行。
+ */
+class LatencyStats {
+  public:
+    LatencyStats();
+
+    void record(LatencyMessage message, LatencyStage stage, uint64_t ticks) {
+        if constexpr (LATENCY_STATS_ENABLED) {
+            histogram(message, stage).record(ticks);
+        }
+    }
+
+    LatencySummary summary(LatencyMessage message, LatencyStage stage) const;
+
+    /**
+     * @brief 每个有记录的（消息类型, 阶段）一行：次数、p50/p99/p99.9/最大值（纳秒）。
+     */
+    std::string format() const;
+
+    void reset();
+
+  private:
+    static constexpr size_t STAGES = static_cast<size_t>(LatencyStage::COUNT);
+    static constexpr size_t MESSAGES =
+        static_cast<size_t>(LatencyMessage::COUNT);
+
+    LatencyHistogram &histogram(LatencyMessage message, LatencyStage stage) {
+        return (*histograms_)[static_cast<size_t>(message) * STAGES +
+                              static_cast<size_t>(stage)];
+    }
+
+    std::unique_ptr<std::array<LatencyHistogram, MESSAGES * STAGES>>
+        histograms_;
+};
+
+/**
+ * @brief 一条消息处理过程中的分段计时。
+ * lap 记录自上次 lap（或构造）以来的耗时到指定阶段，析构时记录 TOTAL。
+ * 未开启统计时所有成员函数为空操作。
+ *
+ *   LatencyTimer timer(core.latency, LatencyMessage::ORDER);
+ *   riskController.checkOrder(order);
+ *   timer.lap(LatencyStage::RISK_CHECK);
+ */
+class LatencyTimer {
+  public:
+    LatencyTimer(LatencyStats &stats, LatencyMessage message)
+        : stats_(stats), message_(message) {
+        if constexpr (LATENCY_STATS_ENABLED) {
+            start_ = last_ = latency::now();
+        }
+    }
+
+    ~LatencyTimer() {
+        if constexpr (LATENCY_STATS_ENABLED) {
+            stats_.record(message_, LatencyStage::TOTAL,
+                          latency::now() - start_);
+        }
+    }
+
+    LatencyTimer(const LatencyTimer &) = delete;
+    LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+    void lap(LatencyStage stage) {
+        if constexpr (LATENCY_STATS_ENABLED) {
+            uint64_t now = latency::now();
+            stats_.record(message_, stage, now - last_);
+            last_ = now;
+        }
+    }
+
+  private:
+    LatencyStats &stats_;
+    LatencyMessage message_;
+    uint64_t start_ = 0;
+    uint64_t last_ = 0;
+};
+
+} // namespace hdf
@@ -1,16 +1,43 @@
 #pragma once
 
+#include "engine_config.h"
+#include "object_pool.h"
+#include "symbol_table.h"
 #include "types.h"
+#include <deque>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace hdf {
 
 class MatchingEngine {
   public:
+    /**
+     * @brief 使用自有的驻留表构造，适用于单独使用撮合引擎的场景。
+     */
     MatchingEngine();
+    /**
+     * @brief 与其他模块共享驻留表，订单中已填写的 securityKey 直接使用。
+     */
+    explicit MatchingEngine(SymbolTable &symbols);
     ~MatchingEngine();
 
+    /**
+     * @brief 按配置预分配挂单节点和句柄索引，应在开盘前调用。
+     */
+    void reserve(const EngineConfig &config);
+
+    /**
+     * @brief 设置成交编号序列：first, first + step, first + 2 * step, ...
+     * 多个引擎实例使用不同的 first、相同的 step 即可保证编号不重复。
+     */
+    void setExecIdSequence(uint64_t first, uint64_t step);
+
+    MatchingEngine(const MatchingEngine &) = delete;
+    MatchingEngine &operator=(const MatchingEngine &) = delete;
+
     struct MatchResult {
         std::vector<OrderResponse> executions; // 有可能匹配多个订单
         uint32_t remainingQty = 0;             // 未成交剩余数量
@@ -30,18 +57,38 @@ class MatchingEngine {
     std::optional<MatchResult>
     match(const Order &order,
           const std::optional<MarketData> &marketData = std::nullopt);
+    /**
+     * @brief 同上，结果写入调用方持有的 result，返回是否有成交。
+     * result.executions 先清空再填写，已有容量被复用；
+     * 处理线程反复使用同一个 result 时，稳态下撮合不分配内存。
+     */
+    bool match(const Order &order, MatchResult &result);
+
+    // 单边订单簿价格档位数组最多覆盖的价位数（约8MB）
+    static constexpr int64_t MAX_LEVELS = int64_t{1} << 18;
+
+    /**
+     * @brief 订单能否以其价格入簿。
+     * 单边订单簿的档位数组须覆盖本边所有挂单的价位，且不超过 MAX_LEVELS 个价位；
+     * 本边没有挂单时任何价格都可以入簿。调用方应在撮合前检查并拒绝不能入簿的订单。
+     */
+    bool canRest(const Order &order) const;
 
     /**
      * @brief 添加订单到内部订单簿。
      * 由调用方在合适的时机显式调用此函数入簿。
      * 支持传入修改后的数量（如部分成交后的剩余量）。
+     * clOrderId 已在簿中时忽略本次入簿。
+     *
+     * @return 价格超出档位范围（canRest 为 false）时不入簿，返回 false
      */
-    void addOrder(const Order &order);
+    bool addOrder(const Order &order);
 
     /**
      * @brief 从内部订单簿中移除订单。
+     * 订单不存在时返回 type 为 REJECT 的撤单回报。
      */
-    CancelResponse cancelOrder(const std::string &clOrderId);
+    CancelResponse cancelOrder(const ClOrderId &clOrderId);
 
     /**
      * @brief 减少订单簿中指定订单的数量。
@@ -51,11 +98,137 @@ class MatchingEngine {
      * @param clOrderId 订单的唯一编号。
      * @param qty 要减少的数量。
      */
-    void reduceOrderQty(const std::string &clOrderId, uint32_t qty);
+    void reduceOrderQty(const ClOrderId &clOrderId, uint32_t qty);
+
+    /**
+     * @brief 按股票、买卖方向、价位、时间先后的顺序访问每笔挂单：
+     * visit(order, origQty)，order.qty 为剩余数量。
+     * 按同样的顺序 restoreOrder 即可重建相同的订单簿。
+     */
+    template <typename F> void forEachOrder(F &&visit) const;
+
+    /**
+     * @brief 恢复一笔挂单，origQty 为最初入簿的数量。
+     */
+    void restoreOrder(const Order &order, uint32_t origQty);
+
+    size_t orderCount() const { return orderIndex_.size(); }
+    /**
+     * @brief 指定股票买卖两边的挂单笔数，编号须来自共享的驻留表。
+     */
+    size_t restingOrders(SecurityKey securityKey) const {
+        if (securityKey >= books_.size()) {
+            return 0;
+        }
+        const OrderBook &book = books_[securityKey];
+        return book.bids.orderCount + book.asks.orderCount;
+    }
+    /**
+     * @brief 占用的内存字节数：挂单节点池、句柄索引的桶数组和价格档位数组。
+     * 耗时与股票数成正比，供监控采样使用。
+     */
+    size_t memoryBytes() const;
+    uint64_t nextExecId() const { return nextExecId_; }
+    uint64_t execIdStep() const { return execIdStep_; }
 
   private:
-    // 订单簿
-    // std::map<std::string, std::vector<Order>> orderBook_;
+    /**
+     * @brief 订单簿中的挂单节点。
+     *
+     * 同一价格档位的挂单通过 prev/next 组成侵入式双向链表（FIFO），
+     * 入队、出队和任意位置摘除都是 O(1)，不需要移动其他订单。
+     */
+    struct BookSide;
+
+    struct OrderNode {
+        Order order;        // 挂单信息，order.qty 为当前剩余数量
+        uint32_t origQty;   // 入簿时的数量，用于计算累计成交量
+        int64_t tick;       // 所在价位（以最小变动价位为单位）
+        BookSide *bookSide; // 所在的单边订单簿
+        OrderNode *prev = nullptr;
+        OrderNode *next = nullptr;
+    };
+
+    /**
+     * @brief 一个价格档位，同价挂单按时间先后排列。
+     */
+    struct PriceLevel {
+        OrderNode *head = nullptr; // 最早的挂单，最先成交
+        OrderNode *tail = nullptr; // 最新的挂单
+        uint64_t totalQty = 0;     // 档位内剩余数量合计
+        uint32_t orderCount = 0;   // 档位内挂单笔数
+    };
+
+    /**
+     * @brief 单边订单簿。
+     *
+     * 价格档位按 tick 偏移存放在连续数组中：levels[tick - baseTick]。
+     * 定位档位是一次下标运算，无需有序容器的查找。
+     * 价格超出当前范围时数组按需扩展（不会缩小）。
+     */
+    struct BookSide {
+        Side side = Side::UNKNOWN;      // 本边方向
+        int64_t baseTick = 0;           // levels[0] 对应的价位
+        std::vector<PriceLevel> levels; // 价格档位数组
+        int64_t bestTick = 0;           // 最优价位，orderCount 为0时无意义
+        size_t orderCount = 0;          // 本边挂单总笔数
+    };
+
+    // 单只股票的订单簿
+    struct OrderBook {
+        BookSide bids; // 买方，最优价为最高价
+        BookSide asks; // 卖方，最优价为最低价
+
+        OrderBook() {
+            bids.side = Side::BUY;
+            asks.side = Side::SELL;
+        }
+    };
+
+    std::unique_ptr<SymbolTable> ownedSymbols_;
+    SymbolTable *symbols_;
+
+    // 股票编号 -> 订单簿，以 SecurityKey 为下标。
+    // deque 在尾部扩展时已有元素地址不变，
+    // 挂单节点可以直接持有所在 BookSide 的指针。
+    std::deque<OrderBook> books_;
+    // 挂单节点的内存池，须先于 orderIndex_ 构造、后于其析构
+    BlockPool nodePool_;
+    // 订单句柄索引：clOrderId -> 挂单节点，挂单节点就存放在索引的元素中。
+    // 撤单和交易所成交同步只拿到 clOrderId，借此 O(1) 定位节点；
+    // 节点完全成交、撤单或减量归零时同步删除索引项，节点内存回到池中。
+    PooledHashMap<ClOrderId, OrderNode> orderIndex_;
+    // 下一个成交编号及步长
+    uint64_t nextExecId_ = 1;
+    uint64_t execIdStep_ = 1;
+
+    static bool inRange(const BookSide &side, int64_t tick);
+    static void ensureRange(BookSide &side, int64_t tick);
+    static void insertNode(BookSide &side, OrderNode *node);
+    static void removeNode(BookSide &side, OrderNode *node);
+    static void advanceBest(BookSide &side);
+
+    // 将节点移出订单簿和句柄索引
+    void eraseNode(OrderNode *node);
+    // 查找订单所属股票的订单簿，不存在时返回 nullptr
+    OrderBook *findBook(const Order &order);
+    const OrderBook *findBook(const Order &order) const;
 };
 
+template <typename F> void MatchingEngine::forEachOrder(F &&visit) const {
+    for (const OrderBook &book : books_) {
+        for (const BookSide *side : {&book.bids, &book.asks}) {
+            if (side->orderCount == 0) {
+                continue;
+            }
+            for (const PriceLevel &level : side->levels) {
+                for (const OrderNode *node = level.head; node;
+                     node = node->next) {
+                    visit(node->order, node->origQty);
+                }
+            }
+        }
+    }
+}
+
 } // namespace hdf
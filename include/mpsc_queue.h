@@ -0,0 +1,136 @@
+#pragma once
+
+#include "spsc_ring.h"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace hdf {
+
+/**
+ * @brief 有界无锁多生产者单消费者队列。
+ *
+ * 每个槽带一个序号：序号等于写位置时槽空闲，生产者用 CAS 抢占写位置后
+ * 写入元素，再把序号置为写位置+1 发布；消费者看到序号等于读位置+1
+ * 时取出元素，再把序号推进一圈交还给生产者。生产者之间只竞争写位置
+ * 这一个原子变量，不加锁，某个生产者被挂起也不会阻塞其他生产者
+ * 抢占后面的槽（只会让消费者在该槽处暂停）。
+ *
+ * 同一生产者先后入队的元素按入队顺序出队；不同生产者之间的顺序
+ * 由抢占写位置的先后决定。
+ *
+ * 元素槽在构造时全部默认构造，出队后不析构而是在下次入队时被赋值覆盖。
+ *
+ * tryPush/push 可由任意线程并发调用，popBatch 只能由一个线程调用。
+ */
+template <typename T> class MpscQueue {
+  public:
+    explicit MpscQueue(size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+          slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief 入队，队列满时返回 false。
+     */
+    template <typename U> bool tryPush(U &&value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &slots_[tail & mask_];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence - tail);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(tail, tail + 1,
+                                                std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // 该槽上一圈的元素还未被取走
+                return false;
+            } else {
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::forward<U>(value);
+        slot->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 入队，队列满时自旋等待消费者腾出空间。
+     */
+    template <typename U> void push(U &&value) {
+        SpinWait spin;
+        while (!tryPush(std::forward<U>(value))) {
+            spin.wait();
+        }
+    }
+
+    /**
+     * @brief 按顺序取出至多 maxBatch 个已发布的元素，依次调用 consume(T &)。
+     * 遇到已被抢占但尚未写完的槽即停止。仅消费者调用。
+     * @return 本批处理的元素个数
+     */
+    template <typename F> size_t popBatch(F &&consume, size_t maxBatch) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (count < maxBatch) {
+            Slot &slot = slots_[(head + count) & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) !=
+                head + count + 1) {
+                break;
+            }
+            consume(slot.value);
+            slot.sequence.store(head + count + mask_ + 1,
+                                std::memory_order_release);
+            count++;
+        }
+        if (count > 0) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief 当前排队的元素个数（含已抢占未写完的），只是近似值，
+     * 可由任意线程调用。
+     */
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief 队列是否为空。只在生产者都静止时结果才准确。
+     */
+    bool empty() const { return size() == 0; }
+
+  private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // 消费者写入
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    // 生产者竞争写入
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+};
+
+} // namespace hdf
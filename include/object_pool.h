@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 定长内存块池（slab + 空闲链表）。
+ *
+ * 按 slab 成批向系统申请内存，切成等长的块挂到空闲链表上，
+ * 分配和释放都是链表头部的一次指针操作，不经过全局分配器。
+ * 释放的块只回到空闲链表，slab 在池析构时才归还系统。
+ *
+ * 块大小可以在构造时给定，也可以为0，由第一次分配的大小确定。
+ * 后者用于标准容器的节点：节点类型由标准库实现决定，无法事先得知其大小。
+ *
+ * 开启大页时 slab 优先使用 2MB 大页（MAP_HUGETLB），不可用时退回普通页
+ * 并建议内核合并为透明大页。预分配时会写遍整个 slab，
+ * 把缺页中断提前到启动阶段，而不是发生在开盘的撮合路径上。
+ *
+ * 非线程安全，每个池只能由一个线程使用。
+ */
+class BlockPool {
+  public:
+    explicit BlockPool(size_t blockSize = 0, size_t blocksPerSlab = 1024);
+    ~BlockPool();
+
+    BlockPool(const BlockPool &) = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    /**
+     * @brief 设置是否使用大页，只影响之后新申请的 slab。
+     */
+    void setHugePages(bool enabled) { hugePages_ = enabled; }
+
+    /**
+     * @brief 预分配至少 blocks 个空闲块。
+     * 块大小尚未确定时记下数量，在块大小确定后补做预分配。
+     */
+    void reserve(size_t blocks);
+
+    /**
+     * @brief 判断 size 字节的单个对象能否由本池分配。
+     * 块大小未确定时以本次大小确定块大小。
+     */
+    bool accepts(size_t size);
+
+    void *allocate();
+    void deallocate(void *p);
+
+    size_t blockSize() const { return blockSize_; }
+    size_t capacity() const { return capacity_; } // 已切分的块总数
+    size_t inUse() const { return inUse_; }       // 已分配未释放的块数
+    size_t bytesReserved() const { return bytesReserved_; }
+
+  private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct Slab {
+        void *memory;
+        size_t bytes;
+        bool mapped; // 通过 mmap 申请，需要 munmap 释放
+    };
+
+    size_t blockSize_;
+    size_t blocksPerSlab_;
+    bool hugePages_ = false;
+    size_t pendingReserve_ = 0;
+
+    FreeBlock *freeList_ = nullptr;
+    std::vector<Slab> slabs_;
+    size_t capacity_ = 0;
+    size_t inUse_ = 0;
+    size_t bytesReserved_ = 0;
+
+    void addSlab(size_t blocks);
+};
+
+/**
+ * @brief 从 BlockPool 分配单个对象的标准分配器。
+ *
+ * 用于 unordered_map 等节点式容器：单个节点从池中分配，
+ * 桶数组等批量分配仍走全局分配器（只在 rehash 时发生）。
+ */
+template <typename T> class PoolAllocator {
+  public:
+    using value_type = T;
+
+    explicit PoolAllocator(BlockPool &pool) : pool_(&pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool_(other.pool()) {}
+
+    T *allocate(size_t n) {
+        if (n == 1 && alignof(T) <= alignof(std::max_align_t) &&
+            pool_->accepts(sizeof(T))) {
+            return static_cast<T *>(pool_->allocate());
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n) {
+        if (n == 1 && alignof(T) <= alignof(std::max_align_t) &&
+            pool_->accepts(sizeof(T))) {
+            pool_->deallocate(p);
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    BlockPool *pool() const { return pool_; }
+
+    template <typename U> bool operator==(const PoolAllocator<U> &o) const {
+        return pool_ == o.pool();
+    }
+
+  private:
+    BlockPool *pool_;
+};
+
+// 节点从 BlockPool 分配的哈希表
+template <typename K, typename V, typename Hash = std::hash<K>>
+using PooledHashMap =
+    std::unordered_map<K, V, Hash, std::equal_to<K>,
+                       PoolAllocator<std::pair<const K, V>>>;
+
+} // namespace hdf
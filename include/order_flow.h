@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 合成订单流的参数。比例均为 [0, 1] 之间的概率。
+ */
+struct OrderFlowConfig {
+    // 股票代码为6位：沪市 600000-999999、深市 000001-400000 各40万只
+    static constexpr size_t MAX_SECURITIES = 800000;
+    // 股东号为 'A' 加9位数字
+    static constexpr size_t MAX_SHAREHOLDERS = 999999999;
+
+    uint64_t seed = 1;
+    size_t securities = 100;   // 股票数，一半沪市一半深市
+    double zipfExponent = 1.0; // 股票热度服从 Zipf 分布，0 为均匀分布
+    size_t shareholders = 10000;
+    double cancelRatio = 0.3;    // 消息中撤单的比例
+    double aggressiveness = 0.2; // 订单中越过对手方最优价（可立即成交）的比例
+    double oddLotSellRatio = 0.05; // 卖单中零股（不足100股）的比例
+    double selfCrossRatio = 0.01;  // 订单中与同一股东的在途订单反向的比例
+    uint64_t firstOrderId = 1;     // 订单和撤单编号从此开始连续编号
+};
+
+/**
+ * @brief 合成订单流生成器，产生 TradeSystem 的订单和撤单输入。
+ *
+ * 每只股票维护一个模拟的最优买卖价（价差两个最小变动价位），
+ * 随订单缓慢随机游走；主动订单以最优价或更优的价格越过对手方，
+ * 被动订单挂在己方最优价之外的几个价位上。
+ *
+ * 普通订单的买卖方向由 (股东, 股票) 确定，同一股东在同一股票上
+ * 只朝一个方向下单，不会意外触发对敲；对敲订单取一笔在途订单的
+ * 股东和股票反向下单，在途订单尚未成交时会被风控拒绝。
+ * 撤单随机选取一笔在途订单，该订单可能已经成交，此时撤单被拒。
+ *
+ * 随机数和各分布都由本类自行实现，不依赖标准库分布的实现，
+ * 相同的参数（含种子）产生逐字节相同的消息序列。
+ * Zipf 权重由 std::pow 计算，不同平台的数学库结果可能在末位不同，
+ * 从而改变个别消息选中的股票，跨平台比较时应使用同一份生成的文件。
+ */
+class OrderFlowGenerator {
+  public:
+    struct Message {
+        enum class Kind : uint8_t { ORDER, CANCEL };
+        Kind kind = Kind::ORDER;
+        Order order;        // kind 为 ORDER 时有效
+        CancelOrder cancel; // kind 为 CANCEL 时有效
+    };
+
+    /**
+     * @throws std::invalid_argument 股票数或股东数超过编号位数能表示的上限
+     */
+    explicit OrderFlowGenerator(const OrderFlowConfig &config);
+
+    /**
+     * @brief 生成下一条消息，返回的引用在下次调用前有效。
+     */
+    const Message &next();
+
+    uint64_t generated() const { return generated_; }
+
+  private:
+    struct Security {
+        Market market;
+        SecurityId securityId;
+        int64_t midTick; // 模拟的中间价，最优买价 midTick - 1，最优卖价 midTick + 1
+    };
+
+    // 在途订单（生成器视角，不知道是否已经成交）
+    struct LiveOrder {
+        ClOrderId clOrderId;
+        uint32_t security;
+        uint32_t shareholder;
+        Side side;
+    };
+
+    OrderFlowConfig config_;
+    uint64_t rngState_;
+    std::vector<Security> securities_;
+    std::vector<double> zipfCdf_;
+    std::vector<ShareholderId> shareholders_;
+    std::vector<LiveOrder> live_;
+    uint64_t nextId_;
+    uint64_t generated_ = 0;
+    Message message_;
+
+    uint64_t nextRandom();
+    double uniform();                  // [0, 1)
+    uint64_t below(uint64_t n);        // [0, n)
+    uint32_t geometric(double p, uint32_t max); // 0, 1, 2, ... 截断到 max
+
+    uint32_t pickSecurity();
+    Side sideOf(uint32_t shareholder, uint32_t security) const;
+    ClOrderId makeId();
+    void makeOrder(uint32_t security, uint32_t shareholder, Side side,
+                   bool aggressive);
+    void makeCancel();
+    void remember(uint32_t security, uint32_t shareholder);
+};
+
+} // namespace hdf
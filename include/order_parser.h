@@ -0,0 +1,28 @@
+#pragma once
+
+#include "types.h"
+#include <string_view>
+
+namespace hdf {
+
+/**
+ * 直接从 JSON 文本解析订单和撤单的流式解析器。
+ *
+ * 一次扫描原始文本，把已知字段直接写入结构体：不构造 DOM，
+ * 不分配内存，字符串不含转义时不做拷贝。字段顺序任意，
+ * 未知字段整体跳过，重复字段以最后一次为准。
+ * 订单校验规则与 from_json 相同（共用 validateOrder）。
+ *
+ * 解析失败时返回错误描述（静态字符串），成功时返回 nullptr。
+ * 失败时输出结构体的内容未定义。
+ */
+const char *parseOrder(std::string_view text, Order &order);
+const char *parseCancelOrder(std::string_view text, CancelOrder &cancel);
+
+/**
+ * @brief 从（可能格式错误的）JSON 文本中尽量取出顶层的编号字段，
+ * 用于生成拒绝回报。取不到时返回空编号。
+ */
+ClOrderId findIdField(std::string_view text, std::string_view key);
+
+} // namespace hdf
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 前置模式下等待交易所撤单回报的内部撮合表。
+ *
+ * 内部撮合成功后，要先向交易所撤回每个对手方订单，收齐撤单回报后才能
+ * 确定成交结果。每次撮合占用一个槽，槽号和撤单编号一一对应：
+ * 第 i 笔成交的撤单编号为 "#<槽号>.<序号>"（36进制），序号由单调递增的
+ * 生成器分配，同一撮合的各笔成交序号连续。收到撤单回报时从编号直接
+ * 解析出槽号和成交下标，不需要按订单号查表。
+ *
+ * 每笔成交的撤单是否已回报、是否确认各记一位；重复或迟到的回报
+ * （槽已释放或被复用，序号对不上）被识别出来并丢弃。
+ * 例外是超时被记为被拒的撤单：最近 EXPIRED_HISTORY 笔的编号和对手方订单号
+ * 保留在环形缓冲区中，它们迟到的回报单独识别（LATE），由调用方对账。
+ * 超出该范围或恢复快照之前超时的，迟到回报仍按 STALE 丢弃。
+ *
+ * 槽连同其中的成交数组和位图在释放后留待复用，预热后撮合路径上不分配内存。
+ * 客户端自己的撤单编号若恰好符合上述格式会被当作本表的编号，
+ * 因此 '#' 开头的编号应保留给系统使用。
+ *
+ * 非线程安全。
+ */
+class PendingMatchTable {
+  public:
+    static constexpr char CANCEL_ID_PREFIX = '#';
+    // 保留的超时撤单数，首次超时时分配
+    static constexpr size_t EXPIRED_HISTORY = 4096;
+
+    struct Match {
+        Order activeOrder;                     // 主动方订单（新来的订单）
+        std::vector<OrderResponse> executions; // 本次撮合产生的所有成交
+        std::vector<uint64_t> answered;        // 第 i 位：第 i 笔撤单已回报
+        std::vector<uint64_t> confirmed;       // 第 i 位：第 i 笔撤单已确认
+        uint64_t firstCancelSeq = 0;           // 0 表示槽空闲
+        uint64_t timer = 0;                    // 超时定时器，0 表示没有
+        uint64_t acquiredNs = 0;               // 撮合时间（监控用），0 表示未记录
+        uint32_t remainingQty = 0;             // 撮合后未成交的剩余数量
+        uint32_t pendingCancelCount = 0;       // 还在等待多少个撤单回报
+
+        bool isConfirmed(size_t exec) const {
+            return confirmed[exec / 64] >> (exec % 64) & 1;
+        }
+    };
+
+    /**
+     * @brief 撤单回报的归属。
+     */
+    enum class Answer {
+        NOT_OURS, // 不是本表生成的撤单编号，按普通撤单回报处理
+        STALE,    // 本表的编号，但撮合已结束或已回报过，应丢弃
+        LATE,     // 已按超时记为被拒的撤单的首个回报，slot 为 expiredOrder 下标
+        PENDING,  // 已记录，还有撤单未回报
+        COMPLETE, // 已记录，所有撤单都已回报，可以结算
+    };
+
+    /**
+     * @brief 预分配槽位，应在开盘前调用。
+     */
+    void reserve(size_t matches);
+
+    /**
+     * @brief 设置撤单序号的起点和步长。
+     * 分片模式下各分片取不同起点、以分片数为步长，撤单编号互不重复。
+     */
+    void setCancelIdSequence(uint64_t first, uint64_t step);
+
+    /**
+     * @brief 登记一次内部撮合，返回槽号。会使之前 at() 返回的引用失效。
+     */
+    uint32_t acquire(const Order &activeOrder,
+                     std::span<const OrderResponse> executions,
+                     uint32_t remainingQty);
+
+    Match &at(uint32_t slot) { return slots_[slot]; }
+    const Match &at(uint32_t slot) const { return slots_[slot]; }
+
+    /**
+     * @brief 结算后释放槽位，之后该撮合的撤单回报都视为 STALE。
+     */
+    void release(uint32_t slot);
+
+    /**
+     * @brief 把还未回报的撤单都记为被拒，用于撤单回报超时。
+     * 之后它们的首个回报视为 LATE，再有重复的视为 STALE。
+     */
+    void expire(uint32_t slot);
+
+    /**
+     * @brief answer 返回 LATE 时，该撤单要撤的对手方订单号。
+     */
+    const ClOrderId &expiredOrder(uint32_t index) const {
+        return expired_[index].origClOrderId;
+    }
+
+    /**
+     * @brief 槽中第 exec 笔成交对应的撤单编号。
+     */
+    ClOrderId cancelId(uint32_t slot, size_t exec) const;
+    static ClOrderId makeCancelId(uint32_t slot, uint64_t seq);
+    /**
+     * @brief 解析本表格式的撤单编号，不是该格式时返回 false。
+     * 序号按 setCancelIdSequence 的起点和步长分配，可据此找到生成编号的分片。
+     */
+    static bool parseCancelId(const ClOrderId &cancelId, uint32_t &slot,
+                              uint64_t &seq);
+
+    /**
+     * @brief 记录一个撤单回报。
+     * @param cancelId 撤单回报中的 clOrderId
+     * @param slot 返回 PENDING/COMPLETE 时为所属槽号，
+     *             返回 LATE 时为 expiredOrder 的下标
+     */
+    Answer answer(const ClOrderId &cancelId, bool confirmed, uint32_t &slot);
+
+    size_t size() const { return slots_.size() - free_.size(); }
+    size_t capacity() const { return slots_.capacity(); }
+    /**
+     * @brief 占用的内存字节数，含各槽中成交和位图数组的容量。
+     */
+    size_t memoryBytes() const;
+
+    // 以下用于快照：槽的数量、空闲槽的复用顺序和撤单序号决定了
+    // 之后生成的撤单编号，恢复时须原样还原
+
+    size_t slotCount() const { return slots_.size(); }
+    std::span<const uint32_t> freeSlots() const { return free_; }
+    uint64_t nextCancelSeq() const { return nextCancelSeq_; }
+    uint64_t cancelSeqStep() const { return cancelSeqStep_; }
+
+    /**
+     * @brief 清空后建立 slotCount 个槽，其中 freeSlots 按原顺序为空闲槽。
+     * 其余槽由调用方通过 at() 填写。
+     */
+    void restoreSlots(size_t slotCount, std::span<const uint32_t> freeSlots);
+
+  private:
+    struct ExpiredCancel {
+        uint64_t seq = 0; // 0 表示空位或已回报
+        ClOrderId origClOrderId;
+    };
+
+    std::vector<Match> slots_;
+    std::vector<uint32_t> free_;
+    std::vector<ExpiredCancel> expired_; // 环形缓冲区
+    size_t expiredNext_ = 0;
+    uint64_t nextCancelSeq_ = 1;
+    uint64_t cancelSeqStep_ = 1;
+
+    // 在超时记录中查找并取走 seq，返回 LATE 或 STALE
+    Answer takeExpired(uint64_t seq, uint32_t &index);
+};
+
+} // namespace hdf
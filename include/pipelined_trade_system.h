@@ -0,0 +1,93 @@
+#pragma once
+
+#include "engine_config.h"
+#include "engine_messages.h"
+#include "spsc_ring.h"
+#include "trade_sink.h"
+#include "trade_system.h"
+#include <atomic>
+#include <string_view>
+#include <thread>
+
+namespace hdf {
+
+/**
+ * @brief 三段流水线模式的交易系统。
+ *
+ *   调用方线程（解析）──SPSC──> 核心线程（风控+撮合）──SPSC──> 输出线程（序列化）
+ *
+ * - 调用方线程：submit* 在调用方线程上完成文本解析和格式校验，
+ *   把结构化的订单/撤单/回报放入入站队列。格式错误的拒绝回报也经入站队列
+ *   交给核心线程转发，保证与其他回报的先后顺序不变。
+ * - 核心线程：独占一个 TradeSystem，按批取出入站消息执行风控和撮合，
+ *   产生的回报和发往交易所的指令放入出站队列。
+ * - 输出线程：按批取出出站消息，调用构造时传入的 ClientSink/ExchangeSink，
+ *   序列化（如 JsonLineClientSink）的开销由这个线程承担。
+ *
+ * 配置了 pendingCancelTimeoutNs 时，核心线程每批用 steady_clock 推进一次时间。
+ *
+ * 队列满时生产方自旋等待，形成反压。所有 submit* 必须由同一个线程调用。
+ * 输出顺序与单线程 TradeSystem 处理同样输入时完全一致。
+ */
+class PipelinedTradeSystem {
+  public:
+    static constexpr size_t DEFAULT_RING_CAPACITY = 1 << 16;
+    // 每批最多处理的消息数，限制单批占用时间
+    static constexpr size_t MAX_BATCH = 256;
+
+    /**
+     * @brief 构造并启动核心线程和输出线程。
+     * @param clientSink 客户端回报，在输出线程上调用，不可为空
+     * @param exchangeSink 交易所指令，在输出线程上调用；为空时是纯撮合系统
+     */
+    PipelinedTradeSystem(ClientSink &clientSink, ExchangeSink *exchangeSink,
+                         const EngineConfig &config = {},
+                         size_t ringCapacity = DEFAULT_RING_CAPACITY);
+    /**
+     * @brief 等价于 stop()。
+     */
+    ~PipelinedTradeSystem();
+
+    PipelinedTradeSystem(const PipelinedTradeSystem &) = delete;
+    PipelinedTradeSystem &operator=(const PipelinedTradeSystem &) = delete;
+
+    void submitOrder(const Order &order);
+    void submitCancel(const CancelOrder &cancel);
+    void submitResponse(const OrderResponse &response);
+    void submitResponse(const CancelResponse &response);
+    /**
+     * @brief 在调用方线程上解析 JSON 文本后提交，规则同 TradeSystem 的 *Raw 接口。
+     */
+    void submitOrderRaw(std::string_view input);
+    void submitCancelRaw(std::string_view input);
+
+    /**
+     * @brief 停止接收输入，等待已提交的消息全部处理并输出完毕后结束线程。
+     * 重复调用无副作用；之后不能再 submit。
+     */
+    void stop();
+
+  private:
+    ClientSink &clientSink_;
+    ExchangeSink *exchangeSink_;
+
+    SpscRing<InboundMessage> inbound_;
+    SpscRing<OutboundMessage> outbound_;
+    RingEgressSink egressSink_;
+    // 只在核心线程上访问
+    TradeSystem core_;
+    // 配置了撤单回报超时，核心线程每批推进一次时间
+    const bool timed_;
+
+    std::atomic<bool> inputClosed_{false};
+    std::atomic<bool> coreDone_{false};
+    bool stopped_ = false;
+
+    std::thread coreThread_;
+    std::thread egressThread_;
+
+    void coreLoop();
+    void egressLoop();
+};
+
+} // namespace hdf
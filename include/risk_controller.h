@@ -1,9 +1,11 @@
 #pragma once
 
+#include "engine_config.h"
+#include "object_pool.h"
+#include "symbol_table.h"
 #include "types.h"
-#include <string>
-#include <unordered_map>
-#include <vector>
+#include <array>
+#include <memory>
 
 namespace hdf {
 
@@ -14,9 +16,24 @@ class RiskController {
         CROSS_TRADE, // 检测到对敲风险
     };
 
+    /**
+     * @brief 使用自有的驻留表构造，适用于单独使用风控引擎的场景。
+     */
     RiskController();
+    /**
+     * @brief 与其他模块共享驻留表，订单中已填写的编号直接使用。
+     */
+    explicit RiskController(SymbolTable &symbols);
     ~RiskController();
 
+    RiskController(const RiskController &) = delete;
+    RiskController &operator=(const RiskController &) = delete;
+
+    /**
+     * @brief 按配置预分配订单信息和汇总桶，应在开盘前调用。
+     */
+    void reserve(const EngineConfig &config);
+
     /**
      * @brief 检查订单是否符合风控要求。
      *
@@ -29,6 +46,7 @@ class RiskController {
      * @brief 检查订单是否会导致对敲交易。
      *
      * 对敲条件：相同股东号 + 相同股票 + 相反方向 + 反方向订单有剩余数量
+     * 反方向的剩余数量由汇总计数维护，检查不需要遍历订单。
      *
      * @param order 要检查的订单。
      * @return true 检测到对敲，false 未检测到对敲
@@ -51,44 +69,113 @@ class RiskController {
      *
      * @param origClOrderId 原始订单的客户订单ID。
      */
-    void onOrderCanceled(const std::string &origClOrderId);
+    void onOrderCanceled(const ClOrderId &origClOrderId);
 
     /**
      * @brief 订单成交时的回调。
      *
-     * 更新订单的剩余数量，如果完全成交则后续不再参与对敲检测。
+     * 更新订单的剩余数量，如果完全成交则从内部索引中移除。
      *
      * @param clOrderId 客户订单ID。
      * @param execQty 成交数量。
      */
-    void onOrderExecuted(const std::string &clOrderId, uint32_t execQty);
+    void onOrderExecuted(const ClOrderId &clOrderId, uint32_t execQty);
+
+    /**
+     * @brief 活跃订单的记录，用于快照。
+     * 以 qty = remainingQty 构造订单调用 onOrderAccepted 即可恢复。
+     */
+    struct OrderEntry {
+        ClOrderId clOrderId;
+        ShareholderKey shareholderKey;
+        SecurityKey securityKey;
+        Side side;
+        Price price;
+        uint32_t remainingQty;
+    };
+
+    /**
+     * @brief 访问每笔活跃订单：visit(const OrderEntry &)，顺序不确定。
+     */
+    template <typename F> void forEachOrder(F &&visit) const;
+
+    size_t orderCount() const { return orderIndex_.size(); }
+    // 有活跃订单的 (股东, 股票) 桶数
+    size_t bucketCount() const { return activeOrders_.size(); }
+    /**
+     * @brief 占用的内存字节数：两个节点池和哈希表的桶数组。
+     */
+    size_t memoryBytes() const;
 
   private:
+    /**
+     * @brief 单边汇总。
+     *
+     * liveQty/liveCount 随订单的接受、撤销、成交同步增减，
+     * 对敲检测只需比较 liveQty，不需要遍历订单。
+     */
+    struct SideTotals {
+        uint64_t liveQty = 0;   // 剩余未成交数量合计
+        uint32_t liveCount = 0; // 活跃订单笔数
+    };
+
+    // 买卖方向 -> 单边汇总，下标为 sideIndex(side)
+    using BothSides = std::array<SideTotals, 2>;
+
     /**
      * @brief 订单信息结构体。
      *
-     * 存储订单的关键信息，用于对敲检测。
+     * 存储订单的关键信息，用于对敲检测。剩余数量归零即移除。
+     * totals 指向所属桶的单边汇总，哈希表元素地址在 rehash 后保持不变，
+     * 只要该桶还有活跃订单，该指针就一直有效。
      */
     struct OrderInfo {
-        std::string clOrderId;  // 客户订单ID
-        std::string securityId; // 股票代码
-        Side side;              // 买卖方向（BUY/SELL）
-        double price;           // 订单价格
-        uint32_t remainingQty;  // 剩余未成交数量
+        SideTotals *totals;    // 所属单边汇总
+        uint64_t bucketKey;    // 所属 (股东, 股票) 桶的键
+        Side side;             // 买卖方向（BUY/SELL）
+        Price price;           // 订单价格
+        uint32_t remainingQty; // 剩余未成交数量
     };
 
-    // 买卖方向 -> 订单列表的映射
-    using SideOrders = std::unordered_map<Side, std::vector<OrderInfo>>;
+    std::unique_ptr<SymbolTable> ownedSymbols_;
+    SymbolTable *symbols_;
+
+    // 以下内存池须先于对应哈希表构造、后于其析构
+    BlockPool bucketPool_;
+    BlockPool orderPool_;
 
-    // 股票代码 -> 买卖方订单的映射
-    using SecurityOrders = std::unordered_map<std::string, SideOrders>;
+    // 活跃订单汇总：(股东编号, 股票编号) -> 买卖方汇总
+    // 两个编号拼成一个64位整数键，对敲检测只需一次整数哈希查找。
+    PooledHashMap<uint64_t, BothSides> activeOrders_;
 
-    // 股东号 -> 股票订单的映射
-    using ShareholderOrders = std::unordered_map<std::string, SecurityOrders>;
+    // 订单索引：客户订单ID -> 订单信息，撤单和成交时 O(1) 定位。
+    // 订单信息存放在索引元素中，节点内存来自 orderPool_。
+    PooledHashMap<ClOrderId, OrderInfo> orderIndex_;
 
-    // 活跃订单的三层索引结构
-    // 结构：股东号 -> 股票代码 -> 买卖方向 -> 订单列表
-    ShareholderOrders activeOrders_;
+    /**
+     * @brief 移除订单，扣减汇总计数，买卖两边都变空时删除整个桶。
+     */
+    void removeOrder(PooledHashMap<ClOrderId, OrderInfo>::iterator it);
+
+    static size_t sideIndex(Side side) { return side == Side::BUY ? 0 : 1; }
+
+    static uint64_t makeBucketKey(ShareholderKey shareholder,
+                                  SecurityKey security) {
+        return (static_cast<uint64_t>(shareholder) << 32) | security;
+    }
 };
 
+template <typename F> void RiskController::forEachOrder(F &&visit) const {
+    for (const auto &[clOrderId, info] : orderIndex_) {
+        OrderEntry entry;
+        entry.clOrderId = clOrderId;
+        entry.shareholderKey = static_cast<ShareholderKey>(info.bucketKey >> 32);
+        entry.securityKey = static_cast<SecurityKey>(info.bucketKey);
+        entry.side = info.side;
+        entry.price = info.price;
+        entry.remainingQty = info.remainingQty;
+        visit(entry);
+    }
+}
+
 } // namespace hdf
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "engine_config.h"
+#include "engine_messages.h"
+#include "spsc_ring.h"
+#include "trade_sink.h"
+#include "trade_system.h"
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 按股票分片、多核并行撮合的交易系统。
+ *
+ *                 ┌─SPSC─> 分片0（风控+撮合）─SPSC─┐
+ *   调用方线程 ───┼─SPSC─> 分片1（风控+撮合）─SPSC─┼──> 合并线程 ──> sink
+ *   （解析+路由）  └─SPSC─> ...                  ──┘
+ *
+ * 对敲检查以（股东号, 股票）为键，撮合以股票为单位，所有状态都可按
+ * (market, securityId) 划分。每个分片独占一个 TradeSystem（各自的
+ * RiskController 和 MatchingEngine），订单和撤单按 (market, securityId)
+ * 的哈希路由到固定分片，同一股票的消息始终由同一个分片按提交顺序处理。
+ *
+ * 交易所回报同样按所带的 (market, securityId) 路由，不需要逐笔记录订单所在的分片。
+ * 内部撮合发出的撤单（PendingMatchTable 格式的编号）的回报由编号中的撤单序号
+ * 确定分片：各分片的序号以分片号+1为起点、以分片数为步长。
+ * 其余回报必须带股票，否则无法确定订单所在的分片，submitResponse 拒绝接收。
+ *
+ * 合并线程按全局提交顺序输出：调用方线程为每条消息把目标分片号写入路由队列，
+ * 合并线程依次取出分片号，转发该分片的输出直到遇到本条消息的结束标记。
+ * 因此输出顺序与单线程 TradeSystem 处理同样输入时一致（自然也满足每个客户端
+ * 的顺序），只有成交编号不同：各分片的成交编号交错分配，互不重复。
+ *
+ * 合并线程要求每条输出都归属于一条入站消息，因此分片不驱动撤单回报超时
+ * （pendingCancelTimeoutNs 不生效）。
+ *
+ * 所有 submit* 必须由同一个线程调用；sink 在合并线程上调用。
+ */
+class ShardedTradeSystem {
+  public:
+    static constexpr size_t DEFAULT_RING_CAPACITY = 1 << 16;
+    // 每批最多处理的消息数，限制单批占用时间
+    static constexpr size_t MAX_BATCH = 256;
+
+    /**
+     * @brief 构造并启动各分片线程和合并线程。
+     * @param shardCount 分片数，为0时按1处理
+     * @param clientSink 客户端回报，在合并线程上调用，不可为空
+     * @param exchangeSink 交易所指令，在合并线程上调用；为空时是纯撮合系统
+     * @param config 每个分片的预分配配置，各分片按 1/shardCount 取用；
+     *               shardIndex/shardCount 字段由本类填写
+     */
+    ShardedTradeSystem(size_t shardCount, ClientSink &clientSink,
+                       ExchangeSink *exchangeSink,
+                       const EngineConfig &config = {},
+                       size_t ringCapacity = DEFAULT_RING_CAPACITY);
+    /**
+     * @brief 等价于 stop()。
+     */
+    ~ShardedTradeSystem();
+
+    ShardedTradeSystem(const ShardedTradeSystem &) = delete;
+    ShardedTradeSystem &operator=(const ShardedTradeSystem &) = delete;
+
+    size_t shardCount() const { return shards_.size(); }
+    /**
+     * @brief 股票所在的分片号。
+     */
+    size_t shardOf(Market market, const SecurityId &securityId) const;
+
+    void submitOrder(const Order &order);
+    void submitCancel(const CancelOrder &cancel);
+    /**
+     * @brief 提交交易所回报，按所带的股票路由（见类注释）。
+     * @throws std::invalid_argument 回报不带 market/securityId，
+     *         且不是内部撮合撤单的回报；此时不提交
+     */
+    void submitResponse(const OrderResponse &response);
+    void submitResponse(const CancelResponse &response);
+    /**
+     * @brief 在调用方线程上解析 JSON 文本后提交，规则同 TradeSystem 的 *Raw 接口。
+     */
+    void submitOrderRaw(std::string_view input);
+    void submitCancelRaw(std::string_view input);
+
+    /**
+     * @brief 停止接收输入，等待已提交的消息全部处理并输出完毕后结束线程。
+     * 重复调用无副作用；之后不能再 submit。
+     */
+    void stop();
+
+  private:
+    struct Shard {
+        Shard(const EngineConfig &config, size_t ringCapacity,
+              bool toExchange);
+
+        SpscRing<InboundMessage> inbound;
+        SpscRing<OutboundMessage> outbound;
+        RingEgressSink egressSink;
+        // 只在分片线程上访问
+        TradeSystem core;
+        std::thread thread;
+    };
+
+    ClientSink &clientSink_;
+    ExchangeSink *exchangeSink_;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    // 调用方线程 -> 合并线程：每条入站消息的目标分片号，按提交顺序
+    SpscRing<uint32_t> routes_;
+
+    std::atomic<bool> inputClosed_{false};
+    bool stopped_ = false;
+
+    std::thread mergeThread_;
+
+    void submit(uint32_t shard, InboundMessage &&message);
+    uint32_t shardOfResponse(Market market,
+                             const SecurityId &securityId) const;
+    void shardLoop(Shard &shard);
+    void mergeLoop();
+    void forward(Shard &shard);
+};
+
+} // namespace hdf
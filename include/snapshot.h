@@ -0,0 +1,214 @@
+#pragma once
+
+#include "risk_controller.h"
+#include "types.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace hdf {
+
+struct TradeCore;
+
+/**
+ * 状态快照：驻留表、撮合簿、风控索引和前置模式的待定撮合。
+ *
+ * 快照是一块连续的二进制映像：定长文件头之后依次是各段的定长记录数组，
+ * 每段按8字节对齐，记录就是内存中的结构体本身（本机字节序）。
+ * 读取时整个文件只读映射到内存，各段直接按数组访问，不做文本解析；
+ * 只能由相同架构、相同版本的程序读取。
+ *
+ * 快照记录了生成时日志中最后一条记录的序号（见 journal.h）。
+ * 启动时先恢复最近的快照，再只重放日志中该序号之后的部分，
+ * 省去的是重放整个日志的时间：
+ * - 生成：SnapshotWriter 在处理线程上 fork 出子进程，由子进程在写时复制的
+ *   内存映像上遍历状态、写出文件。处理线程只暂停 fork 本身的时间，
+ *   与进程已映射的内存成正比（复制页表），10^6 笔挂单时在毫秒量级，
+ *   见 benchmarks 的 snapshot.writer；之后处理线程第一次写到某页时
+ *   还要付一次缺页复制。遍历状态本身（snapshot::capture）耗时与状态规模
+ *   成正比，10^6 笔挂单时在百毫秒量级（snapshot.capture），不占用处理线程；
+ * - 恢复：订单簿和风控索引是带指针的哈希结构，逐条记录重新入簿、登记，
+ *   不是整块内存拷贝，耗时与状态规模成正比。
+ */
+namespace snapshot {
+
+constexpr uint32_t MAGIC = 0x31534448; // "HDS1"
+constexpr uint32_t VERSION = 2;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t checksum; // 覆盖文件头之后的全部内容
+    uint32_t reserved;
+    uint64_t journalSequence;
+    uint64_t nowNs;
+    uint64_t nextExecId;
+    uint64_t execIdStep;
+    uint64_t nextCancelSeq;
+    uint64_t cancelSeqStep;
+    // 各段的记录数，段按以下顺序排列
+    uint64_t securityCount;
+    uint64_t shareholderCount;
+    uint64_t bookOrderCount;
+    uint64_t riskOrderCount;
+    uint64_t pendingSlotCount; // 待定撮合表的槽数（含空闲槽）
+    uint64_t freeSlotCount;
+    uint64_t pendingMatchCount;
+    uint64_t pendingExecCount;
+};
+
+// 股票编号 -> (市场, 股票代码)，下标即编号
+struct SecurityRecord {
+    SecurityId securityId;
+    Market market;
+};
+
+// 股东编号 -> 股东号，下标即编号
+using ShareholderRecord = ShareholderId;
+
+// 挂单，按 MatchingEngine::forEachOrder 的顺序排列
+struct BookOrderRecord {
+    Order order;
+    uint32_t origQty;
+};
+
+using RiskOrderRecord = RiskController::OrderEntry;
+
+// 空闲槽按复用顺序排列
+using FreeSlotRecord = uint32_t;
+
+// 待定撮合，其成交依次存放在成交段中
+struct PendingMatchRecord {
+    Order activeOrder;
+    uint64_t firstCancelSeq;
+    uint64_t deadlineNs; // 撤单回报超时时刻，0 表示没有
+    uint64_t acquiredNs; // 原进程的监控时钟，0 表示未记录
+    uint32_t slot;
+    uint32_t remainingQty;
+    uint32_t pendingCancelCount;
+    uint32_t execCount;
+};
+
+struct PendingExecRecord {
+    ClOrderId clOrderId;
+    ExecId execId;
+    SecurityId securityId;
+    ShareholderId shareholderId;
+    Price price;
+    Price execPrice;
+    uint32_t qty;
+    uint32_t execQty;
+    Market market;
+    Side side;
+    bool answered;
+    bool confirmed;
+};
+
+static_assert(std::is_trivially_copyable_v<BookOrderRecord>);
+static_assert(std::is_trivially_copyable_v<RiskOrderRecord>);
+static_assert(std::is_trivially_copyable_v<PendingMatchRecord>);
+static_assert(std::is_trivially_copyable_v<PendingExecRecord>);
+
+/**
+ * @brief 把状态写成快照映像，复用 image 的容量。
+ * 遍历全部状态，耗时与活跃订单数成正比，不做系统调用。
+ * 直接在处理线程上调用时期间撮合暂停；SnapshotWriter 在子进程中调用。
+ */
+void capture(const TradeCore &core, uint64_t journalSequence,
+             std::vector<uint8_t> &image);
+
+} // namespace snapshot
+
+/**
+ * @brief 快照读取器，把文件只读映射到内存。
+ */
+class SnapshotReader {
+  public:
+    /**
+     * @throws std::system_error 打开或映射文件失败
+     * @throws std::runtime_error 文件不是快照、长度不符或校验失败
+     */
+    explicit SnapshotReader(const std::string &path);
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+    const snapshot::Header &header() const { return *header_; }
+    uint64_t journalSequence() const { return header_->journalSequence; }
+
+    /**
+     * @brief 把快照恢复到刚构造、还没处理过消息的 TradeCore。
+     * 挂单按原来的价格时间顺序入簿，待定撮合还原到原来的槽，
+     * 之后生成的成交编号和撤单编号与生成快照的系统一致。
+     * @throws std::logic_error core 已有状态
+     */
+    void restore(TradeCore &core) const;
+
+  private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    const snapshot::Header *header_ = nullptr;
+};
+
+/**
+ * @brief 以写时复制子进程生成快照的写入器（仅 POSIX）。
+ *
+ * capture 在处理线程上 fork，子进程看到的是 fork 时刻的状态：它生成映像、
+ * 写到临时文件、刷盘后改名为目标文件，然后退出；处理线程 fork 返回后
+ * 立即继续撮合（暂停时长见上文）。后台线程回收子进程并记录结果。
+ * 同一时刻最多一个子进程；子进程期间内存占用最多翻倍（被改写的页）。
+ * 进程不能把 SIGCHLD 设为 SIG_IGN，否则子进程的退出状态无法回收。
+ */
+class SnapshotWriter {
+  public:
+    explicit SnapshotWriter(std::string path);
+    /**
+     * @brief 等待已交出的快照写完。
+     */
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter &) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+    /**
+     * @brief fork 子进程写出当前状态。
+     * @return 上一个快照的子进程还没结束时返回 false，本次跳过
+     * @throws std::system_error fork 失败，或之前的快照写入失败
+     */
+    bool capture(const TradeCore &core, uint64_t journalSequence);
+
+    /**
+     * @brief 等待所有交出的快照写完。
+     * @throws std::system_error 快照写入失败
+     */
+    void wait();
+
+    // 最近一个写完的快照对应的日志序号，还没有写完的快照时为0
+    uint64_t writtenSequence();
+
+  private:
+    std::string path_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    pid_t child_ = 0; // 正在写快照的子进程，0 表示没有
+    uint64_t childSequence_ = 0;
+    bool stop_ = false;
+    uint64_t writtenSequence_ = 0;
+    std::exception_ptr error_;
+    std::thread thread_;
+
+    void run();
+    static void persist(const std::string &path,
+                        const std::vector<uint8_t> &image);
+};
+
+} // namespace hdf
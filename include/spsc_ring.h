@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace hdf {
+
+// 缓存行大小，用于隔开生产者和消费者各自写入的字段，避免伪共享
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief 有界无锁单生产者单消费者环形队列。
+ *
+ * 容量向上取整为2的幂，下标用掩码取模。生产者和消费者各自缓存
+ * 对方的位置，只有缓存显示队列满（空）时才读取对方的原子变量，
+ * 减少跨核缓存行传递。
+ *
+ * 消费端按批取出：popBatch 就地处理一批元素后只发布一次读位置，
+ * 一批元素只产生一次跨核同步。
+ *
+ * 元素槽在构造时全部默认构造，出队后不析构而是在下次入队时被赋值覆盖。
+ *
+ * 只能由一个线程调用 tryPush/push，另一个线程调用 popBatch。
+ */
+template <typename T> class SpscRing {
+  public:
+    explicit SpscRing(size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+          slots_(std::make_unique<T[]>(mask_ + 1)) {}
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    /**
+     * @brief 入队，队列满时返回 false。仅生产者调用。
+     */
+    template <typename U> bool tryPush(U &&value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 入队，队列满时自旋等待消费者腾出空间。仅生产者调用。
+     */
+    template <typename U> void push(U &&value);
+
+    /**
+     * @brief 取出至多 maxBatch 个元素，依次调用 consume(T &)。仅消费者调用。
+     * @return 本批处理的元素个数，队列为空时为0
+     */
+    template <typename F> size_t popBatch(F &&consume, size_t maxBatch) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (cachedTail_ == head) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (cachedTail_ == head) {
+                return 0;
+            }
+        }
+        size_t count = cachedTail_ - head;
+        if (count > maxBatch) {
+            count = maxBatch;
+        }
+        for (size_t i = 0; i < count; i++) {
+            consume(slots_[(head + i) & mask_]);
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief 与 popBatch 相同，但 consume(T &) 返回 true 时处理完该元素即停止，
+     * 其后的元素留在队列中。
+     */
+    template <typename F> size_t popUntil(F &&consume, size_t maxBatch) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (cachedTail_ == head) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (cachedTail_ == head) {
+                return 0;
+            }
+        }
+        size_t available = cachedTail_ - head;
+        if (available > maxBatch) {
+            available = maxBatch;
+        }
+        size_t count = 0;
+        while (count < available) {
+            if (consume(slots_[(head + count++) & mask_])) {
+                break;
+            }
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief 队列是否为空。只在对方线程静止时结果才准确。
+     */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+  private:
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // 消费者写入
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+    // 生产者写入
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+};
+
+/**
+ * @brief 忙等待策略：先自旋，一段时间仍无进展后让出CPU。
+ */
+class SpinWait {
+  public:
+    void wait() {
+        if (spins_ < SPIN_LIMIT) {
+            spins_++;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset() { spins_ = 0; }
+
+  private:
+    static constexpr unsigned SPIN_LIMIT = 1024;
+    unsigned spins_ = 0;
+};
+
+template <typename T>
+template <typename U>
+void SpscRing<T>::push(U &&value) {
+    SpinWait spin;
+    while (!tryPush(std::forward<U>(value))) {
+        spin.wait();
+    }
+}
+
+} // namespace hdf
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 标识符驻留表。
+ *
+ * 在入口处把 (市场, 股票代码) 和股东号各分配一个从0开始的稠密整数编号，
+ * 之后撮合引擎和风控引擎都用编号作为数组下标或整数哈希键，
+ * 不再反复对字符串做哈希。编号一经分配不会回收或改变。
+ */
+class SymbolTable {
+  public:
+    SymbolTable();
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    /**
+     * @brief 获取股票编号，首次出现时分配新编号。
+     */
+    SecurityKey internSecurity(Market market, const SecurityId &securityId);
+
+    /**
+     * @brief 获取股东编号，首次出现时分配新编号。
+     */
+    ShareholderKey internShareholder(const ShareholderId &shareholderId);
+
+    /**
+     * @brief 查找股票编号，不存在时返回 INVALID_KEY，不会分配新编号。
+     */
+    SecurityKey findSecurity(Market market, const SecurityId &securityId) const;
+
+    /**
+     * @brief 查找股东编号，不存在时返回 INVALID_KEY，不会分配新编号。
+     */
+    ShareholderKey findShareholder(const ShareholderId &shareholderId) const;
+
+    /**
+     * @brief 为订单填写 securityKey 和 shareholderKey。
+     */
+    void intern(Order &order);
+
+    /**
+     * @brief 按编号反查，编号须已分配。
+     */
+    Market marketOf(SecurityKey key) const { return securities_[key].market; }
+    const SecurityId &securityIdOf(SecurityKey key) const {
+        return securities_[key].securityId;
+    }
+    const ShareholderId &shareholderIdOf(ShareholderKey key) const {
+        return shareholders_[key];
+    }
+
+    size_t securityCount() const { return securities_.size(); }
+    size_t shareholderCount() const { return shareholders_.size(); }
+    /**
+     * @brief 占用的内存字节数（估算），哈希表节点按元素加两个指针计。
+     */
+    size_t memoryBytes() const;
+
+  private:
+    struct SecurityName {
+        Market market;
+        SecurityId securityId;
+
+        bool operator==(const SecurityName &) const = default;
+    };
+
+    struct SecurityNameHash {
+        size_t operator()(const SecurityName &name) const {
+            return name.securityId.hash() ^
+                   (static_cast<size_t>(name.market) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    std::unordered_map<SecurityName, SecurityKey, SecurityNameHash>
+        securityKeys_;
+    std::vector<SecurityName> securities_; // 编号 -> 股票
+    std::unordered_map<ShareholderId, ShareholderKey> shareholderKeys_;
+    std::vector<ShareholderId> shareholders_; // 编号 -> 股东号
+};
+
+} // namespace hdf
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hdf {
+
+/**
+ * @brief 分层时间轮，用于撤单回报超时、订单有效期等定时器。
+ *
+ * 时间由调用方提供（纳秒，单调递增），按 tickNs 量化为刻度。
+ * 共 LEVELS 层，每层 SLOTS 个槽：第0层每槽一个刻度，第 k 层每槽覆盖
+ * SLOTS^k 个刻度。定时器按剩余刻度数放入对应层的槽中，时间走到该槽时
+ * 整槽下放到低一层，到第0层时到期。添加、取消都是 O(1)，
+ * 每个刻度的推进也是 O(1)（不计到期和下放的定时器本身）；
+ * 没有定时器的层整段跳过，长时间无定时器时推进时间不逐刻遍历。
+ *
+ * 超出最高层范围的定时器先放在最高层，下放时重新计算位置。
+ * 到期时刻向上取整到刻度，定时器不会提前触发，最多推迟一个刻度。
+ *
+ * 定时器节点存放在数组中，释放后复用，预分配后不再分配内存。
+ * 非线程安全。
+ */
+class TimerWheel {
+  public:
+    // 定时器句柄，0 表示无效
+    using TimerId = uint64_t;
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    static constexpr size_t LEVEL_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << LEVEL_BITS;
+    static constexpr size_t LEVELS = 4;
+
+    /**
+     * @param tickNs 刻度长度（纳秒），为0时按1处理
+     */
+    explicit TimerWheel(uint64_t tickNs);
+
+    /**
+     * @brief 预分配定时器节点。
+     */
+    void reserve(size_t timers);
+
+    /**
+     * @brief 添加一个在 deadlineNs 到期的定时器，到期时把 data 交给回调。
+     * 已过期的时刻在下一个刻度触发。
+     */
+    TimerId schedule(uint64_t deadlineNs, uint64_t data);
+
+    /**
+     * @brief 取消定时器。定时器已到期或已取消时返回 false。
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief 定时器的到期时刻（已取整到刻度），定时器无效时返回0。
+     */
+    uint64_t deadlineNs(TimerId id) const;
+
+    /**
+     * @brief 把时间推进到 nowNs，对每个到期的定时器调用 onExpire(data)。
+     * 回调中可以添加或取消其他定时器。时间倒退时不做任何事。
+     * @return 到期的定时器个数
+     */
+    template <typename F> size_t advance(uint64_t nowNs, F &&onExpire);
+
+    size_t size() const { return size_; }
+    uint64_t tickNs() const { return tickNs_; }
+
+  private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct Node {
+        uint64_t deadline = 0; // 到期刻度
+        uint64_t data = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t generation = 0; // 每次释放加一，使旧句柄失效
+        uint16_t bucket = 0;     // 所在槽：层号 * SLOTS + 槽号
+        bool active = false;
+    };
+
+    uint64_t tickNs_;
+    uint64_t now_ = 0; // 当前刻度
+    size_t size_ = 0;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> freeNodes_;
+    std::array<uint32_t, LEVELS * SLOTS> heads_;
+    std::array<size_t, LEVELS> levelCounts_{};
+
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(size_t level);
+    // 把时间推进到下一个需要处理的刻度（不超过 target），处理下放
+    void step(uint64_t target);
+};
+
+template <typename F> size_t TimerWheel::advance(uint64_t nowNs, F &&onExpire) {
+    uint64_t target = nowNs / tickNs_;
+    size_t expired = 0;
+    while (now_ < target) {
+        step(target);
+        uint32_t &head = heads_[now_ & (SLOTS - 1)];
+        while (head != NIL) {
+            uint32_t index = head;
+            uint64_t data = nodes_[index].data;
+            unlink(index);
+            release(index);
+            expired++;
+            onExpire(data);
+        }
+    }
+    return expired;
+}
+
+} // namespace hdf
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "types.h"
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <utility>
+
+namespace hdf {
+
+/**
+ * @brief 发往客户端的回报接口，图中op4。
+ *
+ * 直接接收结构化的回报，由实现方决定何时、以何种格式序列化；
+ * 撮合路径上不构造任何 JSON 对象。
+ */
+class ClientSink {
+  public:
+    virtual ~ClientSink() = default;
+
+    // 订单确认、订单拒绝和成交回报
+    virtual void onOrderResponse(const OrderResponse &response) = 0;
+    // 撤单确认和撤单拒绝回报
+    virtual void onCancelResponse(const CancelResponse &response) = 0;
+};
+
+/**
+ * @brief 发往交易所的指令接口，图中op2。
+ */
+class ExchangeSink {
+  public:
+    virtual ~ExchangeSink() = default;
+
+    virtual void onOrder(const Order &order) = 0;
+    virtual void onCancel(const CancelOrder &cancel) = 0;
+};
+
+// 以下是 JSON 适配器：把结构化回报转换为 JSON 后交给回调函数，
+// 供仍使用 JSON 接口的调用方使用。JSON 只在这里构造。
+
+class JsonClientSink : public ClientSink {
+  public:
+    using Callback = std::function<void(const nlohmann::json &)>;
+
+    explicit JsonClientSink(Callback callback)
+        : callback_(std::move(callback)) {}
+
+    void onOrderResponse(const OrderResponse &response) override {
+        callback_(nlohmann::json(response));
+    }
+    void onCancelResponse(const CancelResponse &response) override {
+        callback_(nlohmann::json(response));
+    }
+
+  private:
+    Callback callback_;
+};
+
+class JsonExchangeSink : public ExchangeSink {
+  public:
+    using Callback = std::function<void(const nlohmann::json &)>;
+
+    explicit JsonExchangeSink(Callback callback)
+        : callback_(std::move(callback)) {}
+
+    void onOrder(const Order &order) override {
+        callback_(nlohmann::json(order));
+    }
+    void onCancel(const CancelOrder &cancel) override {
+        callback_(nlohmann::json(cancel));
+    }
+
+  private:
+    Callback callback_;
+};
+
+} // namespace hdf
@@ -1,15 +1,20 @@
 #pragma once
 
-#include "matching_engine.h"
-#include "risk_controller.h"
+#include "basic_trade_system.h"
+#include "engine_config.h"
+#include "trade_sink.h"
 #include <functional>
+#include <memory>
 #include <nlohmann/json.hpp>
-#include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <span>
+#include <string_view>
 
 namespace hdf {
 
+class JournalWriter;
+class SnapshotReader;
+class SnapshotWriter;
+
 /** 交易指令流转流程：
  *
  * ┌──────────┐   op1:订单/撤单   ┌──────────┐   op2:订单/撤单    ┌──────────┐
@@ -18,77 +23,160 @@ namespace hdf {
  *      ↑                           │   ↑                            │
  *      │                           │   │                            │
  *      └───────── op4: 回报 ────────┘   └───────── op3: 回报 ────────┘
+ *
+ * 运行时按是否设置了交易所接口选择模式，sink 经虚函数调用，
+ * 处理逻辑与 BasicTradeSystem 共用（TradeLogic<Mode, ClientSink, ExchangeSink>）。
+ * 模式和 sink 在编译期已知时使用 BasicTradeSystem。
  **/
 class TradeSystem {
   public:
     TradeSystem();
+    /**
+     * @brief 按配置预分配各模块的对象池和哈希表。
+     */
+    explicit TradeSystem(const EngineConfig &config);
     ~TradeSystem();
 
     using SendToClient = std::function<void(const nlohmann::json &)>;
     using SendToExchange = std::function<void(const nlohmann::json &)>;
 
     /**
-     * @brief 设置与客户端的交互接口，图中op4
+     * @brief 设置与客户端的交互接口，图中op4。
+     * 回报经 JsonClientSink 转换为 JSON 后交给回调函数。
      */
     void setSendToClient(SendToClient callback);
     /**
-     * @brief 设置与交易所的交互接口，图中op2
+     * @brief 设置与交易所的交互接口，图中op2。
+     * 指令经 JsonExchangeSink 转换为 JSON 后交给回调函数。
      */
     void setSendToExchange(SendToExchange callback);
 
+    /**
+     * @brief 设置结构化的客户端回报接口，图中op4。
+     * 不转移所有权，sink 须在系统析构前保持有效；传入 nullptr 表示不输出。
+     */
+    void setClientSink(ClientSink *sink);
+    /**
+     * @brief 设置结构化的交易所指令接口，图中op2。
+     * 不转移所有权；传入 nullptr 表示系统为纯撮合系统。
+     */
+    void setExchangeSink(ExchangeSink *sink);
+
+    /**
+     * @brief 设置预写日志（见 journal.h）。
+     * 之后每条订单、撤单和交易所回报在处理前追加到日志；前置模式下配置了
+     * pendingCancelTimeoutNs 时 advanceTime 的时间也写入日志。
+     * 格式错误、在解析阶段就被拒绝的指令不改变系统状态，不写日志。
+     * 日志按 JournalOptions 自动分组提交，调用方也可以在每批消息处理完、
+     * 发出回报之前调用 JournalWriter::commit()。
+     * 不转移所有权；传入 nullptr 表示不写日志。
+     */
+    void setJournal(JournalWriter *journal);
+
+    /**
+     * @brief 由快照写入器 fork 子进程写出当前状态，
+     * 应在处理线程上两条消息之间调用，只暂停 fork 的时间（见 snapshot.h）。
+     * 设置了日志时先提交日志，快照记录日志中最后一条记录的序号。
+     * @return 上一个快照的子进程还没结束时返回 false，本次跳过
+     */
+    bool takeSnapshot(SnapshotWriter &writer);
+    /**
+     * @brief 从快照恢复状态，须在处理任何消息之前调用。
+     * 之后用 JournalReader::replay(system, 返回值) 重放日志的剩余部分。
+     * @return 快照对应的日志序号
+     * @throws std::logic_error 系统已经处理过消息
+     */
+    uint64_t restoreSnapshot(const SnapshotReader &reader);
+
     /**
      * @brief 处理来自客户端的订单指令，图中op1
      */
     void handleOrder(const nlohmann::json &input);
+    void handleOrder(const Order &order);
+    /**
+     * @brief 直接从 JSON 文本处理订单指令，不构造 DOM。
+     * 校验规则和拒绝回报与 JSON 接口相同。
+     */
+    void handleOrderRaw(std::string_view input);
     /**
      * @brief 处理来自客户端的撤单指令，图中op1
      */
     void handleCancel(const nlohmann::json &input);
+    void handleCancel(const CancelOrder &cancel);
+    void handleCancelRaw(std::string_view input);
     void handleMarketData(const nlohmann::json &input);
     /**
      * @brief 处理来自交易所的回报，图中op3
      */
     void handleResponse(const nlohmann::json &input);
+    void handleResponse(const OrderResponse &response);
+    void handleResponse(const CancelResponse &response);
+
+    /**
+     * @brief 推进系统时间（纳秒，单调递增，如 steady_clock），由调用方的主循环驱动。
+     * 前置模式下配置了 pendingCancelTimeoutNs 时，等待撤单回报超时的内部撮合
+     * 按未回报的撤单被拒处理并结算。之后迟到的撤单拒绝被丢弃；迟到的撤单确认
+     * 说明对手方订单其实已在交易所撤销，将其移出内部簿和风控，
+     * 并把撤单确认（origClOrderId 为对手方订单）转发给客户端。
+     * 新的内部撮合以最近一次提供的时间计算超时。
+     */
+    void advanceTime(uint64_t nowNs);
+
+    /**
+     * @brief 处理一条二进制协议消息（见 wire_protocol.h），
+     * 按模板分发到订单、撤单或回报处理，未知模板忽略。
+     * 订单和撤单字段非法时生成与 JSON 接口相同的拒绝回报。
+     *
+     * @param message 一条完整消息，可用 wire::decodeHeader 分帧
+     * @throws std::invalid_argument 消息头非法或消息不完整
+     */
+    void handleWire(std::span<const uint8_t> message);
+
+    /**
+     * @brief 各消息类型、各处理阶段的耗时直方图（见 latency_stats.h），
+     * 可用 format() 输出分位数，reset() 清零。构建时未定义
+     * HDF_LATENCY_STATS 则不记录。须在处理线程上读取。
+     */
+    LatencyStats &latencyStats() { return core_.latency; }
+
+    /**
+     * @brief 设置运行指标登记表（见 engine_metrics.h）。
+     * 之后每条消息和每个拒绝回报计入其中。不转移所有权；传入 nullptr 表示不统计。
+     */
+    void setMetrics(EngineMetrics *metrics);
+    /**
+     * @brief 采样挂单深度、待定撮合、内存占用等状态量写入登记表，
+     * 应在处理线程上两条消息之间调用，其他线程随时可以读取登记表。
+     */
+    void publishMetrics();
 
   private:
-    RiskController riskController_;
-    MatchingEngine matchingEngine_;
+    using ExchangeLogic =
+        detail::TradeLogic<TradeMode::EXCHANGE, ClientSink, ExchangeSink>;
+    using PreExchangeLogic =
+        detail::TradeLogic<TradeMode::PRE_EXCHANGE, ClientSink, ExchangeSink>;
+
+    TradeCore core_;
 
     // 以下是系统与客户端和交易所交互的接口，系统可以根据是否设置了
-    // sendToExchange_来判断自己是交易所前置还是纯撮合系统。
-    SendToClient sendToClient_;
-    SendToExchange sendToExchange_;
+    // exchangeSink_来判断自己是交易所前置还是纯撮合系统。
+    // 未设置客户端接口时 clientSink_ 指向 nullClientSink_，不会为空。
+    NullClientSink nullClientSink_;
+    ClientSink *clientSink_;
+    ExchangeSink *exchangeSink_ = nullptr;
+    JournalWriter *journal_ = nullptr;
+    // 通过 setSendToClient/setSendToExchange 安装的 JSON 适配器
+    std::unique_ptr<JsonClientSink> jsonClientSink_;
+    std::unique_ptr<JsonExchangeSink> jsonExchangeSink_;
 
     /**
-     * 前置模式下内部撮合成功后，需要先向交易所发送撤单请求，
-     * 等待交易所返回所有撤单确认后才能向客户端发送成交回报。
-     *
-     * 一个主动方订单可能匹配多个对手方订单，要等所有对手方的
-     * 撤单回报都回来后，才能确定最终成交结果：
-     * - 撤单确认的部分 → 成交生效，发成交回报
-     * - 撤单被拒的部分 → 对手方已在交易所被他人成交，该部分作废
-     * - 若有作废部分未成交的量，需重新转发给交易所
-     */
-    struct PendingMatch {
-        Order activeOrder;                     // 主动方订单（新来的订单）
-        nlohmann::json activeOrderRawInput;    // 主动方原始JSON（转发用）
-        std::vector<OrderResponse> executions; // 本次撮合产生的所有成交
-        uint32_t remainingQty = 0;             // 撮合后未成交的剩余数量
-        size_t pendingCancelCount = 0;         // 还在等待多少个撤单回报
-        std::unordered_set<std::string>
-            confirmedIds;                            // 已确认撤回的对手方订单ID
-        std::unordered_set<std::string> rejectedIds; // 撤单被拒的对手方订单ID
-    };
-
-    // key: 主动方订单的 clOrderId
-    std::unordered_map<std::string, PendingMatch> pendingMatches_;
-    // 反向映射: 对手方订单ID → 主动方订单ID，用于收到撤单回报时查找归属
-    std::unordered_map<std::string, std::string> cancelToActiveOrder_;
-
-    /**
-     * @brief 所有撤单回报都回来后，处理最终结果
-     */
-    void resolvePendingMatch(const std::string &activeOrderId);
+     * @brief 向客户端发送格式错误的订单/撤单拒绝回报
+     */
+    void rejectInvalidOrder(const ClOrderId &clOrderId,
+                            std::string_view reason);
+    void rejectInvalidCancel(const ClOrderId &clOrderId,
+                             const ClOrderId &origClOrderId,
+                             std::string_view reason);
 };
 
 } // namespace hdf
@@ -1,12 +1,60 @@
 #pragma once
 
+#include "fixed_string.h"
+#include <cmath>
+#include <compare>
 #include <cstdint>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <ostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace hdf {
 
+/**
+ * @brief 定点价格，内部为以 1/10000 元为单位的 int64。
+ *
+ * JSON 中的小数价格只在 from_json 时转换一次，输出回报时再还原为小数；
+ * 撮合和风控全程使用整数比较，价格可以直接换算为订单簿档位下标。
+ */
+class Price {
+  public:
+    static constexpr int64_t SCALE = 10000; // 1元对应的内部单位数
+    static constexpr int64_t TICK = 100;    // 最小变动价位0.01元
+    static constexpr int64_t MAX_RAW = 100000 * SCALE; // 订单价格上限100000元
+
+    constexpr Price() = default;
+
+    static constexpr Price fromRaw(int64_t raw) { return Price(raw); }
+    static Price fromDouble(double yuan) {
+        return Price(std::llround(yuan * SCALE));
+    }
+
+    constexpr int64_t raw() const { return raw_; }
+    double toDouble() const { return static_cast<double>(raw_) / SCALE; }
+    // 以最小变动价位为单位的档位编号
+    constexpr int64_t ticks() const { return raw_ / TICK; }
+
+    constexpr auto operator<=>(const Price &) const = default;
+
+  private:
+    explicit constexpr Price(int64_t raw) : raw_(raw) {}
+
+    int64_t raw_ = 0;
+};
+
+inline void to_json(nlohmann::json &j, const Price &p) { j = p.toDouble(); }
+
+inline void from_json(const nlohmann::json &j, Price &p) {
+    p = Price::fromDouble(j.get<double>());
+}
+
+inline std::ostream &operator<<(std::ostream &os, const Price &p) {
+    return os << p.toDouble();
+}
+
 enum class Side { BUY, SELL, UNKNOWN };
 
 inline std::string to_string(Side s) {
@@ -21,11 +69,18 @@ inline std::string to_string(Side s) {
     }
 }
 
-inline Side side_from_string(const std::string &s) {
+// 不抛异常的解析，无法识别时返回 nullopt
+inline std::optional<Side> parse_side(std::string_view s) {
     if (s == "B")
         return Side::BUY;
     if (s == "S")
         return Side::SELL;
+    return std::nullopt;
+}
+
+inline Side side_from_string(const std::string &s) {
+    if (auto side = parse_side(s))
+        return *side;
     throw std::invalid_argument("Invalid side: " + s);
 }
 
@@ -45,110 +100,168 @@ inline std::string to_string(Market m) {
     }
 }
 
-inline Market market_from_string(const std::string &s) {
+inline std::optional<Market> parse_market(std::string_view s) {
     if (s == "XSHG")
         return Market::XSHG;
     if (s == "XSHE")
         return Market::XSHE;
     if (s == "BJSE")
         return Market::BJSE;
+    return std::nullopt;
+}
+
+inline Market market_from_string(const std::string &s) {
+    if (auto market = parse_market(s))
+        return *market;
     throw std::invalid_argument("Invalid market: " + s);
 }
 
+// 协议标识符，容量覆盖协议规定的最大长度
+using ClOrderId = FixedString<23>;     // 客户订单编号（通常17位）
+using SecurityId = FixedString<7>;     // 股票代码（6位）
+using ShareholderId = FixedString<15>; // 股东号（通常10-11位）
+using ExecId = FixedString<23>;        // 成交编号
+
+// 由 SymbolTable 分配的稠密整数编号
+using SecurityKey = uint32_t;    // (市场, 股票代码) 的编号
+using ShareholderKey = uint32_t; // 股东号的编号
+constexpr uint32_t INVALID_KEY = UINT32_MAX;
+
 // 3.1 交易订单
 struct Order {
-    std::string clOrderId;
+    ClOrderId clOrderId;
     Market market;
-    std::string securityId;
+    SecurityId securityId;
     Side side;
-    double price;
+    Price price;
     uint32_t qty;
-    std::string shareholderId;
+    ShareholderId shareholderId;
+
+    // 内部字段：入口处由 SymbolTable::intern 填写，不参与 JSON 解析。
+    // 未填写时撮合和风控引擎会自行查表。
+    SecurityKey securityKey = INVALID_KEY;
+    ShareholderKey shareholderKey = INVALID_KEY;
 };
 
+/**
+ * @brief 校验订单字段取值，JSON 解析和原始文本解析共用。
+ * @return 合法时返回 nullptr，否则返回错误描述（静态字符串）
+ */
+inline const char *validateOrder(const Order &o) {
+    if (o.price.raw() <= 0) {
+        return "price must be positive";
+    }
+    if (o.price.raw() % Price::TICK != 0) {
+        return "price must be a multiple of 0.01";
+    }
+    if (o.price.raw() > Price::MAX_RAW) {
+        return "price must not exceed 100000.00";
+    }
+    if (o.qty == 0) {
+        return "qty must be positive";
+    }
+    if (o.side == Side::BUY && o.qty % 100 != 0) {
+        return "buy qty must be a multiple of 100";
+    }
+    return nullptr;
+}
+
 inline void from_json(const nlohmann::json &j, Order &o) {
     j.at("clOrderId").get_to(o.clOrderId);
-    o.market = market_from_string(j.at("market").get<std::string>());
+    o.market = market_from_string(j.at("market").get_ref<const std::string &>());
     j.at("securityId").get_to(o.securityId);
-    o.side = side_from_string(j.at("side").get<std::string>());
+    o.side = side_from_string(j.at("side").get_ref<const std::string &>());
     j.at("price").get_to(o.price);
     j.at("qty").get_to(o.qty);
     j.at("shareholderId").get_to(o.shareholderId);
 
-    if (o.price <= 0) {
-        throw std::invalid_argument("price must be positive, got: " +
-                                    std::to_string(o.price));
-    }
-    if (o.qty == 0) {
-        throw std::invalid_argument("qty must be positive");
-    }
-    if (o.side == Side::BUY && o.qty % 100 != 0) {
-        throw std::invalid_argument("buy qty must be a multiple of 100, got: " +
-                                    std::to_string(o.qty));
+    if (const char *error = validateOrder(o)) {
+        throw std::invalid_argument(error);
     }
 }
 
+inline void to_json(nlohmann::json &j, const Order &o) {
+    j = nlohmann::json{{"clOrderId", o.clOrderId},
+                       {"market", to_string(o.market)},
+                       {"securityId", o.securityId},
+                       {"side", to_string(o.side)},
+                       {"price", o.price},
+                       {"qty", o.qty},
+                       {"shareholderId", o.shareholderId}};
+}
+
 // 3.2 交易撤单
 struct CancelOrder {
-    std::string clOrderId;
-    std::string origClOrderId;
+    ClOrderId clOrderId;
+    ClOrderId origClOrderId;
     Market market;
-    std::string securityId;
-    std::string shareholderId;
+    SecurityId securityId;
+    ShareholderId shareholderId;
     Side side;
 };
 
 inline void from_json(const nlohmann::json &j, CancelOrder &o) {
     j.at("clOrderId").get_to(o.clOrderId);
     j.at("origClOrderId").get_to(o.origClOrderId);
-    o.market = market_from_string(j.at("market").get<std::string>());
+    o.market = market_from_string(j.at("market").get_ref<const std::string &>());
     j.at("securityId").get_to(o.securityId);
     j.at("shareholderId").get_to(o.shareholderId);
-    o.side = side_from_string(j.at("side").get<std::string>());
+    o.side = side_from_string(j.at("side").get_ref<const std::string &>());
+}
+
+inline void to_json(nlohmann::json &j, const CancelOrder &o) {
+    j = nlohmann::json{{"clOrderId", o.clOrderId},
+                       {"origClOrderId", o.origClOrderId},
+                       {"market", to_string(o.market)},
+                       {"securityId", o.securityId},
+                       {"shareholderId", o.shareholderId},
+                       {"side", to_string(o.side)}};
 }
 
 // 3.3 行情信息
 struct MarketData {
     Market market;
-    std::string securityId;
-    double bidPrice;
-    double askPrice;
+    SecurityId securityId;
+    Price bidPrice;
+    Price askPrice;
 };
 
 // 3.4 - 3.8 输出结构体（可以统一也可以分开）
+// 订单字段未知（如请求格式错误）时 market 和 side 为 UNKNOWN，
+// 序列化时只输出编号和拒绝信息。
 struct OrderResponse {
-    std::string clOrderId;
-    Market market;
-    std::string securityId;
-    Side side;
-    uint32_t qty;
-    double price;
-    std::string shareholderId;
+    ClOrderId clOrderId;
+    Market market = Market::UNKNOWN;
+    SecurityId securityId;
+    Side side = Side::UNKNOWN;
+    uint32_t qty = 0;
+    Price price;
+    ShareholderId shareholderId;
 
     // 拒绝信息
     int32_t rejectCode = 0;
     std::string rejectText;
 
     // 成交信息
-    std::string execId;
+    ExecId execId;
     uint32_t execQty = 0;
-    double execPrice = 0.0;
+    Price execPrice;
 
     // 类型
-    enum Type { CONFIRM, REJECT, EXECUTION } type;
+    enum Type { CONFIRM, REJECT, EXECUTION } type = CONFIRM;
 };
 
 struct CancelResponse {
-    std::string clOrderId;
-    std::string origClOrderId;
-    Market market;
-    std::string securityId;
-    std::string shareholderId;
-    Side side;
+    ClOrderId clOrderId;
+    ClOrderId origClOrderId;
+    Market market = Market::UNKNOWN;
+    SecurityId securityId;
+    ShareholderId shareholderId;
+    Side side = Side::UNKNOWN;
 
     // 确认信息
     uint32_t qty = 0;
-    double price = 0.0;
+    Price price;
     uint32_t cumQty = 0;
     uint32_t canceledQty = 0;
 
@@ -156,7 +269,116 @@ struct CancelResponse {
     int32_t rejectCode = 0;
     std::string rejectText;
 
-    enum Type { CONFIRM, REJECT } type;
+    enum Type { CONFIRM, REJECT } type = CONFIRM;
 };
 
+namespace detail {
+
+// 读取可选字段，字段不存在时保持原值
+template <typename T>
+void getOptional(const nlohmann::json &j, const char *key, T &value) {
+    auto it = j.find(key);
+    if (it != j.end()) {
+        it->get_to(value);
+    }
+}
+
+inline void getOptionalMarket(const nlohmann::json &j, Market &market) {
+    auto it = j.find("market");
+    if (it != j.end()) {
+        market = market_from_string(it->get_ref<const std::string &>());
+    }
+}
+
+inline void getOptionalSide(const nlohmann::json &j, Side &side) {
+    auto it = j.find("side");
+    if (it != j.end()) {
+        side = side_from_string(it->get_ref<const std::string &>());
+    }
+}
+
+} // namespace detail
+
+inline void to_json(nlohmann::json &j, const OrderResponse &r) {
+    j = nlohmann::json{{"clOrderId", r.clOrderId}};
+    if (r.market != Market::UNKNOWN && r.side != Side::UNKNOWN) {
+        j["market"] = to_string(r.market);
+        j["securityId"] = r.securityId;
+        j["side"] = to_string(r.side);
+        j["qty"] = r.qty;
+        j["price"] = r.price;
+        j["shareholderId"] = r.shareholderId;
+    }
+    if (r.type == OrderResponse::REJECT) {
+        j["rejectCode"] = r.rejectCode;
+        j["rejectText"] = r.rejectText;
+    } else if (r.type == OrderResponse::EXECUTION) {
+        j["execId"] = r.execId;
+        j["execQty"] = r.execQty;
+        j["execPrice"] = r.execPrice;
+    }
+}
+
+// 交易所回报：含 execId 的是成交回报，含 rejectCode 的是拒绝回报，
+// 其余为确认回报。
+inline void from_json(const nlohmann::json &j, OrderResponse &r) {
+    j.at("clOrderId").get_to(r.clOrderId);
+    detail::getOptionalMarket(j, r.market);
+    detail::getOptional(j, "securityId", r.securityId);
+    detail::getOptionalSide(j, r.side);
+    detail::getOptional(j, "qty", r.qty);
+    detail::getOptional(j, "price", r.price);
+    detail::getOptional(j, "shareholderId", r.shareholderId);
+    if (j.contains("execId")) {
+        r.type = OrderResponse::EXECUTION;
+        j.at("execId").get_to(r.execId);
+        j.at("execQty").get_to(r.execQty);
+        detail::getOptional(j, "execPrice", r.execPrice);
+    } else if (j.contains("rejectCode")) {
+        r.type = OrderResponse::REJECT;
+        j.at("rejectCode").get_to(r.rejectCode);
+        detail::getOptional(j, "rejectText", r.rejectText);
+    } else {
+        r.type = OrderResponse::CONFIRM;
+    }
+}
+
+inline void to_json(nlohmann::json &j, const CancelResponse &r) {
+    j = nlohmann::json{{"clOrderId", r.clOrderId},
+                       {"origClOrderId", r.origClOrderId}};
+    if (r.type == CancelResponse::REJECT) {
+        j["rejectCode"] = r.rejectCode;
+        j["rejectText"] = r.rejectText;
+        return;
+    }
+    j["market"] = to_string(r.market);
+    j["securityId"] = r.securityId;
+    j["shareholderId"] = r.shareholderId;
+    j["side"] = to_string(r.side);
+    j["qty"] = r.qty;
+    j["price"] = r.price;
+    j["cumQty"] = r.cumQty;
+    j["canceledQty"] = r.canceledQty;
+}
+
+inline void from_json(const nlohmann::json &j, CancelResponse &r) {
+    j.at("clOrderId").get_to(r.clOrderId);
+    j.at("origClOrderId").get_to(r.origClOrderId);
+    detail::getOptionalMarket(j, r.market);
+    detail::getOptional(j, "securityId", r.securityId);
+    detail::getOptional(j, "shareholderId", r.shareholderId);
+    detail::getOptionalSide(j, r.side);
+    detail::getOptional(j, "qty", r.qty);
+    detail::getOptional(j, "price", r.price);
+    detail::getOptional(j, "cumQty", r.cumQty);
+    detail::getOptional(j, "canceledQty", r.canceledQty);
+    if (j.contains("rejectCode")) {
+        r.type = CancelResponse::REJECT;
+        j.at("rejectCode").get_to(r.rejectCode);
+        detail::getOptional(j, "rejectText", r.rejectText);
+    } else {
+        r.type = CancelResponse::CONFIRM;
+    }
+}
+
 } // namespace hdf
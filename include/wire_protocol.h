@@ -0,0 +1,409 @@
+#pragma once
+
+#include "types.h"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+namespace hdf::wire {
+
+/**
+ * 定长小端二进制协议（SBE 风格），供同机房网关使用，省去文本解析。
+ *
+ * 每条消息由8字节消息头和定长消息体组成：
+ *
+ *   | blockLength:u16 | templateId:u16 | schemaId:u16 | version:u16 | body |
+ *
+ * 消息体字段按下文顺序紧密排列，不做对齐：
+ * - 整数一律小端；价格为 Price::raw()，即以 1/10000 元为单位的 int64
+ * - 标识符为定长字符数组，长度等于对应 FixedString 的容量，不足补0
+ * - 市场为 u8 编码（见 MarketCode），买卖方向为 u8 字符 'B'/'S'
+ * - 拒绝原因为定长 REJECT_TEXT_SIZE 字节，超长截断
+ *
+ * 解码时 blockLength 可以大于本版本的消息体长度（新版本在尾部追加字段），
+ * 多出的部分被忽略。
+ */
+
+constexpr uint16_t SCHEMA_ID = 0x4844; // "HD"
+constexpr uint16_t SCHEMA_VERSION = 1;
+constexpr size_t HEADER_SIZE = 8;
+constexpr size_t REJECT_TEXT_SIZE = 64;
+
+enum class TemplateId : uint16_t {
+    NEW_ORDER = 1,
+    CANCEL_ORDER = 2,
+    ORDER_CONFIRM = 3,
+    ORDER_REJECT = 4,
+    EXECUTION_REPORT = 5,
+    CANCEL_CONFIRM = 6,
+    CANCEL_REJECT = 7,
+};
+
+enum class MarketCode : uint8_t { XSHG = 1, XSHE = 2, BJSE = 3 };
+
+struct MessageHeader {
+    uint16_t blockLength = 0;
+    TemplateId templateId{};
+    uint16_t schemaId = SCHEMA_ID;
+    uint16_t version = SCHEMA_VERSION;
+};
+
+// 各部分字段的字节数
+constexpr size_t ORDER_FIELDS_SIZE = ClOrderId::CAPACITY + 1 +
+                                     SecurityId::CAPACITY + 1 + 8 + 4 +
+                                     ShareholderId::CAPACITY;
+constexpr size_t CANCEL_FIELDS_SIZE = 2 * ClOrderId::CAPACITY + 1 +
+                                      SecurityId::CAPACITY +
+                                      ShareholderId::CAPACITY + 1;
+constexpr size_t REJECT_FIELDS_SIZE = 4 + REJECT_TEXT_SIZE;
+
+/**
+ * @brief 各消息体的长度，未知模板返回0。
+ */
+constexpr size_t blockLength(TemplateId id) {
+    switch (id) {
+    case TemplateId::NEW_ORDER:
+    case TemplateId::ORDER_CONFIRM:
+        return ORDER_FIELDS_SIZE;
+    case TemplateId::CANCEL_ORDER:
+        return CANCEL_FIELDS_SIZE;
+    case TemplateId::ORDER_REJECT:
+        return ORDER_FIELDS_SIZE + REJECT_FIELDS_SIZE;
+    case TemplateId::EXECUTION_REPORT:
+        return ORDER_FIELDS_SIZE + ExecId::CAPACITY + 4 + 8;
+    case TemplateId::CANCEL_CONFIRM:
+        return CANCEL_FIELDS_SIZE + 4 + 8 + 4 + 4;
+    case TemplateId::CANCEL_REJECT:
+        return 2 * ClOrderId::CAPACITY + REJECT_FIELDS_SIZE;
+    }
+    return 0;
+}
+
+// 编码任意一条消息所需的最大缓冲区长度
+constexpr size_t MAX_MESSAGE_SIZE =
+    HEADER_SIZE + std::max({blockLength(TemplateId::NEW_ORDER),
+                            blockLength(TemplateId::CANCEL_ORDER),
+                            blockLength(TemplateId::ORDER_REJECT),
+                            blockLength(TemplateId::EXECUTION_REPORT),
+                            blockLength(TemplateId::CANCEL_CONFIRM),
+                            blockLength(TemplateId::CANCEL_REJECT)});
+
+namespace detail {
+
+class Writer {
+  public:
+    explicit Writer(uint8_t *p) : p_(p) {}
+
+    template <std::integral T> void put(T value) {
+        if constexpr (std::endian::native == std::endian::big) {
+            value = std::byteswap(value);
+        }
+        std::memcpy(p_, &value, sizeof(T));
+        p_ += sizeof(T);
+    }
+    template <size_t N> void put(const FixedString<N> &s) {
+        std::memcpy(p_, s.data(), N);
+        p_ += N;
+    }
+    void put(Price price) { put(price.raw()); }
+    void put(Market market) {
+        switch (market) {
+        case Market::XSHG:
+            return put(static_cast<uint8_t>(MarketCode::XSHG));
+        case Market::XSHE:
+            return put(static_cast<uint8_t>(MarketCode::XSHE));
+        case Market::BJSE:
+            return put(static_cast<uint8_t>(MarketCode::BJSE));
+        default:
+            return put(uint8_t{0});
+        }
+    }
+    void put(Side side) {
+        put(static_cast<uint8_t>(side == Side::BUY    ? 'B'
+                                 : side == Side::SELL ? 'S'
+                                                      : 0));
+    }
+    void putText(std::string_view text, size_t size) {
+        size_t n = std::min(text.size(), size);
+        std::memcpy(p_, text.data(), n);
+        std::memset(p_ + n, 0, size - n);
+        p_ += size;
+    }
+
+  private:
+    uint8_t *p_;
+};
+
+class Reader {
+  public:
+    explicit Reader(const uint8_t *p) : p_(p) {}
+
+    template <std::integral T> T get() {
+        T value;
+        std::memcpy(&value, p_, sizeof(T));
+        p_ += sizeof(T);
+        if constexpr (std::endian::native == std::endian::big) {
+            value = std::byteswap(value);
+        }
+        return value;
+    }
+    template <size_t N> void get(FixedString<N> &s) {
+        s.assign(text(N));
+    }
+    void get(Price &price) { price = Price::fromRaw(get<int64_t>()); }
+    bool get(Market &market) {
+        switch (static_cast<MarketCode>(get<uint8_t>())) {
+        case MarketCode::XSHG:
+            market = Market::XSHG;
+            return true;
+        case MarketCode::XSHE:
+            market = Market::XSHE;
+            return true;
+        case MarketCode::BJSE:
+            market = Market::BJSE;
+            return true;
+        }
+        return false;
+    }
+    bool get(Side &side) {
+        switch (get<uint8_t>()) {
+        case 'B':
+            side = Side::BUY;
+            return true;
+        case 'S':
+            side = Side::SELL;
+            return true;
+        }
+        return false;
+    }
+    // 定长字符数组，到第一个0为止
+    std::string_view text(size_t size) {
+        const char *s = reinterpret_cast<const char *>(p_);
+        p_ += size;
+        return std::string_view(s, strnlen(s, size));
+    }
+
+  private:
+    const uint8_t *p_;
+};
+
+inline uint8_t *writeHeader(uint8_t *out, TemplateId id) {
+    Writer w(out);
+    w.put(static_cast<uint16_t>(blockLength(id)));
+    w.put(static_cast<uint16_t>(id));
+    w.put(SCHEMA_ID);
+    w.put(SCHEMA_VERSION);
+    return out + HEADER_SIZE;
+}
+
+template <typename T> void writeOrderFields(Writer &w, const T &o) {
+    w.put(o.clOrderId);
+    w.put(o.market);
+    w.put(o.securityId);
+    w.put(o.side);
+    w.put(o.price);
+    w.put(o.qty);
+    w.put(o.shareholderId);
+}
+
+template <typename T> bool readOrderFields(Reader &r, T &o) {
+    r.get(o.clOrderId);
+    bool marketOk = r.get(o.market);
+    r.get(o.securityId);
+    bool sideOk = r.get(o.side);
+    r.get(o.price);
+    o.qty = r.get<uint32_t>();
+    r.get(o.shareholderId);
+    return marketOk && sideOk;
+}
+
+template <typename T> void writeCancelFields(Writer &w, const T &c) {
+    w.put(c.clOrderId);
+    w.put(c.origClOrderId);
+    w.put(c.market);
+    w.put(c.securityId);
+    w.put(c.shareholderId);
+    w.put(c.side);
+}
+
+template <typename T> bool readCancelFields(Reader &r, T &c) {
+    r.get(c.clOrderId);
+    r.get(c.origClOrderId);
+    bool marketOk = r.get(c.market);
+    r.get(c.securityId);
+    r.get(c.shareholderId);
+    bool sideOk = r.get(c.side);
+    return marketOk && sideOk;
+}
+
+} // namespace detail
+
+/**
+ * @brief 读取消息头。
+ * @return 缓冲区开头是一条完整消息时返回其总长度；数据不足时返回0。
+ * @throws std::invalid_argument schemaId 不匹配或 blockLength 过短
+ */
+inline size_t decodeHeader(std::span<const uint8_t> buffer,
+                           MessageHeader &header) {
+    if (buffer.size() < HEADER_SIZE) {
+        return 0;
+    }
+    detail::Reader r(buffer.data());
+    header.blockLength = r.get<uint16_t>();
+    header.templateId = static_cast<TemplateId>(r.get<uint16_t>());
+    header.schemaId = r.get<uint16_t>();
+    header.version = r.get<uint16_t>();
+    if (header.schemaId != SCHEMA_ID) {
+        throw std::invalid_argument("wire: unknown schema id");
+    }
+    size_t expected = blockLength(header.templateId);
+    if (expected != 0 && header.blockLength < expected) {
+        throw std::invalid_argument("wire: block length too short");
+    }
+    size_t total = HEADER_SIZE + header.blockLength;
+    return buffer.size() < total ? 0 : total;
+}
+
+// 以下编码函数向 out 写入一条完整消息（含消息头），返回写入的字节数。
+// out 至少需要 MAX_MESSAGE_SIZE 字节。
+
+inline size_t encode(const Order &order, uint8_t *out) {
+    detail::Writer w(detail::writeHeader(out, TemplateId::NEW_ORDER));
+    detail::writeOrderFields(w, order);
+    return HEADER_SIZE + blockLength(TemplateId::NEW_ORDER);
+}
+
+inline size_t encode(const CancelOrder &cancel, uint8_t *out) {
+    detail::Writer w(detail::writeHeader(out, TemplateId::CANCEL_ORDER));
+    detail::writeCancelFields(w, cancel);
+    return HEADER_SIZE + blockLength(TemplateId::CANCEL_ORDER);
+}
+
+/**
+ * @brief 按 type 编码为订单确认、订单拒绝或成交回报。
+ * 订单字段未知的拒绝回报中 market 和 side 编码为0。
+ */
+inline size_t encode(const OrderResponse &response, uint8_t *out) {
+    TemplateId id = response.type == OrderResponse::REJECT
+                        ? TemplateId::ORDER_REJECT
+                    : response.type == OrderResponse::EXECUTION
+                        ? TemplateId::EXECUTION_REPORT
+                        : TemplateId::ORDER_CONFIRM;
+    detail::Writer w(detail::writeHeader(out, id));
+    detail::writeOrderFields(w, response);
+    if (id == TemplateId::ORDER_REJECT) {
+        w.put(response.rejectCode);
+        w.putText(response.rejectText, REJECT_TEXT_SIZE);
+    } else if (id == TemplateId::EXECUTION_REPORT) {
+        w.put(response.execId);
+        w.put(response.execQty);
+        w.put(response.execPrice);
+    }
+    return HEADER_SIZE + blockLength(id);
+}
+
+inline size_t encode(const CancelResponse &response, uint8_t *out) {
+    if (response.type == CancelResponse::REJECT) {
+        detail::Writer w(detail::writeHeader(out, TemplateId::CANCEL_REJECT));
+        w.put(response.clOrderId);
+        w.put(response.origClOrderId);
+        w.put(response.rejectCode);
+        w.putText(response.rejectText, REJECT_TEXT_SIZE);
+        return HEADER_SIZE + blockLength(TemplateId::CANCEL_REJECT);
+    }
+    detail::Writer w(detail::writeHeader(out, TemplateId::CANCEL_CONFIRM));
+    detail::writeCancelFields(w, response);
+    w.put(response.qty);
+    w.put(response.price);
+    w.put(response.cumQty);
+    w.put(response.canceledQty);
+    return HEADER_SIZE + blockLength(TemplateId::CANCEL_CONFIRM);
+}
+
+// 以下解码函数的 message 须是 decodeHeader 确认过的一条完整消息。
+// 成功返回 nullptr，失败返回错误描述（静态字符串）。
+
+inline const char *decode(std::span<const uint8_t> message, Order &order) {
+    detail::Reader r(message.data() + HEADER_SIZE);
+    if (!detail::readOrderFields(r, order)) {
+        return "invalid market or side";
+    }
+    order.securityKey = INVALID_KEY;
+    order.shareholderKey = INVALID_KEY;
+    return validateOrder(order);
+}
+
+inline const char *decode(std::span<const uint8_t> message,
+                          CancelOrder &cancel) {
+    detail::Reader r(message.data() + HEADER_SIZE);
+    if (!detail::readCancelFields(r, cancel)) {
+        return "invalid market or side";
+    }
+    return nullptr;
+}
+
+inline const char *decode(std::span<const uint8_t> message,
+                          OrderResponse &response) {
+    MessageHeader header;
+    decodeHeader(message, header);
+    detail::Reader r(message.data() + HEADER_SIZE);
+    bool known = detail::readOrderFields(r, response);
+    switch (header.templateId) {
+    case TemplateId::ORDER_CONFIRM:
+        response.type = OrderResponse::CONFIRM;
+        break;
+    case TemplateId::ORDER_REJECT:
+        response.type = OrderResponse::REJECT;
+        response.rejectCode = r.get<int32_t>();
+        response.rejectText = r.text(REJECT_TEXT_SIZE);
+        // 拒绝回报允许订单字段未知
+        if (!known) {
+            response.market = Market::UNKNOWN;
+            response.side = Side::UNKNOWN;
+        }
+        return nullptr;
+    case TemplateId::EXECUTION_REPORT:
+        response.type = OrderResponse::EXECUTION;
+        r.get(response.execId);
+        response.execQty = r.get<uint32_t>();
+        r.get(response.execPrice);
+        break;
+    default:
+        return "not an order response";
+    }
+    return known ? nullptr : "invalid market or side";
+}
+
+inline const char *decode(std::span<const uint8_t> message,
+                          CancelResponse &response) {
+    MessageHeader header;
+    decodeHeader(message, header);
+    detail::Reader r(message.data() + HEADER_SIZE);
+    if (header.templateId == TemplateId::CANCEL_REJECT) {
+        response.type = CancelResponse::REJECT;
+        r.get(response.clOrderId);
+        r.get(response.origClOrderId);
+        response.rejectCode = r.get<int32_t>();
+        response.rejectText = r.text(REJECT_TEXT_SIZE);
+        return nullptr;
+    }
+    if (header.templateId != TemplateId::CANCEL_CONFIRM) {
+        return "not a cancel response";
+    }
+    response.type = CancelResponse::CONFIRM;
+    if (!detail::readCancelFields(r, response)) {
+        return "invalid market or side";
+    }
+    response.qty = r.get<uint32_t>();
+    r.get(response.price);
+    response.cumQty = r.get<uint32_t>();
+    response.canceledQty = r.get<uint32_t>();
+    return nullptr;
+}
+
+} // namespace hdf::wire
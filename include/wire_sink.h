@@ -0,0 +1,53 @@
+#pragma once
+
+#include "trade_sink.h"
+#include "wire_protocol.h"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <utility>
+
+namespace hdf {
+
+// 以下是二进制协议适配器：把结构化回报编码为 wire 消息后交给回调函数。
+// 编码使用对象内的定长缓冲区，回调返回后缓冲区即被复用。
+
+class WireClientSink : public ClientSink {
+  public:
+    using Callback = std::function<void(std::span<const uint8_t>)>;
+
+    explicit WireClientSink(Callback callback)
+        : callback_(std::move(callback)) {}
+
+    void onOrderResponse(const OrderResponse &response) override {
+        callback_({buffer_, wire::encode(response, buffer_)});
+    }
+    void onCancelResponse(const CancelResponse &response) override {
+        callback_({buffer_, wire::encode(response, buffer_)});
+    }
+
+  private:
+    Callback callback_;
+    uint8_t buffer_[wire::MAX_MESSAGE_SIZE];
+};
+
+class WireExchangeSink : public ExchangeSink {
+  public:
+    using Callback = std::function<void(std::span<const uint8_t>)>;
+
+    explicit WireExchangeSink(Callback callback)
+        : callback_(std::move(callback)) {}
+
+    void onOrder(const Order &order) override {
+        callback_({buffer_, wire::encode(order, buffer_)});
+    }
+    void onCancel(const CancelOrder &cancel) override {
+        callback_({buffer_, wire::encode(cancel, buffer_)});
+    }
+
+  private:
+    Callback callback_;
+    uint8_t buffer_[wire::MAX_MESSAGE_SIZE];
+};
+
+} // namespace hdf
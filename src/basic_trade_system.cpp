@@ -0,0 +1,50 @@
+#include "basic_trade_system.h"
+
+namespace hdf {
+
+TradeCore::TradeCore() : TradeCore(EngineConfig{}) {}
+
+TradeCore::TradeCore(const EngineConfig &config)
+    : riskController(symbols), matchingEngine(symbols),
+      pendingTimeouts(config.timerTickNs),
+      pendingCancelTimeoutNs(config.pendingCancelTimeoutNs) {
+    riskController.reserve(config);
+    matchingEngine.reserve(config);
+    matchingEngine.setExecIdSequence(config.shardIndex + 1,
+                                     config.shardCount);
+    pendingMatches.reserve(config.expectedPendingMatches);
+    pendingMatches.setCancelIdSequence(config.shardIndex + 1,
+                                       config.shardCount);
+    if (pendingCancelTimeoutNs > 0) {
+        pendingTimeouts.reserve(config.expectedPendingMatches);
+    }
+    crossTradeReject.rejectCode = ORDER_CROSS_TRADE_REJECT_CODE;
+    crossTradeReject.rejectText = ORDER_CROSS_TRADE_REJECT_REASON;
+    crossTradeReject.type = OrderResponse::REJECT;
+}
+
+OrderResponse makeInvalidOrderReject(const ClOrderId &clOrderId,
+                                     std::string_view reason) {
+    OrderResponse response;
+    response.clOrderId = clOrderId;
+    response.rejectCode = ORDER_INVALID_FORMAT_REJECT_CODE;
+    response.rejectText = ORDER_INVALID_FORMAT_REJECT_REASON + ": ";
+    response.rejectText += reason;
+    response.type = OrderResponse::REJECT;
+    return response;
+}
+
+CancelResponse makeInvalidCancelReject(const ClOrderId &clOrderId,
+                                       const ClOrderId &origClOrderId,
+                                       std::string_view reason) {
+    CancelResponse response;
+    response.clOrderId = clOrderId;
+    response.origClOrderId = origClOrderId;
+    response.rejectCode = ORDER_INVALID_FORMAT_REJECT_CODE;
+    response.rejectText = ORDER_INVALID_FORMAT_REJECT_REASON + ": ";
+    response.rejectText += reason;
+    response.type = CancelResponse::REJECT;
+    return response;
+}
+
+} // namespace hdf
@@ -0,0 +1,66 @@
+#include "engine_messages.h"
+#include <chrono>
+
+namespace hdf {
+
+uint64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void RingEgressSink::onOrderResponse(const OrderResponse &response) {
+    ring_.push(OutboundMessage{response});
+}
+
+void RingEgressSink::onCancelResponse(const CancelResponse &response) {
+    ring_.push(OutboundMessage{response});
+}
+
+void RingEgressSink::onOrder(const Order &order) {
+    ring_.push(OutboundMessage{order});
+}
+
+void RingEgressSink::onCancel(const CancelOrder &cancel) {
+    ring_.push(OutboundMessage{cancel});
+}
+
+void dispatchInbound(TradeSystem &system, ClientSink &rejectSink,
+                     InboundMessage &message) {
+    switch (message.kind) {
+    case InboundMessage::ORDER:
+        system.handleOrder(std::get<Order>(message.payload));
+        break;
+    case InboundMessage::CANCEL:
+        system.handleCancel(std::get<CancelOrder>(message.payload));
+        break;
+    case InboundMessage::ORDER_RESPONSE:
+        system.handleResponse(std::get<OrderResponse>(message.payload));
+        break;
+    case InboundMessage::CANCEL_RESPONSE:
+        system.handleResponse(std::get<CancelResponse>(message.payload));
+        break;
+    case InboundMessage::ORDER_REJECT:
+        rejectSink.onOrderResponse(std::get<OrderResponse>(message.payload));
+        break;
+    case InboundMessage::CANCEL_REJECT:
+        rejectSink.onCancelResponse(std::get<CancelResponse>(message.payload));
+        break;
+    }
+}
+
+void deliverOutbound(OutboundMessage &message, ClientSink &clientSink,
+                     ExchangeSink *exchangeSink) {
+    auto &payload = message.payload;
+    if (auto *response = std::get_if<OrderResponse>(&payload)) {
+        clientSink.onOrderResponse(*response);
+    } else if (auto *response = std::get_if<CancelResponse>(&payload)) {
+        clientSink.onCancelResponse(*response);
+    } else if (auto *order = std::get_if<Order>(&payload)) {
+        exchangeSink->onOrder(*order);
+    } else if (auto *cancel = std::get_if<CancelOrder>(&payload)) {
+        exchangeSink->onCancel(*cancel);
+    }
+}
+
+} // namespace hdf
@@ -0,0 +1,235 @@
+#include "engine_metrics.h"
+#include "basic_trade_system.h"
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+namespace hdf {
+
+const char *toString(MetricCounter counter) {
+    switch (counter) {
+    case MetricCounter::ORDERS:
+        return "orders";
+    case MetricCounter::CANCELS:
+        return "cancels";
+    case MetricCounter::ORDER_RESPONSES:
+        return "order_responses";
+    case MetricCounter::CANCEL_RESPONSES:
+        return "cancel_responses";
+    case MetricCounter::COUNT:
+        break;
+    }
+    return "unknown";
+}
+
+const char *toString(MetricGauge gauge) {
+    switch (gauge) {
+    case MetricGauge::RESTING_ORDERS:
+        return "resting_orders";
+    case MetricGauge::RISK_ORDERS:
+        return "risk_orders";
+    case MetricGauge::RISK_BUCKETS:
+        return "risk_buckets";
+    case MetricGauge::PENDING_MATCHES:
+        return "pending_matches";
+    case MetricGauge::PENDING_CANCELS:
+        return "pending_cancels";
+    case MetricGauge::OLDEST_PENDING_AGE_NS:
+        return "oldest_pending_age_ns";
+    case MetricGauge::SECURITIES:
+        return "securities";
+    case MetricGauge::SHAREHOLDERS:
+        return "shareholders";
+    case MetricGauge::SYMBOL_TABLE_BYTES:
+        return "symbol_table_bytes";
+    case MetricGauge::RISK_BYTES:
+        return "risk_bytes";
+    case MetricGauge::MATCHING_BYTES:
+        return "matching_bytes";
+    case MetricGauge::PENDING_MATCH_BYTES:
+        return "pending_match_bytes";
+    case MetricGauge::COUNT:
+        break;
+    }
+    return "unknown";
+}
+
+EngineMetrics::EngineMetrics(size_t maxSecurities)
+    : maxSecurities_(maxSecurities),
+      securities_(std::make_unique<SecuritySlot[]>(maxSecurities)) {}
+
+EngineMetrics::~EngineMetrics() {}
+
+void EngineMetrics::publish(const TradeCore &core) {
+    const SymbolTable &symbols = core.symbols;
+    const PendingMatchTable &pending = core.pendingMatches;
+
+    // 新出现的股票先写名称再发布，名称不属于采样，不受版本号保护
+    size_t named = namedSecurities_.load(std::memory_order_relaxed);
+    size_t securityCount = std::min(symbols.securityCount(), maxSecurities_);
+    for (size_t key = named; key < securityCount; ++key) {
+        auto securityKey = static_cast<SecurityKey>(key);
+        securities_[key].market = symbols.marketOf(securityKey);
+        securities_[key].securityId = symbols.securityIdOf(securityKey);
+    }
+    if (securityCount > named) {
+        namedSecurities_.store(securityCount, std::memory_order_release);
+    }
+
+    uint64_t nowNs = clockNs();
+    uint64_t pendingCancels = 0;
+    uint64_t oldestNs = nowNs;
+    for (uint32_t slot = 0; slot < pending.slotCount(); ++slot) {
+        const PendingMatchTable::Match &match = pending.at(slot);
+        if (match.firstCancelSeq == 0) {
+            continue;
+        }
+        pendingCancels += match.pendingCancelCount;
+        if (match.acquiredNs != 0) {
+            oldestNs = std::min(oldestNs, match.acquiredNs);
+        }
+    }
+
+    auto set = [this](MetricGauge gauge, uint64_t value) {
+        gauges_[static_cast<size_t>(gauge)].store(value,
+                                                  std::memory_order_relaxed);
+    };
+    uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    publishedNs_.store(nowNs, std::memory_order_relaxed);
+    set(MetricGauge::RESTING_ORDERS, core.matchingEngine.orderCount());
+    set(MetricGauge::RISK_ORDERS, core.riskController.orderCount());
+    set(MetricGauge::RISK_BUCKETS, core.riskController.bucketCount());
+    set(MetricGauge::PENDING_MATCHES, pending.size());
+    set(MetricGauge::PENDING_CANCELS, pendingCancels);
+    set(MetricGauge::OLDEST_PENDING_AGE_NS,
+        nowNs > oldestNs ? nowNs - oldestNs : 0);
+    set(MetricGauge::SECURITIES, symbols.securityCount());
+    set(MetricGauge::SHAREHOLDERS, symbols.shareholderCount());
+    set(MetricGauge::SYMBOL_TABLE_BYTES, symbols.memoryBytes());
+    set(MetricGauge::RISK_BYTES, core.riskController.memoryBytes());
+    set(MetricGauge::MATCHING_BYTES, core.matchingEngine.memoryBytes());
+    set(MetricGauge::PENDING_MATCH_BYTES, pending.memoryBytes());
+    for (size_t key = 0; key < securityCount; ++key) {
+        securities_[key].restingOrders.store(
+            core.matchingEngine.restingOrders(static_cast<SecurityKey>(key)),
+            std::memory_order_relaxed);
+    }
+
+    version_.store(version + 2, std::memory_order_release);
+}
+
+MetricsSnapshot EngineMetrics::snapshot() const {
+    MetricsSnapshot result;
+    for (size_t i = 0; i < counters_.size(); ++i) {
+        result.counters[i] = counters_[i].load(std::memory_order_relaxed);
+    }
+    result.rejects.resize(rejects_.size());
+    for (size_t i = 0; i < rejects_.size(); ++i) {
+        result.rejects[i] = rejects_[i].load(std::memory_order_relaxed);
+    }
+
+    while (true) {
+        uint64_t before = version_.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        // 股票数在采样之间才会增长，与状态量同属一次采样
+        size_t named = namedSecurities_.load(std::memory_order_acquire);
+        for (size_t key = result.securities.size(); key < named; ++key) {
+            result.securities.push_back(
+                {securities_[key].market, securities_[key].securityId, 0});
+        }
+        result.securities.resize(named);
+        result.publishedNs = publishedNs_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < gauges_.size(); ++i) {
+            result.gauges[i] = gauges_[i].load(std::memory_order_relaxed);
+        }
+        for (size_t key = 0; key < named; ++key) {
+            result.securities[key].restingOrders =
+                securities_[key].restingOrders.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == before) {
+            result.publishCount = before / 2;
+            break;
+        }
+    }
+    return result;
+}
+
+namespace {
+
+std::string securityLabel(const MetricsSnapshot::SecurityDepth &security) {
+    std::string label = to_string(security.market);
+    label += '.';
+    label += security.securityId.view();
+    return label;
+}
+
+} // namespace
+
+std::string MetricsSnapshot::toText() const {
+    std::string out;
+    auto line = [&out](std::string_view name, std::string_view labels,
+                       uint64_t value) {
+        out += "hdf_";
+        out += name;
+        out += labels;
+        out += ' ';
+        out += std::to_string(value);
+        out += '\n';
+    };
+    line("published_ns", "", publishedNs);
+    line("publish_count", "", publishCount);
+    for (size_t i = 0; i < counters.size(); ++i) {
+        line(std::string(toString(static_cast<MetricCounter>(i))) + "_total",
+             "", counters[i]);
+    }
+    for (size_t i = 0; i < gauges.size(); ++i) {
+        line(toString(static_cast<MetricGauge>(i)), "", gauges[i]);
+    }
+    for (size_t code = 0; code < rejects.size(); ++code) {
+        if (rejects[code] > 0) {
+            line("rejects_total",
+                 "{code=\"" + (code == 0 ? "other" : std::to_string(code)) +
+                     "\"}",
+                 rejects[code]);
+        }
+    }
+    for (const SecurityDepth &security : securities) {
+        line("security_resting_orders",
+             "{security=\"" + securityLabel(security) + "\"}",
+             security.restingOrders);
+    }
+    return out;
+}
+
+std::string MetricsSnapshot::toJson() const {
+    nlohmann::json j;
+    j["publishedNs"] = publishedNs;
+    j["publishCount"] = publishCount;
+    for (size_t i = 0; i < counters.size(); ++i) {
+        j["counters"][toString(static_cast<MetricCounter>(i))] = counters[i];
+    }
+    for (size_t i = 0; i < gauges.size(); ++i) {
+        j["gauges"][toString(static_cast<MetricGauge>(i))] = gauges[i];
+    }
+    j["rejects"] = nlohmann::json::object();
+    for (size_t code = 0; code < rejects.size(); ++code) {
+        if (rejects[code] > 0) {
+            j["rejects"][code == 0 ? "other" : std::to_string(code)] =
+                rejects[code];
+        }
+    }
+    j["securities"] = nlohmann::json::object();
+    for (const SecurityDepth &security : securities) {
+        j["securities"][securityLabel(security)] = security.restingOrders;
+    }
+    return j.dump();
+}
+
+} // namespace hdf
@@ -0,0 +1,151 @@
+#include "gateway_trade_system.h"
+#include "order_parser.h"
+#include <stdexcept>
+
+namespace hdf {
+
+GatewayTradeSystem::GatewayTradeSystem(ClientSink &clientSink,
+                                       ExchangeSink *exchangeSink,
+                                       const EngineConfig &config,
+                                       size_t maxGateways,
+                                       size_t queueCapacity)
+    : clientSink_(clientSink), inbound_(queueCapacity),
+      maxGateways_(maxGateways),
+      progress_(std::make_unique<GatewayProgress[]>(maxGateways)),
+      core_(config), timed_(config.pendingCancelTimeoutNs > 0) {
+    core_.setClientSink(&clientSink_);
+    core_.setExchangeSink(exchangeSink);
+    coreThread_ = std::thread([this] { coreLoop(); });
+}
+
+GatewayTradeSystem::~GatewayTradeSystem() { stop(); }
+
+void GatewayTradeSystem::stop() {
+    if (stopped_) {
+        return;
+    }
+    stopped_ = true;
+    inputClosed_.store(true, std::memory_order_release);
+    coreThread_.join();
+}
+
+GatewayTradeSystem::Gateway GatewayTradeSystem::openGateway() {
+    uint32_t id = gatewayCount_.fetch_add(1, std::memory_order_relaxed);
+    if (id >= maxGateways_) {
+        throw std::length_error("too many gateways");
+    }
+    return Gateway(*this, id);
+}
+
+GatewayTradeSystem::Stats GatewayTradeSystem::stats() const {
+    Stats stats;
+    stats.depth = inbound_.size();
+    stats.dequeued = dequeued_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.totalLatencyNs = totalLatencyNs_.load(std::memory_order_relaxed);
+    stats.maxLatencyNs = maxLatencyNs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+uint64_t GatewayTradeSystem::Gateway::submit(InboundMessage &&message) {
+    uint64_t sequence = nextSequence_++;
+    system_->inbound_.push(
+        Envelope{id_, sequence, steadyNowNs(), std::move(message)});
+    return sequence;
+}
+
+uint64_t GatewayTradeSystem::Gateway::submitOrder(const Order &order) {
+    return submit(InboundMessage{InboundMessage::ORDER, order});
+}
+
+uint64_t GatewayTradeSystem::Gateway::submitCancel(const CancelOrder &cancel) {
+    return submit(InboundMessage{InboundMessage::CANCEL, cancel});
+}
+
+uint64_t
+GatewayTradeSystem::Gateway::submitResponse(const OrderResponse &response) {
+    return submit(InboundMessage{InboundMessage::ORDER_RESPONSE, response});
+}
+
+uint64_t
+GatewayTradeSystem::Gateway::submitResponse(const CancelResponse &response) {
+    return submit(InboundMessage{InboundMessage::CANCEL_RESPONSE, response});
+}
+
+uint64_t GatewayTradeSystem::Gateway::submitOrderRaw(std::string_view input) {
+    Order order;
+    if (const char *error = parseOrder(input, order)) {
+        return submit(InboundMessage{
+            InboundMessage::ORDER_REJECT,
+            makeInvalidOrderReject(findIdField(input, "clOrderId"), error)});
+    }
+    return submitOrder(order);
+}
+
+uint64_t
+GatewayTradeSystem::Gateway::submitCancelRaw(std::string_view input) {
+    CancelOrder cancel;
+    if (const char *error = parseCancelOrder(input, cancel)) {
+        return submit(InboundMessage{
+            InboundMessage::CANCEL_REJECT,
+            makeInvalidCancelReject(findIdField(input, "clOrderId"),
+                                    findIdField(input, "origClOrderId"),
+                                    error)});
+    }
+    return submitCancel(cancel);
+}
+
+uint64_t GatewayTradeSystem::Gateway::processedSequence() const {
+    return system_->progress_[id_].processed.load(std::memory_order_acquire);
+}
+
+void GatewayTradeSystem::coreLoop() {
+    SpinWait idle;
+    while (true) {
+        // 每批只读一次时钟；批内较晚发布的消息入队时间可能晚于该时刻，按0计
+        uint64_t batchNs = steadyNowNs();
+        if (timed_) {
+            core_.advanceTime(batchNs);
+        }
+        uint64_t batchLatencyNs = 0;
+        uint64_t batchMaxNs = 0;
+        size_t n = inbound_.popBatch(
+            [&](Envelope &envelope) {
+                uint64_t waited = batchNs > envelope.enqueueNs
+                                      ? batchNs - envelope.enqueueNs
+                                      : 0;
+                batchLatencyNs += waited;
+                if (waited > batchMaxNs) {
+                    batchMaxNs = waited;
+                }
+                dispatchInbound(core_, clientSink_, envelope.message);
+                progress_[envelope.gateway].processed.store(
+                    envelope.sequence, std::memory_order_release);
+            },
+            MAX_BATCH);
+        if (n > 0) {
+            // 只有核心线程写入，不需要读-改-写原子操作
+            dequeued_.store(dequeued_.load(std::memory_order_relaxed) + n,
+                            std::memory_order_relaxed);
+            batches_.store(batches_.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+            totalLatencyNs_.store(
+                totalLatencyNs_.load(std::memory_order_relaxed) +
+                    batchLatencyNs,
+                std::memory_order_relaxed);
+            if (batchMaxNs > maxLatencyNs_.load(std::memory_order_relaxed)) {
+                maxLatencyNs_.store(batchMaxNs, std::memory_order_relaxed);
+            }
+            idle.reset();
+            continue;
+        }
+        // 先确认输入已关闭再检查队列，保证关闭前提交的消息都已取出
+        if (inputClosed_.load(std::memory_order_acquire) &&
+            inbound_.empty()) {
+            break;
+        }
+        idle.wait();
+    }
+}
+
+} // namespace hdf
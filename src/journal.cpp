@@ -0,0 +1,234 @@
+#include "journal.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace hdf {
+
+namespace journal {
+
+uint32_t checksum(const uint8_t *data, size_t size) {
+    // FNV-1a，只用于发现写了一半的记录，不防篡改
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+
+} // namespace journal
+
+namespace {
+
+void storeU32(uint8_t *p, uint32_t v) {
+    if constexpr (std::endian::native == std::endian::big) {
+        v = std::byteswap(v);
+    }
+    std::memcpy(p, &v, 4);
+}
+
+void storeU64(uint8_t *p, uint64_t v) {
+    if constexpr (std::endian::native == std::endian::big) {
+        v = std::byteswap(v);
+    }
+    std::memcpy(p, &v, 8);
+}
+
+[[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+JournalWriter::JournalWriter(const std::string &path,
+                             const JournalOptions &options)
+    : options_(options) {
+    if (options_.groupRecords == 0) {
+        options_.groupRecords = 1;
+    }
+    size_t minBuffer = journal::RECORD_HEADER_SIZE + wire::MAX_MESSAGE_SIZE;
+    if (options_.bufferBytes < minBuffer) {
+        options_.bufferBytes = minBuffer;
+    }
+    buffer_ = std::make_unique<uint8_t[]>(options_.bufferBytes);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throwErrno("JournalWriter: open");
+    }
+    try {
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            throwErrno("JournalWriter: fstat");
+        }
+        if (st.st_size == 0) {
+            uint8_t header[journal::FILE_HEADER_SIZE];
+            storeU32(header, journal::MAGIC);
+            storeU32(header + 4, journal::VERSION);
+            writeAll(header, sizeof(header));
+        } else {
+            JournalScan scan = JournalReader(path).forEach(
+                [](uint64_t, journal::RecordKind, std::span<const uint8_t>) {
+                });
+            if (scan.truncated &&
+                ::ftruncate(fd_, static_cast<off_t>(scan.validBytes)) != 0) {
+                throwErrno("JournalWriter: ftruncate");
+            }
+            if (::lseek(fd_, static_cast<off_t>(scan.validBytes), SEEK_SET) <
+                0) {
+                throwErrno("JournalWriter: lseek");
+            }
+            nextSequence_ = scan.lastSequence + 1;
+            committedSequence_ = scan.lastSequence;
+        }
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+}
+
+JournalWriter::~JournalWriter() {
+    try {
+        commit();
+    } catch (...) {
+    }
+    ::close(fd_);
+}
+
+void JournalWriter::checkFailed() const {
+    if (failed_) {
+        throw std::runtime_error("JournalWriter: a previous commit failed");
+    }
+}
+
+uint8_t *JournalWriter::beginRecord(size_t maxPayload) {
+    checkFailed();
+    if (options_.bufferBytes - size_ <
+        journal::RECORD_HEADER_SIZE + maxPayload) {
+        commit();
+    }
+    return buffer_.get() + size_;
+}
+
+uint64_t JournalWriter::endRecord(uint8_t *record, journal::RecordKind kind,
+                                  size_t payloadSize) {
+    uint64_t sequence = nextSequence_++;
+    storeU32(record, static_cast<uint32_t>(payloadSize));
+    storeU64(record + 8, sequence);
+    record[16] = static_cast<uint8_t>(kind);
+    storeU32(record + 4, journal::checksum(record + 8, 9 + payloadSize));
+    size_ += journal::RECORD_HEADER_SIZE + payloadSize;
+    if (++pendingRecords_ >= options_.groupRecords ||
+        options_.sync == JournalSync::EACH) {
+        commit();
+    }
+    return sequence;
+}
+
+uint64_t JournalWriter::append(const Order &order) {
+    uint8_t *record = beginRecord(wire::MAX_MESSAGE_SIZE);
+    size_t n = wire::encode(order, record + journal::RECORD_HEADER_SIZE);
+    return endRecord(record, journal::RecordKind::WIRE, n);
+}
+
+uint64_t JournalWriter::append(const CancelOrder &cancel) {
+    uint8_t *record = beginRecord(wire::MAX_MESSAGE_SIZE);
+    size_t n = wire::encode(cancel, record + journal::RECORD_HEADER_SIZE);
+    return endRecord(record, journal::RecordKind::WIRE, n);
+}
+
+uint64_t JournalWriter::append(const OrderResponse &response) {
+    uint8_t *record = beginRecord(wire::MAX_MESSAGE_SIZE);
+    size_t n = wire::encode(response, record + journal::RECORD_HEADER_SIZE);
+    return endRecord(record, journal::RecordKind::WIRE, n);
+}
+
+uint64_t JournalWriter::append(const CancelResponse &response) {
+    uint8_t *record = beginRecord(wire::MAX_MESSAGE_SIZE);
+    size_t n = wire::encode(response, record + journal::RECORD_HEADER_SIZE);
+    return endRecord(record, journal::RecordKind::WIRE, n);
+}
+
+uint64_t JournalWriter::appendTime(uint64_t nowNs) {
+    uint8_t *record = beginRecord(8);
+    storeU64(record + journal::RECORD_HEADER_SIZE, nowNs);
+    return endRecord(record, journal::RecordKind::TIME, 8);
+}
+
+void JournalWriter::commit() {
+    checkFailed();
+    if (size_ == 0) {
+        return;
+    }
+    try {
+        writeAll(buffer_.get(), size_);
+        if (options_.sync != JournalSync::NONE && ::fdatasync(fd_) != 0) {
+            throwErrno("JournalWriter: fdatasync");
+        }
+    } catch (...) {
+        // 组可能已写出一部分，整组重写会重复记录，丢弃又会留下序号空洞：
+        // 停止写入，由重新打开时截掉不完整的尾部
+        failed_ = true;
+        throw;
+    }
+    size_ = 0;
+    pendingRecords_ = 0;
+    committedSequence_ = nextSequence_ - 1;
+}
+
+void JournalWriter::writeAll(const uint8_t *data, size_t n) {
+    while (n > 0) {
+        ssize_t written = ::write(fd_, data, n);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwErrno("JournalWriter: write");
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+}
+
+JournalReader::JournalReader(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throwErrno("JournalReader: open");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(),
+                                "JournalReader: fstat");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ < journal::FILE_HEADER_SIZE) {
+        ::close(fd);
+        throw std::runtime_error("JournalReader: file too short");
+    }
+    void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        throw std::system_error(err, std::generic_category(),
+                                "JournalReader: mmap");
+    }
+    data_ = static_cast<const uint8_t *>(p);
+    ::madvise(p, size_, MADV_SEQUENTIAL);
+    if (journal::loadU32(data_) != journal::MAGIC ||
+        journal::loadU32(data_ + 4) != journal::VERSION) {
+        ::munmap(p, size_);
+        throw std::runtime_error("JournalReader: not a journal file");
+    }
+}
+
+JournalReader::~JournalReader() {
+    ::munmap(const_cast<uint8_t *>(data_), size_);
+}
+
+} // namespace hdf
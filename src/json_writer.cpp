@@ -0,0 +1,198 @@
+#include "json_writer.h"
+#include <charconv>
+
+namespace hdf {
+
+namespace {
+
+// 单个 JSON 值格式化后的最大长度（整数、价格等定长值）
+constexpr size_t MAX_SCALAR_SIZE = 32;
+
+/**
+ * @brief 逐字段拼接一个 JSON 对象，调用方须按字母序给出键。
+ */
+class ObjectWriter {
+  public:
+    explicit ObjectWriter(BufferedWriter &out) : out_(out) { out_.put('{'); }
+
+    ~ObjectWriter() {
+        out_.put('}');
+        out_.put('\n');
+    }
+
+    void field(const char *key, std::string_view value) {
+        writeKey(key);
+        writeString(value);
+    }
+
+    void field(const char *key, int64_t value) {
+        writeKey(key);
+        char *p = out_.reserve(MAX_SCALAR_SIZE);
+        out_.commit(std::to_chars(p, p + MAX_SCALAR_SIZE, value).ptr - p);
+    }
+
+    // 与 nlohmann::json 输出 double 的格式一致：至少保留一位小数
+    void field(const char *key, Price price) {
+        writeKey(key);
+        char *begin = out_.reserve(MAX_SCALAR_SIZE);
+        char *p = begin;
+        int64_t raw = price.raw();
+        if (raw < 0) {
+            *p++ = '-';
+            raw = -raw;
+        }
+        p = std::to_chars(p, begin + MAX_SCALAR_SIZE, raw / Price::SCALE).ptr;
+        *p++ = '.';
+        int64_t frac = raw % Price::SCALE;
+        if (frac == 0) {
+            *p++ = '0';
+        } else {
+            for (int64_t unit = Price::SCALE / 10; frac > 0; unit /= 10) {
+                *p++ = static_cast<char>('0' + frac / unit);
+                frac %= unit;
+            }
+        }
+        out_.commit(p - begin);
+    }
+
+    void field(const char *key, Market market) {
+        field(key, std::string_view(to_string(market)));
+    }
+
+    void field(const char *key, Side side) {
+        field(key, std::string_view(side == Side::BUY ? "B" : "S"));
+    }
+
+  private:
+    BufferedWriter &out_;
+    bool first_ = true;
+
+    void writeKey(const char *key) {
+        if (!first_) {
+            out_.put(',');
+        }
+        first_ = false;
+        out_.put('"');
+        out_.write(key);
+        out_.put('"');
+        out_.put(':');
+    }
+
+    void writeString(std::string_view s) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        out_.put('"');
+        size_t plain = 0; // 尚未写出的无需转义的前缀长度
+        for (size_t i = 0; i < s.size(); i++) {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                plain++;
+                continue;
+            }
+            out_.write(s.substr(i - plain, plain));
+            plain = 0;
+            out_.put('\\');
+            switch (c) {
+            case '"':
+            case '\\':
+                out_.put(static_cast<char>(c));
+                break;
+            case '\b':
+                out_.put('b');
+                break;
+            case '\f':
+                out_.put('f');
+                break;
+            case '\n':
+                out_.put('n');
+                break;
+            case '\r':
+                out_.put('r');
+                break;
+            case '\t':
+                out_.put('t');
+                break;
+            default:
+                out_.write("u00");
+                out_.put(HEX[c >> 4]);
+                out_.put(HEX[c & 0xF]);
+            }
+        }
+        out_.write(s.substr(s.size() - plain));
+        out_.put('"');
+    }
+};
+
+} // namespace
+
+void writeJsonLine(BufferedWriter &out, const Order &order) {
+    ObjectWriter w(out);
+    w.field("clOrderId", order.clOrderId.view());
+    w.field("market", order.market);
+    w.field("price", order.price);
+    w.field("qty", int64_t{order.qty});
+    w.field("securityId", order.securityId.view());
+    w.field("shareholderId", order.shareholderId.view());
+    w.field("side", order.side);
+}
+
+void writeJsonLine(BufferedWriter &out, const CancelOrder &cancel) {
+    ObjectWriter w(out);
+    w.field("clOrderId", cancel.clOrderId.view());
+    w.field("market", cancel.market);
+    w.field("origClOrderId", cancel.origClOrderId.view());
+    w.field("securityId", cancel.securityId.view());
+    w.field("shareholderId", cancel.shareholderId.view());
+    w.field("side", cancel.side);
+}
+
+void writeJsonLine(BufferedWriter &out, const OrderResponse &response) {
+    bool hasOrder =
+        response.market != Market::UNKNOWN && response.side != Side::UNKNOWN;
+    bool isExecution = response.type == OrderResponse::EXECUTION;
+    bool isReject = response.type == OrderResponse::REJECT;
+
+    ObjectWriter w(out);
+    w.field("clOrderId", response.clOrderId.view());
+    if (isExecution) {
+        w.field("execId", response.execId.view());
+        w.field("execPrice", response.execPrice);
+        w.field("execQty", int64_t{response.execQty});
+    }
+    if (hasOrder) {
+        w.field("market", response.market);
+        w.field("price", response.price);
+        w.field("qty", int64_t{response.qty});
+    }
+    if (isReject) {
+        w.field("rejectCode", int64_t{response.rejectCode});
+        w.field("rejectText", response.rejectText);
+    }
+    if (hasOrder) {
+        w.field("securityId", response.securityId.view());
+        w.field("shareholderId", response.shareholderId.view());
+        w.field("side", response.side);
+    }
+}
+
+void writeJsonLine(BufferedWriter &out, const CancelResponse &response) {
+    ObjectWriter w(out);
+    if (response.type == CancelResponse::REJECT) {
+        w.field("clOrderId", response.clOrderId.view());
+        w.field("origClOrderId", response.origClOrderId.view());
+        w.field("rejectCode", int64_t{response.rejectCode});
+        w.field("rejectText", response.rejectText);
+        return;
+    }
+    w.field("canceledQty", int64_t{response.canceledQty});
+    w.field("clOrderId", response.clOrderId.view());
+    w.field("cumQty", int64_t{response.cumQty});
+    w.field("market", response.market);
+    w.field("origClOrderId", response.origClOrderId.view());
+    w.field("price", response.price);
+    w.field("qty", int64_t{response.qty});
+    w.field("securityId", response.securityId.view());
+    w.field("shareholderId", response.shareholderId.view());
+    w.field("side", response.side);
+}
+
+} // namespace hdf
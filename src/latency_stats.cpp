@@ -0,0 +1,165 @@
+#include "latency_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+namespace hdf {
+
+const char *toString(LatencyStage stage) {
+    switch (stage) {
+    case LatencyStage::PARSE:
+        return "parse";
+    case LatencyStage::RISK_CHECK:
+        return "riskCheck";
+    case LatencyStage::MATCH:
+        return "match";
+    case LatencyStage::ADD_ORDER:
+        return "addOrder";
+    case LatencyStage::CANCEL:
+        return "cancel";
+    case LatencyStage::RESPONSE:
+        return "response";
+    case LatencyStage::TOTAL:
+        return "total";
+    case LatencyStage::COUNT:
+        break;
+    }
+    return "unknown";
+}
+
+const char *toString(LatencyMessage message) {
+    switch (message) {
+    case LatencyMessage::ORDER:
+        return "order";
+    case LatencyMessage::CANCEL:
+        return "cancel";
+    case LatencyMessage::ORDER_RESPONSE:
+        return "orderResponse";
+    case LatencyMessage::CANCEL_RESPONSE:
+        return "cancelResponse";
+    case LatencyMessage::COUNT:
+        break;
+    }
+    return "unknown";
+}
+
+namespace latency {
+
+double nsPerTick() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double value = [] {
+        using Clock = std::chrono::steady_clock;
+        auto begin = Clock::now();
+        uint64_t beginTicks = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t ticks = __rdtsc() - beginTicks;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      Clock::now() - begin)
+                      .count();
+        return ticks > 0 ? static_cast<double>(ns) / ticks : 1.0;
+    }();
+    return value;
+#else
+    return 1e9 * std::chrono::steady_clock::period::num /
+           std::chrono::steady_clock::period::den;
+#endif
+}
+
+} // namespace latency
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    size_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    // 第 rank 个（从1数起）记录所在的桶
+    auto rank = static_cast<uint64_t>(std::ceil(q * count_));
+    rank = std::clamp<uint64_t>(rank, 1, count_);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::reset() {
+    counts_.fill(0);
+    count_ = 0;
+    max_ = 0;
+}
+
+LatencyStats::LatencyStats() {
+    if constexpr (LATENCY_STATS_ENABLED) {
+        histograms_ = std::make_unique<
+            std::array<LatencyHistogram, MESSAGES * STAGES>>();
+    }
+}
+
+LatencySummary LatencyStats::summary(LatencyMessage message,
+                                     LatencyStage stage) const {
+    LatencySummary result;
+    if (!histograms_) {
+        return result;
+    }
+    const LatencyHistogram &h =
+        (*histograms_)[static_cast<size_t>(message) * STAGES +
+                       static_cast<size_t>(stage)];
+    double scale = latency::nsPerTick();
+    result.count = h.count();
+    result.p50Ns = h.percentile(0.5) * scale;
+    result.p99Ns = h.percentile(0.99) * scale;
+    result.p999Ns = h.percentile(0.999) * scale;
+    result.maxNs = h.max() * scale;
+    return result;
+}
+
+std::string LatencyStats::format() const {
+    if (!histograms_) {
+        return "latency stats disabled (build with HDF_LATENCY_STATS)\n";
+    }
+    std::string out;
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-16s %-10s %10s %9s %9s %9s %11s\n",
+                  "message", "stage", "count", "p50", "p99", "p99.9",
+                  "max(ns)");
+    out += line;
+    for (size_t m = 0; m < MESSAGES; ++m) {
+        for (size_t s = 0; s < STAGES; ++s) {
+            auto message = static_cast<LatencyMessage>(m);
+            auto stage = static_cast<LatencyStage>(s);
+            LatencySummary r = summary(message, stage);
+            if (r.count == 0) {
+                continue;
+            }
+            std::snprintf(line, sizeof(line),
+                          "%-16s %-10s %10llu %9.0f %9.0f %9.0f %11.0f\n",
+                          toString(message), toString(stage),
+                          static_cast<unsigned long long>(r.count), r.p50Ns,
+                          r.p99Ns, r.p999Ns, r.maxNs);
+            out += line;
+        }
+    }
+    return out;
+}
+
+void LatencyStats::reset() {
+    if (histograms_) {
+        for (LatencyHistogram &h : *histograms_) {
+            h.reset();
+        }
+    }
+}
+
+} // namespace hdf
@@ -1,43 +1,352 @@
 #include "matching_engine.h"
+#include "constants.h"
 #include "types.h"
+#include <algorithm>
+#include <charconv>
 
 namespace hdf {
 
-MatchingEngine::MatchingEngine() {}
+namespace {
+
+// 单边订单簿首次建立时预留的档位数（以首笔价格为中心）
+constexpr int64_t INITIAL_LEVELS = 256;
+// 价格越界扩展时额外预留的档位数，避免价格小幅移动时反复扩展
+constexpr int64_t GROW_LEVELS = 128;
+
+// 买方价格越高越优，卖方价格越低越优
+bool isBetter(Side side, int64_t tick, int64_t than) {
+    return side == Side::BUY ? tick > than : tick < than;
+}
+
+// 成交编号格式为 "E" + 序号，直接写入定长缓冲区，不经过 std::string
+ExecId makeExecId(uint64_t seq) {
+    char buf[ExecId::CAPACITY];
+    buf[0] = 'E';
+    auto [end, ec] = std::to_chars(buf + 1, buf + sizeof(buf), seq);
+    return ExecId(std::string_view(buf, end - buf));
+}
+
+// 主动方限价能否与对手方最优价成交
+bool crosses(Side takerSide, int64_t takerTick, int64_t makerTick) {
+    return takerSide == Side::BUY ? takerTick >= makerTick
+                                  : takerTick <= makerTick;
+}
+
+} // namespace
+
+MatchingEngine::MatchingEngine()
+    : ownedSymbols_(std::make_unique<SymbolTable>()),
+      symbols_(ownedSymbols_.get()),
+      orderIndex_(PoolAllocator<char>(nodePool_)) {}
+
+MatchingEngine::MatchingEngine(SymbolTable &symbols)
+    : symbols_(&symbols), orderIndex_(PoolAllocator<char>(nodePool_)) {}
 
 MatchingEngine::~MatchingEngine() {}
 
+void MatchingEngine::reserve(const EngineConfig &config) {
+    nodePool_.setHugePages(config.hugePages);
+    nodePool_.reserve(config.expectedOrders);
+    orderIndex_.reserve(config.expectedOrders);
+}
+
+size_t MatchingEngine::memoryBytes() const {
+    size_t bytes = nodePool_.bytesReserved() +
+                   orderIndex_.bucket_count() * sizeof(void *) +
+                   books_.size() * sizeof(OrderBook);
+    for (const OrderBook &book : books_) {
+        bytes += (book.bids.levels.capacity() + book.asks.levels.capacity()) *
+                 sizeof(PriceLevel);
+    }
+    return bytes;
+}
+
+void MatchingEngine::setExecIdSequence(uint64_t first, uint64_t step) {
+    nextExecId_ = first;
+    execIdStep_ = step;
+}
+
+bool MatchingEngine::inRange(const BookSide &side, int64_t tick) {
+    if (tick < 0) {
+        return false;
+    }
+    auto size = static_cast<int64_t>(side.levels.size());
+    if (side.orderCount == 0 ||
+        (tick >= side.baseTick && tick < side.baseTick + size)) {
+        return true;
+    }
+    int64_t low = std::min(tick, side.baseTick);
+    int64_t high = std::max(tick, side.baseTick + size - 1);
+    return high - low < MAX_LEVELS;
+}
+
+void MatchingEngine::ensureRange(BookSide &side, int64_t tick) {
+    auto size = static_cast<int64_t>(side.levels.size());
+    if (side.orderCount == 0 &&
+        (tick < side.baseTick || tick >= side.baseTick + size)) {
+        // 本边已空，以新价格为中心重建档位数组，不再向远处扩展
+        side.levels.clear();
+    }
+    if (side.levels.empty()) {
+        side.baseTick = std::max<int64_t>(0, tick - INITIAL_LEVELS / 2);
+        side.levels.resize(INITIAL_LEVELS);
+    }
+    if (tick < side.baseTick) {
+        // 向低价方向扩展：在数组头部补空档位并平移基准价位。
+        // 档位中只保存链表头尾指针，整体搬移不影响挂单节点。
+        // 预留量不使数组超过 MAX_LEVELS（inRange 已保证 tick 本身可容纳）
+        int64_t top = side.baseTick + size;
+        int64_t newBase = std::max<int64_t>(
+            {0, tick - GROW_LEVELS, top - MAX_LEVELS});
+        side.levels.insert(side.levels.begin(), side.baseTick - newBase,
+                           PriceLevel{});
+        side.baseTick = newBase;
+    }
+    size = static_cast<int64_t>(side.levels.size());
+    if (tick >= side.baseTick + size) {
+        // 预留量不使数组超过 MAX_LEVELS
+        int64_t needed = tick - side.baseTick + 1;
+        side.levels.resize(std::max(needed, std::min(needed + GROW_LEVELS,
+                                                     MAX_LEVELS)));
+    }
+}
+
+void MatchingEngine::insertNode(BookSide &side, OrderNode *node) {
+    ensureRange(side, node->tick);
+    PriceLevel &level = side.levels[node->tick - side.baseTick];
+
+    // 追加到档位队尾，保证同价时间优先
+    node->prev = level.tail;
+    node->next = nullptr;
+    if (level.tail) {
+        level.tail->next = node;
+    } else {
+        level.head = node;
+    }
+    level.tail = node;
+    level.totalQty += node->order.qty;
+    level.orderCount++;
+
+    if (side.orderCount == 0 ||
+        isBetter(side.side, node->tick, side.bestTick)) {
+        side.bestTick = node->tick;
+    }
+    side.orderCount++;
+}
+
+void MatchingEngine::removeNode(BookSide &side, OrderNode *node) {
+    PriceLevel &level = side.levels[node->tick - side.baseTick];
+
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        level.head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        level.tail = node->prev;
+    }
+    node->prev = node->next = nullptr;
+    level.totalQty -= node->order.qty;
+    level.orderCount--;
+    side.orderCount--;
+
+    if (level.orderCount == 0 && node->tick == side.bestTick) {
+        advanceBest(side);
+    }
+}
+
+void MatchingEngine::advanceBest(BookSide &side) {
+    if (side.orderCount == 0) {
+        return;
+    }
+    // 最优档位已空，向劣价方向寻找下一个非空档位。
+    // 本边仍有挂单，因此一定能在数组范围内找到。
+    int64_t step = side.side == Side::BUY ? -1 : 1;
+    int64_t tick = side.bestTick + step;
+    while (side.levels[tick - side.baseTick].orderCount == 0) {
+        tick += step;
+    }
+    side.bestTick = tick;
+}
+
+void MatchingEngine::eraseNode(OrderNode *node) {
+    removeNode(*node->bookSide, node);
+    // 键存放在即将释放的节点中，先复制再删除
+    ClOrderId clOrderId = node->order.clOrderId;
+    orderIndex_.erase(clOrderId);
+}
+
+MatchingEngine::OrderBook *MatchingEngine::findBook(const Order &order) {
+    SecurityKey key = order.securityKey;
+    if (key == INVALID_KEY) {
+        key = symbols_->findSecurity(order.market, order.securityId);
+    }
+    if (key == INVALID_KEY || key >= books_.size()) {
+        return nullptr;
+    }
+    return &books_[key];
+}
+
+const MatchingEngine::OrderBook *
+MatchingEngine::findBook(const Order &order) const {
+    return const_cast<MatchingEngine *>(this)->findBook(order);
+}
+
+bool MatchingEngine::canRest(const Order &order) const {
+    const OrderBook *book = findBook(order);
+    if (!book) {
+        return true;
+    }
+    const BookSide &side = order.side == Side::BUY ? book->bids : book->asks;
+    return inRange(side, order.price.ticks());
+}
+
 std::optional<MatchingEngine::MatchResult>
 MatchingEngine::match(const Order &order,
                       const std::optional<MarketData> &marketData) {
-    // TODO: 实现撮合逻辑
-    return std::nullopt;
+    MatchResult result;
+    if (!match(order, result)) {
+        return std::nullopt;
+    }
+    return result;
 }
 
-void MatchingEngine::addOrder(const Order &order) {
-    // TODO: 此函数为参考实现，可以随意删除更改
+bool MatchingEngine::match(const Order &order, MatchResult &result) {
+    result.executions.clear();
+    result.remainingQty = order.qty;
+    OrderBook *book = findBook(order);
+    if (!book) {
+        return false;
+    }
+    BookSide &opposite = order.side == Side::BUY ? book->asks : book->bids;
+
+    int64_t limitTick = order.price.ticks();
+    uint32_t remainingQty = order.qty;
+
+    // 价格优先：从对手方最优档位开始逐档撮合；
+    // 时间优先：档位内从队头开始逐笔撮合。
+    while (remainingQty > 0 && opposite.orderCount > 0 &&
+           crosses(order.side, limitTick, opposite.bestTick)) {
+        PriceLevel &level =
+            opposite.levels[opposite.bestTick - opposite.baseTick];
+        OrderNode *maker = level.head;
+        uint32_t execQty = std::min(remainingQty, maker->order.qty);
+
+        // 成交价取被动方挂单价格
+        OrderResponse exec;
+        exec.clOrderId = maker->order.clOrderId;
+        exec.market = maker->order.market;
+        exec.securityId = maker->order.securityId;
+        exec.side = maker->order.side;
+        exec.qty = maker->origQty;
+        exec.price = maker->order.price;
+        exec.shareholderId = maker->order.shareholderId;
+        exec.execId = makeExecId(nextExecId_);
+        nextExecId_ += execIdStep_;
+        exec.execQty = execQty;
+        exec.execPrice = maker->order.price;
+        exec.type = OrderResponse::EXECUTION;
+        result.executions.push_back(std::move(exec));
+
+        remainingQty -= execQty;
+        if (execQty == maker->order.qty) {
+            eraseNode(maker);
+        } else {
+            maker->order.qty -= execQty;
+            level.totalQty -= execQty;
+        }
+    }
+
+    result.remainingQty = remainingQty;
+    return !result.executions.empty();
+}
+
+bool MatchingEngine::addOrder(const Order &order) {
+    SecurityKey key = order.securityKey;
+    if (key == INVALID_KEY) {
+        key = symbols_->internSecurity(order.market, order.securityId);
+    }
+    if (key >= books_.size()) {
+        books_.resize(key + 1);
+    }
+    OrderBook &book = books_[key];
+    BookSide &side = order.side == Side::BUY ? book.bids : book.asks;
+    int64_t tick = order.price.ticks();
+    if (!inRange(side, tick)) {
+        return false;
+    }
+
+    auto [indexIt, inserted] = orderIndex_.try_emplace(order.clOrderId);
+    if (!inserted) {
+        return true;
+    }
+    OrderNode *node = &indexIt->second;
+    try {
+        // 扩展档位数组可能分配失败，此时撤回索引项，不留下未入簿的节点
+        ensureRange(side, tick);
+    } catch (...) {
+        orderIndex_.erase(indexIt);
+        throw;
+    }
+    node->order = order;
+    node->origQty = order.qty;
+    node->tick = tick;
+    node->bookSide = &side;
+    insertNode(side, node);
+    return true;
+}
+
+void MatchingEngine::restoreOrder(const Order &order, uint32_t origQty) {
+    addOrder(order);
+    auto indexIt = orderIndex_.find(order.clOrderId);
+    if (indexIt != orderIndex_.end()) {
+        indexIt->second.origQty = origQty;
+    }
 }
 
-CancelResponse MatchingEngine::cancelOrder(const std::string &clOrderId) {
-    // TODO: 此函数为参考实现，可以随意删除更改
+CancelResponse MatchingEngine::cancelOrder(const ClOrderId &clOrderId) {
     CancelResponse response;
-    // response.clOrderId = ...;
     response.origClOrderId = clOrderId;
-    // response.market = ...;
-    // response.securityId = ...;
-    // response.shareholderId = ...;
-    // response.side = ...;
-    // response.qty = ...;
-    // response.price = ...;
-    // response.cumQty = ...;
-    // response.canceledQty = ...;
+
+    auto indexIt = orderIndex_.find(clOrderId);
+    if (indexIt == orderIndex_.end()) {
+        response.rejectCode = CANCEL_ORDER_NOT_FOUND_REJECT_CODE;
+        response.rejectText = CANCEL_ORDER_NOT_FOUND_REJECT_REASON;
+        response.type = CancelResponse::REJECT;
+        return response;
+    }
+
+    OrderNode *node = &indexIt->second;
+    response.market = node->order.market;
+    response.securityId = node->order.securityId;
+    response.shareholderId = node->order.shareholderId;
+    response.side = node->order.side;
+    response.qty = node->origQty;
+    response.price = node->order.price;
+    response.cumQty = node->origQty - node->order.qty;
+    response.canceledQty = node->order.qty;
+    response.type = CancelResponse::CONFIRM;
+
+    eraseNode(node);
     return response;
 }
 
-void MatchingEngine::reduceOrderQty(const std::string &clOrderId,
+void MatchingEngine::reduceOrderQty(const ClOrderId &clOrderId,
                                     uint32_t qty) {
-    // TODO: 在订单簿中找到clOrderId对应的订单，减少qty
-    // 若减少后数量为0，则从订单簿中移除
+    auto indexIt = orderIndex_.find(clOrderId);
+    if (indexIt == orderIndex_.end()) {
+        return;
+    }
+    OrderNode *node = &indexIt->second;
+    if (qty >= node->order.qty) {
+        eraseNode(node);
+        return;
+    }
+    BookSide &side = *node->bookSide;
+    node->order.qty -= qty;
+    side.levels[node->tick - side.baseTick].totalQty -= qty;
 }
 
 } // namespace hdf
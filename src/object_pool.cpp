@@ -0,0 +1,109 @@
+#include "object_pool.h"
+#include <algorithm>
+#include <sys/mman.h>
+
+namespace hdf {
+
+namespace {
+
+constexpr size_t BLOCK_ALIGN = alignof(std::max_align_t);
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+size_t roundUp(size_t n, size_t align) { return (n + align - 1) / align * align; }
+
+} // namespace
+
+BlockPool::BlockPool(size_t blockSize, size_t blocksPerSlab)
+    : blockSize_(blockSize ? roundUp(blockSize, BLOCK_ALIGN) : 0),
+      blocksPerSlab_(blocksPerSlab) {}
+
+BlockPool::~BlockPool() {
+    for (const auto &slab : slabs_) {
+        if (slab.mapped) {
+            munmap(slab.memory, slab.bytes);
+        } else {
+            ::operator delete(slab.memory, std::align_val_t(BLOCK_ALIGN));
+        }
+    }
+}
+
+bool BlockPool::accepts(size_t size) {
+    if (blockSize_ == 0) {
+        blockSize_ = roundUp(size, BLOCK_ALIGN);
+        if (pendingReserve_ > 0) {
+            size_t blocks = pendingReserve_;
+            pendingReserve_ = 0;
+            reserve(blocks);
+        }
+    }
+    return size <= blockSize_;
+}
+
+void BlockPool::reserve(size_t blocks) {
+    if (blockSize_ == 0) {
+        pendingReserve_ = std::max(pendingReserve_, blocks);
+        return;
+    }
+    size_t freeBlocks = capacity_ - inUse_;
+    if (blocks > freeBlocks) {
+        addSlab(blocks - freeBlocks);
+    }
+}
+
+void *BlockPool::allocate() {
+    if (!freeList_) {
+        addSlab(blocksPerSlab_);
+    }
+    FreeBlock *block = freeList_;
+    freeList_ = block->next;
+    inUse_++;
+    return block;
+}
+
+void BlockPool::deallocate(void *p) {
+    FreeBlock *block = static_cast<FreeBlock *>(p);
+    block->next = freeList_;
+    freeList_ = block;
+    inUse_--;
+}
+
+void BlockPool::addSlab(size_t blocks) {
+    size_t bytes = blocks * blockSize_;
+    Slab slab{nullptr, bytes, false};
+
+    if (hugePages_) {
+        // 优先使用显式大页，未配置大页时退回普通页并建议合并为透明大页
+        size_t hugeBytes = roundUp(bytes, HUGE_PAGE_SIZE);
+        void *p = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p == MAP_FAILED) {
+            p = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, hugeBytes, MADV_HUGEPAGE);
+            }
+        }
+        if (p != MAP_FAILED) {
+            slab = Slab{p, hugeBytes, true};
+            bytes = hugeBytes;
+            blocks = hugeBytes / blockSize_;
+        }
+    }
+    if (!slab.memory) {
+        slab.memory = ::operator new(bytes, std::align_val_t(BLOCK_ALIGN));
+    }
+    slabs_.push_back(slab);
+    bytesReserved_ += bytes;
+
+    // 逆序串入空闲链表，使分配顺序与内存地址顺序一致；
+    // 同时写遍每个块，提前触发缺页。
+    char *base = static_cast<char *>(slab.memory);
+    for (size_t i = blocks; i-- > 0;) {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(base + i * blockSize_);
+        block->next = freeList_;
+        freeList_ = block;
+    }
+    capacity_ += blocks;
+}
+
+} // namespace hdf
@@ -0,0 +1,234 @@
+#include "order_flow.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace hdf {
+
+namespace {
+
+// 记住的在途订单数上限，超出后随机覆盖旧的
+constexpr size_t MAX_LIVE_ORDERS = size_t{1} << 20;
+// 被动订单离己方最优价的价位数按几何分布，该参数越大越集中在最优价附近
+constexpr double PASSIVE_LEVEL_P = 0.3;
+constexpr uint32_t MAX_PASSIVE_LEVELS = 20;
+// 主动订单越过对手方最优价的价位数
+constexpr uint32_t MAX_AGGRESSIVE_LEVELS = 2;
+// 每笔订单后中间价移动一个价位的概率
+constexpr double MID_MOVE_P = 0.05;
+constexpr int64_t MIN_MID_TICK = 200;
+
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 把 value 左补零写入宽度为 width 的字段，位数超出时抛出异常
+void writeDigits(char *field, size_t width, uint64_t value) {
+    char buf[20];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+    auto len = static_cast<size_t>(end - buf);
+    if (ec != std::errc() || len > width) {
+        throw std::invalid_argument("order flow: code does not fit");
+    }
+    std::fill(field, field + width - len, '0');
+    std::copy(buf, end, field + width - len);
+}
+
+// 64位乘法的高64位
+uint64_t mulHigh(uint64_t a, uint64_t b) {
+    uint64_t aLo = a & 0xFFFFFFFF, aHi = a >> 32;
+    uint64_t bLo = b & 0xFFFFFFFF, bHi = b >> 32;
+    uint64_t lo = aLo * bLo;
+    uint64_t mid1 = aHi * bLo + (lo >> 32);
+    uint64_t mid2 = aLo * bHi + (mid1 & 0xFFFFFFFF);
+    return aHi * bHi + (mid1 >> 32) + (mid2 >> 32);
+}
+
+} // namespace
+
+OrderFlowGenerator::OrderFlowGenerator(const OrderFlowConfig &config)
+    : config_(config), rngState_(config.seed),
+      nextId_(config.firstOrderId) {
+    if (config_.securities > OrderFlowConfig::MAX_SECURITIES) {
+        throw std::invalid_argument("order flow: too many securities");
+    }
+    if (config_.shareholders > OrderFlowConfig::MAX_SHAREHOLDERS) {
+        throw std::invalid_argument("order flow: too many shareholders");
+    }
+    size_t securityCount = std::max<size_t>(config_.securities, 1);
+    size_t shareholderCount = std::max<size_t>(config_.shareholders, 1);
+
+    securities_.reserve(securityCount);
+    double total = 0;
+    for (size_t i = 0; i < securityCount; ++i) {
+        // 偶数编号为沪市 600000 起，奇数编号为深市 000001 起
+        bool sh = i % 2 == 0;
+        char code[6];
+        writeDigits(code, sizeof(code), (sh ? 600000 : 1) + i / 2);
+        Security security;
+        security.market = sh ? Market::XSHG : Market::XSHE;
+        security.securityId = SecurityId(std::string_view(code, 6));
+        // 价格在 5.00 到 50.00 元之间
+        security.midTick = 500 + static_cast<int64_t>(below(4500));
+        securities_.push_back(security);
+
+        total += 1.0 / std::pow(static_cast<double>(i + 1),
+                                config_.zipfExponent);
+        zipfCdf_.push_back(total);
+    }
+    for (double &p : zipfCdf_) {
+        p /= total;
+    }
+
+    shareholders_.reserve(shareholderCount);
+    for (size_t i = 0; i < shareholderCount; ++i) {
+        // 股东号形如 A000000001，10位
+        char code[10] = {'A'};
+        writeDigits(code + 1, sizeof(code) - 1, i + 1);
+        shareholders_.emplace_back(std::string_view(code, sizeof(code)));
+    }
+    live_.reserve(std::min(MAX_LIVE_ORDERS, size_t{1} << 16));
+}
+
+uint64_t OrderFlowGenerator::nextRandom() {
+    // splitmix64
+    rngState_ += 0x9E3779B97F4A7C15ULL;
+    return mix64(rngState_);
+}
+
+double OrderFlowGenerator::uniform() {
+    return static_cast<double>(nextRandom() >> 11) * 0x1.0p-53;
+}
+
+uint64_t OrderFlowGenerator::below(uint64_t n) {
+    // 乘法取高位，偏差可以忽略
+    return mulHigh(nextRandom(), n);
+}
+
+uint32_t OrderFlowGenerator::geometric(double p, uint32_t max) {
+    uint32_t k = 0;
+    while (k < max && uniform() >= p) {
+        k++;
+    }
+    return k;
+}
+
+uint32_t OrderFlowGenerator::pickSecurity() {
+    double u = uniform();
+    auto it = std::upper_bound(zipfCdf_.begin(), zipfCdf_.end(), u);
+    if (it == zipfCdf_.end()) {
+        --it;
+    }
+    return static_cast<uint32_t>(it - zipfCdf_.begin());
+}
+
+Side OrderFlowGenerator::sideOf(uint32_t shareholder,
+                                uint32_t security) const {
+    uint64_t h = mix64(config_.seed ^
+                       (static_cast<uint64_t>(shareholder) << 32 | security));
+    return h & 1 ? Side::BUY : Side::SELL;
+}
+
+ClOrderId OrderFlowGenerator::makeId() {
+    char buf[ClOrderId::CAPACITY];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), nextId_++);
+    return ClOrderId(std::string_view(buf, end - buf));
+}
+
+const OrderFlowGenerator::Message &OrderFlowGenerator::next() {
+    generated_++;
+    if (!live_.empty() && uniform() < config_.cancelRatio) {
+        makeCancel();
+        return message_;
+    }
+    if (!live_.empty() && uniform() < config_.selfCrossRatio) {
+        // 与一笔在途订单同股东、同股票、反方向
+        const LiveOrder &target = live_[below(live_.size())];
+        makeOrder(target.security, target.shareholder,
+                  target.side == Side::BUY ? Side::SELL : Side::BUY, false);
+        // 对敲订单不记入在途订单，以免之后的普通订单与之对敲
+        return message_;
+    }
+    uint32_t security = pickSecurity();
+    auto shareholder = static_cast<uint32_t>(below(shareholders_.size()));
+    makeOrder(security, shareholder, sideOf(shareholder, security),
+              uniform() < config_.aggressiveness);
+    remember(security, shareholder);
+    return message_;
+}
+
+void OrderFlowGenerator::makeOrder(uint32_t security, uint32_t shareholder,
+                                   Side side, bool aggressive) {
+    Security &s = securities_[security];
+    int64_t bestBid = s.midTick - 1;
+    int64_t bestAsk = s.midTick + 1;
+    int64_t tick;
+    if (aggressive) {
+        int64_t through = geometric(0.5, MAX_AGGRESSIVE_LEVELS);
+        tick = side == Side::BUY ? bestAsk + through : bestBid - through;
+    } else {
+        int64_t away = geometric(PASSIVE_LEVEL_P, MAX_PASSIVE_LEVELS);
+        tick = side == Side::BUY ? bestBid - away : bestAsk + away;
+    }
+
+    uint32_t qty;
+    if (side == Side::SELL && uniform() < config_.oddLotSellRatio) {
+        qty = 1 + static_cast<uint32_t>(below(99));
+    } else {
+        qty = 100 * (1 + geometric(0.4, 49));
+    }
+
+    Order &order = message_.order;
+    order = Order{};
+    order.clOrderId = makeId();
+    order.market = s.market;
+    order.securityId = s.securityId;
+    order.side = side;
+    order.price = Price::fromRaw(tick * Price::TICK);
+    order.qty = qty;
+    order.shareholderId = shareholders_[shareholder];
+    message_.kind = Message::Kind::ORDER;
+
+    if (uniform() < MID_MOVE_P) {
+        s.midTick += uniform() < 0.5 ? -1 : 1;
+        s.midTick = std::max(s.midTick, MIN_MID_TICK);
+    }
+}
+
+void OrderFlowGenerator::remember(uint32_t security, uint32_t shareholder) {
+    LiveOrder live;
+    live.clOrderId = message_.order.clOrderId;
+    live.security = security;
+    live.shareholder = shareholder;
+    live.side = message_.order.side;
+    if (live_.size() < MAX_LIVE_ORDERS) {
+        live_.push_back(live);
+    } else {
+        live_[below(live_.size())] = live;
+    }
+}
+
+void OrderFlowGenerator::makeCancel() {
+    size_t index = below(live_.size());
+    LiveOrder target = live_[index];
+    live_[index] = live_.back();
+    live_.pop_back();
+
+    const Security &s = securities_[target.security];
+    CancelOrder &cancel = message_.cancel;
+    cancel = CancelOrder{};
+    cancel.clOrderId = makeId();
+    cancel.origClOrderId = target.clOrderId;
+    cancel.market = s.market;
+    cancel.securityId = s.securityId;
+    cancel.shareholderId = shareholders_[target.shareholder];
+    cancel.side = target.side;
+    message_.kind = Message::Kind::CANCEL;
+}
+
+} // namespace hdf
@@ -0,0 +1,546 @@
+#include "order_parser.h"
+#include <bit>
+#include <charconv>
+
+namespace hdf {
+
+namespace {
+
+constexpr const char *MALFORMED = "malformed JSON";
+// 嵌套层数上限，防止恶意输入耗尽栈空间
+constexpr int MAX_DEPTH = 64;
+// 字段名解码缓冲区，足够容纳所有已知字段名
+constexpr size_t KEY_BUFFER_SIZE = 32;
+
+/**
+ * @brief 在原始文本上前进的 JSON 词法扫描器。
+ */
+class Scanner {
+  public:
+    explicit Scanner(std::string_view text)
+        : p_(text.data()), end_(text.data() + text.size()) {}
+
+    void skipSpace() {
+        while (p_ != end_ &&
+               (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+            ++p_;
+        }
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return p_ == end_;
+    }
+
+    char peek() {
+        skipSpace();
+        return p_ == end_ ? '\0' : *p_;
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (p_ != end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 读取一个字符串。
+     * 不含转义时 out 直接指向原文；含转义时解码到 buffer，
+     * 超出 capacity 的部分丢弃并置 truncated（字符串仍被完整跳过）。
+     */
+    bool readString(std::string_view &out, char *buffer, size_t capacity,
+                    bool &truncated);
+
+    /**
+     * @brief 读取一个符合 JSON 语法的数字，out 指向原文。
+     */
+    bool readNumber(std::string_view &out);
+
+    bool skipValue(int depth = 0);
+
+  private:
+    const char *p_;
+    const char *end_;
+
+    bool consumeLiteral(std::string_view literal);
+    bool readHex4(uint32_t &value);
+    bool skipDigits();
+};
+
+bool Scanner::readString(std::string_view &out, char *buffer,
+                         size_t capacity, bool &truncated) {
+    truncated = false;
+    if (!consume('"')) {
+        return false;
+    }
+    const char *begin = p_;
+    while (p_ != end_ && *p_ != '"' && *p_ != '\\') {
+        if (static_cast<unsigned char>(*p_) < 0x20) {
+            return false;
+        }
+        ++p_;
+    }
+    if (p_ == end_) {
+        return false;
+    }
+    if (*p_ == '"') {
+        out = std::string_view(begin, p_ - begin);
+        ++p_;
+        return true;
+    }
+
+    // 含转义，逐字符解码
+    size_t size = 0;
+    auto put = [&](char c) {
+        if (size < capacity) {
+            buffer[size++] = c;
+        } else {
+            truncated = true;
+        }
+    };
+    for (const char *q = begin; q != p_; ++q) {
+        put(*q);
+    }
+    while (true) {
+        if (p_ == end_) {
+            return false;
+        }
+        char c = *p_++;
+        if (c == '"') {
+            break;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) {
+            return false;
+        }
+        if (c != '\\') {
+            put(c);
+            continue;
+        }
+        if (p_ == end_) {
+            return false;
+        }
+        switch (char escape = *p_++) {
+        case '"':
+        case '\\':
+        case '/':
+            put(escape);
+            break;
+        case 'b':
+            put('\b');
+            break;
+        case 'f':
+            put('\f');
+            break;
+        case 'n':
+            put('\n');
+            break;
+        case 'r':
+            put('\r');
+            break;
+        case 't':
+            put('\t');
+            break;
+        case 'u': {
+            uint32_t cp;
+            if (!readHex4(cp)) {
+                return false;
+            }
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                // 代理对
+                uint32_t low;
+                if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') {
+                    return false;
+                }
+                p_ += 2;
+                if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                    return false;
+                }
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                return false;
+            }
+            // 编码为 UTF-8
+            if (cp < 0x80) {
+                put(static_cast<char>(cp));
+            } else if (cp < 0x800) {
+                put(static_cast<char>(0xC0 | (cp >> 6)));
+                put(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else if (cp < 0x10000) {
+                put(static_cast<char>(0xE0 | (cp >> 12)));
+                put(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                put(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else {
+                put(static_cast<char>(0xF0 | (cp >> 18)));
+                put(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                put(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                put(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    out = std::string_view(buffer, size);
+    return true;
+}
+
+bool Scanner::readHex4(uint32_t &value) {
+    if (end_ - p_ < 4) {
+        return false;
+    }
+    auto [ptr, ec] = std::from_chars(p_, p_ + 4, value, 16);
+    if (ec != std::errc() || ptr != p_ + 4) {
+        return false;
+    }
+    p_ += 4;
+    return true;
+}
+
+bool Scanner::skipDigits() {
+    const char *begin = p_;
+    while (p_ != end_ && *p_ >= '0' && *p_ <= '9') {
+        ++p_;
+    }
+    return p_ != begin;
+}
+
+bool Scanner::readNumber(std::string_view &out) {
+    skipSpace();
+    const char *begin = p_;
+    if (p_ != end_ && *p_ == '-') {
+        ++p_;
+    }
+    // 整数部分不允许前导零
+    if (p_ != end_ && *p_ == '0') {
+        ++p_;
+    } else if (!skipDigits()) {
+        return false;
+    }
+    if (p_ != end_ && *p_ == '.') {
+        ++p_;
+        if (!skipDigits()) {
+            return false;
+        }
+    }
+    if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+        ++p_;
+        if (p_ != end_ && (*p_ == '+' || *p_ == '-')) {
+            ++p_;
+        }
+        if (!skipDigits()) {
+            return false;
+        }
+    }
+    out = std::string_view(begin, p_ - begin);
+    return true;
+}
+
+bool Scanner::consumeLiteral(std::string_view literal) {
+    if (static_cast<size_t>(end_ - p_) < literal.size() ||
+        std::string_view(p_, literal.size()) != literal) {
+        return false;
+    }
+    p_ += literal.size();
+    return true;
+}
+
+bool Scanner::skipValue(int depth) {
+    if (depth > MAX_DEPTH) {
+        return false;
+    }
+    std::string_view ignored;
+    bool truncated;
+    switch (peek()) {
+    case '"':
+        return readString(ignored, nullptr, 0, truncated);
+    case '{':
+        consume('{');
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            if (!readString(ignored, nullptr, 0, truncated) || !consume(':') ||
+                !skipValue(depth + 1)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    case '[':
+        consume('[');
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            if (!skipValue(depth + 1)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']');
+    case 't':
+        return consumeLiteral("true");
+    case 'f':
+        return consumeLiteral("false");
+    case 'n':
+        return consumeLiteral("null");
+    default:
+        return readNumber(ignored);
+    }
+}
+
+/**
+ * @brief 遍历顶层对象的字段，对每个字段调用 onField(key, scanner)。
+ * onField 须读取或跳过字段值，返回错误描述或 nullptr。
+ */
+template <typename OnField>
+const char *walkObject(Scanner &in, OnField &&onField) {
+    if (!in.consume('{')) {
+        return "expected JSON object";
+    }
+    if (!in.consume('}')) {
+        do {
+            char keyBuffer[KEY_BUFFER_SIZE];
+            std::string_view key;
+            bool truncated;
+            if (!in.readString(key, keyBuffer, sizeof(keyBuffer), truncated) ||
+                !in.consume(':')) {
+                return MALFORMED;
+            }
+            if (truncated) {
+                // 过长的字段名不可能是已知字段
+                if (!in.skipValue()) {
+                    return MALFORMED;
+                }
+                continue;
+            }
+            if (const char *error = onField(key, in)) {
+                return error;
+            }
+        } while (in.consume(','));
+        if (!in.consume('}')) {
+            return MALFORMED;
+        }
+    }
+    if (!in.atEnd()) {
+        return MALFORMED;
+    }
+    return nullptr;
+}
+
+template <size_t N> const char *readId(Scanner &in, FixedString<N> &out) {
+    if (in.peek() != '"') {
+        return "identifier must be a string";
+    }
+    char buffer[N];
+    std::string_view value;
+    bool truncated;
+    if (!in.readString(value, buffer, N, truncated)) {
+        return MALFORMED;
+    }
+    if (truncated || value.size() > N) {
+        return "identifier too long";
+    }
+    out.assign(value);
+    return nullptr;
+}
+
+const char *readMarket(Scanner &in, Market &market) {
+    if (in.peek() != '"') {
+        return "market must be a string";
+    }
+    char buffer[8];
+    std::string_view value;
+    bool truncated;
+    if (!in.readString(value, buffer, sizeof(buffer), truncated)) {
+        return MALFORMED;
+    }
+    auto parsed = parse_market(value);
+    if (truncated || !parsed) {
+        return "invalid market";
+    }
+    market = *parsed;
+    return nullptr;
+}
+
+const char *readSide(Scanner &in, Side &side) {
+    if (in.peek() != '"') {
+        return "side must be a string";
+    }
+    char buffer[8];
+    std::string_view value;
+    bool truncated;
+    if (!in.readString(value, buffer, sizeof(buffer), truncated)) {
+        return MALFORMED;
+    }
+    auto parsed = parse_side(value);
+    if (truncated || !parsed) {
+        return "invalid side";
+    }
+    side = *parsed;
+    return nullptr;
+}
+
+const char *readPrice(Scanner &in, Price &price) {
+    char c = in.peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return "price must be a number";
+    }
+    std::string_view token;
+    if (!in.readNumber(token)) {
+        return MALFORMED;
+    }
+    double value;
+    auto [ptr, ec] =
+        std::from_chars(token.data(), token.data() + token.size(), value);
+    if (ec != std::errc() || ptr != token.data() + token.size()) {
+        return "price out of range";
+    }
+    price = Price::fromDouble(value);
+    return nullptr;
+}
+
+const char *readQty(Scanner &in, uint32_t &qty) {
+    char c = in.peek();
+    if (c != '-' && (c < '0' || c > '9')) {
+        return "qty must be a number";
+    }
+    std::string_view token;
+    if (!in.readNumber(token)) {
+        return MALFORMED;
+    }
+    auto [ptr, ec] =
+        std::from_chars(token.data(), token.data() + token.size(), qty);
+    if (ec != std::errc() || ptr != token.data() + token.size()) {
+        return "qty must be an unsigned 32-bit integer";
+    }
+    return nullptr;
+}
+
+const char *skipField(Scanner &in) {
+    return in.skipValue() ? nullptr : MALFORMED;
+}
+
+// 按位记录出现过的字段，缺失时按位序取错误描述
+const char *missingField(unsigned seen, unsigned all,
+                         const char *const *messages) {
+    unsigned missing = all & ~seen;
+    return missing ? messages[std::countr_zero(missing)] : nullptr;
+}
+
+} // namespace
+
+const char *parseOrder(std::string_view text, Order &order) {
+    static constexpr const char *MISSING[] = {
+        "missing field: clOrderId", "missing field: market",
+        "missing field: securityId", "missing field: side",
+        "missing field: price",      "missing field: qty",
+        "missing field: shareholderId"};
+    unsigned seen = 0;
+
+    Scanner in(text);
+    const char *error = walkObject(
+        in, [&](std::string_view key, Scanner &in) -> const char * {
+            if (key == "clOrderId") {
+                seen |= 1u << 0;
+                return readId(in, order.clOrderId);
+            }
+            if (key == "market") {
+                seen |= 1u << 1;
+                return readMarket(in, order.market);
+            }
+            if (key == "securityId") {
+                seen |= 1u << 2;
+                return readId(in, order.securityId);
+            }
+            if (key == "side") {
+                seen |= 1u << 3;
+                return readSide(in, order.side);
+            }
+            if (key == "price") {
+                seen |= 1u << 4;
+                return readPrice(in, order.price);
+            }
+            if (key == "qty") {
+                seen |= 1u << 5;
+                return readQty(in, order.qty);
+            }
+            if (key == "shareholderId") {
+                seen |= 1u << 6;
+                return readId(in, order.shareholderId);
+            }
+            return skipField(in);
+        });
+    if (error) {
+        return error;
+    }
+    if (const char *missing = missingField(seen, 0x7F, MISSING)) {
+        return missing;
+    }
+    order.securityKey = INVALID_KEY;
+    order.shareholderKey = INVALID_KEY;
+    return validateOrder(order);
+}
+
+const char *parseCancelOrder(std::string_view text, CancelOrder &cancel) {
+    static constexpr const char *MISSING[] = {
+        "missing field: clOrderId",     "missing field: origClOrderId",
+        "missing field: market",        "missing field: securityId",
+        "missing field: shareholderId", "missing field: side"};
+    unsigned seen = 0;
+
+    Scanner in(text);
+    const char *error = walkObject(
+        in, [&](std::string_view key, Scanner &in) -> const char * {
+            if (key == "clOrderId") {
+                seen |= 1u << 0;
+                return readId(in, cancel.clOrderId);
+            }
+            if (key == "origClOrderId") {
+                seen |= 1u << 1;
+                return readId(in, cancel.origClOrderId);
+            }
+            if (key == "market") {
+                seen |= 1u << 2;
+                return readMarket(in, cancel.market);
+            }
+            if (key == "securityId") {
+                seen |= 1u << 3;
+                return readId(in, cancel.securityId);
+            }
+            if (key == "shareholderId") {
+                seen |= 1u << 4;
+                return readId(in, cancel.shareholderId);
+            }
+            if (key == "side") {
+                seen |= 1u << 5;
+                return readSide(in, cancel.side);
+            }
+            return skipField(in);
+        });
+    if (error) {
+        return error;
+    }
+    return missingField(seen, 0x3F, MISSING);
+}
+
+ClOrderId findIdField(std::string_view text, std::string_view key) {
+    ClOrderId result;
+    Scanner in(text);
+    walkObject(in,
+               [&](std::string_view field, Scanner &in) -> const char * {
+                   if (field == key && in.peek() == '"') {
+                       ClOrderId value;
+                       if (readId(in, value) == nullptr) {
+                           result = value;
+                       }
+                       return nullptr;
+                   }
+                   return skipField(in);
+               });
+    return result;
+}
+
+} // namespace hdf
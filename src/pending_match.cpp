@@ -0,0 +1,168 @@
+#include "pending_match.h"
+#include <algorithm>
+#include <charconv>
+
+namespace hdf {
+
+namespace {
+
+// 槽号和序号都用36进制：32位槽号最多7位、64位序号最多13位，放得进 ClOrderId
+constexpr int CANCEL_ID_BASE = 36;
+
+} // namespace
+
+void PendingMatchTable::reserve(size_t matches) {
+    slots_.reserve(matches);
+    free_.reserve(matches);
+}
+
+size_t PendingMatchTable::memoryBytes() const {
+    size_t bytes = slots_.capacity() * sizeof(Match) +
+                   free_.capacity() * sizeof(uint32_t) +
+                   expired_.capacity() * sizeof(ExpiredCancel);
+    for (const Match &match : slots_) {
+        bytes += match.executions.capacity() * sizeof(OrderResponse) +
+                 (match.answered.capacity() + match.confirmed.capacity()) *
+                     sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+void PendingMatchTable::setCancelIdSequence(uint64_t first, uint64_t step) {
+    nextCancelSeq_ = first;
+    cancelSeqStep_ = step;
+}
+
+uint32_t PendingMatchTable::acquire(const Order &activeOrder,
+                                    std::span<const OrderResponse> executions,
+                                    uint32_t remainingQty) {
+    uint32_t slot;
+    if (free_.empty()) {
+        slot = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    } else {
+        slot = free_.back();
+        free_.pop_back();
+    }
+    // 复用槽中数组的容量
+    Match &match = slots_[slot];
+    match.activeOrder = activeOrder;
+    match.executions.assign(executions.begin(), executions.end());
+    size_t words = (executions.size() + 63) / 64;
+    match.answered.assign(words, 0);
+    match.confirmed.assign(words, 0);
+    match.firstCancelSeq = nextCancelSeq_;
+    match.timer = 0;
+    match.acquiredNs = 0;
+    match.remainingQty = remainingQty;
+    match.pendingCancelCount = static_cast<uint32_t>(executions.size());
+    nextCancelSeq_ += executions.size() * cancelSeqStep_;
+    return slot;
+}
+
+void PendingMatchTable::restoreSlots(size_t slotCount,
+                                     std::span<const uint32_t> freeSlots) {
+    slots_.clear();
+    slots_.resize(slotCount);
+    free_.assign(freeSlots.begin(), freeSlots.end());
+}
+
+void PendingMatchTable::release(uint32_t slot) {
+    slots_[slot].firstCancelSeq = 0;
+    free_.push_back(slot);
+}
+
+void PendingMatchTable::expire(uint32_t slot) {
+    Match &match = slots_[slot];
+    if (expired_.empty()) {
+        expired_.resize(EXPIRED_HISTORY);
+    }
+    for (size_t i = 0; i < match.executions.size(); ++i) {
+        if (!(match.answered[i / 64] >> (i % 64) & 1)) {
+            ExpiredCancel &e = expired_[expiredNext_++ % EXPIRED_HISTORY];
+            e.seq = match.firstCancelSeq + i * cancelSeqStep_;
+            e.origClOrderId = match.executions[i].clOrderId;
+        }
+    }
+    // 未回报的位在 confirmed 中本来就是0，即被拒
+    std::fill(match.answered.begin(), match.answered.end(), ~uint64_t{0});
+    match.pendingCancelCount = 0;
+}
+
+PendingMatchTable::Answer PendingMatchTable::takeExpired(uint64_t seq,
+                                                         uint32_t &index) {
+    // 只在迟到或重复的回报上查找，不在正常回报的路径上
+    for (size_t i = 0; i < expired_.size(); ++i) {
+        if (expired_[i].seq == seq) {
+            expired_[i].seq = 0;
+            index = static_cast<uint32_t>(i);
+            return Answer::LATE;
+        }
+    }
+    return Answer::STALE;
+}
+
+ClOrderId PendingMatchTable::cancelId(uint32_t slot, size_t exec) const {
+    return makeCancelId(slot,
+                        slots_[slot].firstCancelSeq + exec * cancelSeqStep_);
+}
+
+ClOrderId PendingMatchTable::makeCancelId(uint32_t slot, uint64_t seq) {
+    char buf[ClOrderId::CAPACITY];
+    char *end = buf + sizeof(buf);
+    buf[0] = CANCEL_ID_PREFIX;
+    char *p = std::to_chars(buf + 1, end, slot, CANCEL_ID_BASE).ptr;
+    *p++ = '.';
+    p = std::to_chars(p, end, seq, CANCEL_ID_BASE).ptr;
+    return ClOrderId(std::string_view(buf, p - buf));
+}
+
+bool PendingMatchTable::parseCancelId(const ClOrderId &cancelId,
+                                      uint32_t &slot, uint64_t &seq) {
+    const char *p = cancelId.data();
+    const char *end = p + cancelId.size();
+    if (p == end || *p != CANCEL_ID_PREFIX) {
+        return false;
+    }
+    auto [dot, ec] = std::from_chars(p + 1, end, slot, CANCEL_ID_BASE);
+    if (ec != std::errc() || dot == end || *dot != '.') {
+        return false;
+    }
+    auto [last, ec2] = std::from_chars(dot + 1, end, seq, CANCEL_ID_BASE);
+    return ec2 == std::errc() && last == end;
+}
+
+PendingMatchTable::Answer PendingMatchTable::answer(const ClOrderId &cancelId,
+                                                    bool confirmed,
+                                                    uint32_t &slot) {
+    uint64_t seq = 0;
+    if (!parseCancelId(cancelId, slot, seq)) {
+        return Answer::NOT_OURS;
+    }
+
+    if (slot >= slots_.size()) {
+        return takeExpired(seq, slot);
+    }
+    Match &match = slots_[slot];
+    // 槽已释放或被复用时序号落不到本撮合的成交范围内
+    if (match.firstCancelSeq == 0 || seq < match.firstCancelSeq ||
+        (seq - match.firstCancelSeq) % cancelSeqStep_ != 0) {
+        return takeExpired(seq, slot);
+    }
+    size_t exec = (seq - match.firstCancelSeq) / cancelSeqStep_;
+    if (exec >= match.executions.size()) {
+        return takeExpired(seq, slot);
+    }
+    uint64_t bit = uint64_t{1} << (exec % 64);
+    if (match.answered[exec / 64] & bit) {
+        return takeExpired(seq, slot);
+    }
+    match.answered[exec / 64] |= bit;
+    if (confirmed) {
+        match.confirmed[exec / 64] |= bit;
+    }
+    return --match.pendingCancelCount == 0 ? Answer::COMPLETE
+                                           : Answer::PENDING;
+}
+
+} // namespace hdf
@@ -0,0 +1,116 @@
+#include "pipelined_trade_system.h"
+#include "order_parser.h"
+
+namespace hdf {
+
+PipelinedTradeSystem::PipelinedTradeSystem(ClientSink &clientSink,
+                                           ExchangeSink *exchangeSink,
+                                           const EngineConfig &config,
+                                           size_t ringCapacity)
+    : clientSink_(clientSink), exchangeSink_(exchangeSink),
+      inbound_(ringCapacity), outbound_(ringCapacity), egressSink_(outbound_),
+      core_(config), timed_(config.pendingCancelTimeoutNs > 0) {
+    core_.setClientSink(&egressSink_);
+    if (exchangeSink_) {
+        core_.setExchangeSink(&egressSink_);
+    }
+    coreThread_ = std::thread([this] { coreLoop(); });
+    egressThread_ = std::thread([this] { egressLoop(); });
+}
+
+PipelinedTradeSystem::~PipelinedTradeSystem() { stop(); }
+
+void PipelinedTradeSystem::stop() {
+    if (stopped_) {
+        return;
+    }
+    stopped_ = true;
+    inputClosed_.store(true, std::memory_order_release);
+    coreThread_.join();
+    egressThread_.join();
+}
+
+void PipelinedTradeSystem::submitOrder(const Order &order) {
+    inbound_.push(InboundMessage{InboundMessage::ORDER, order});
+}
+
+void PipelinedTradeSystem::submitCancel(const CancelOrder &cancel) {
+    inbound_.push(InboundMessage{InboundMessage::CANCEL, cancel});
+}
+
+void PipelinedTradeSystem::submitResponse(const OrderResponse &response) {
+    inbound_.push(InboundMessage{InboundMessage::ORDER_RESPONSE, response});
+}
+
+void PipelinedTradeSystem::submitResponse(const CancelResponse &response) {
+    inbound_.push(InboundMessage{InboundMessage::CANCEL_RESPONSE, response});
+}
+
+void PipelinedTradeSystem::submitOrderRaw(std::string_view input) {
+    Order order;
+    if (const char *error = parseOrder(input, order)) {
+        inbound_.push(InboundMessage{
+            InboundMessage::ORDER_REJECT,
+            makeInvalidOrderReject(findIdField(input, "clOrderId"), error)});
+        return;
+    }
+    submitOrder(order);
+}
+
+void PipelinedTradeSystem::submitCancelRaw(std::string_view input) {
+    CancelOrder cancel;
+    if (const char *error = parseCancelOrder(input, cancel)) {
+        inbound_.push(InboundMessage{
+            InboundMessage::CANCEL_REJECT,
+            makeInvalidCancelReject(findIdField(input, "clOrderId"),
+                                    findIdField(input, "origClOrderId"),
+                                    error)});
+        return;
+    }
+    submitCancel(cancel);
+}
+
+void PipelinedTradeSystem::coreLoop() {
+    SpinWait idle;
+    while (true) {
+        if (timed_) {
+            core_.advanceTime(steadyNowNs());
+        }
+        size_t n = inbound_.popBatch(
+            [this](InboundMessage &message) {
+                dispatchInbound(core_, egressSink_, message);
+            },
+            MAX_BATCH);
+        if (n > 0) {
+            idle.reset();
+            continue;
+        }
+        // 先确认输入已关闭再检查队列，保证关闭前提交的消息都已取出
+        if (inputClosed_.load(std::memory_order_acquire) &&
+            inbound_.empty()) {
+            break;
+        }
+        idle.wait();
+    }
+    coreDone_.store(true, std::memory_order_release);
+}
+
+void PipelinedTradeSystem::egressLoop() {
+    SpinWait idle;
+    auto render = [this](OutboundMessage &message) {
+        deliverOutbound(message, clientSink_, exchangeSink_);
+    };
+    while (true) {
+        size_t n = outbound_.popBatch(render, MAX_BATCH);
+        if (n > 0) {
+            idle.reset();
+            continue;
+        }
+        if (coreDone_.load(std::memory_order_acquire) && outbound_.empty()) {
+            break;
+        }
+        idle.wait();
+    }
+}
+
+} // namespace hdf
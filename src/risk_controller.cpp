@@ -2,10 +2,31 @@
 
 namespace hdf {
 
-RiskController::RiskController() {}
+RiskController::RiskController()
+    : ownedSymbols_(std::make_unique<SymbolTable>()),
+      symbols_(ownedSymbols_.get()),
+      activeOrders_(PoolAllocator<char>(bucketPool_)),
+      orderIndex_(PoolAllocator<char>(orderPool_)) {}
+
+RiskController::RiskController(SymbolTable &symbols)
+    : symbols_(&symbols), activeOrders_(PoolAllocator<char>(bucketPool_)),
+      orderIndex_(PoolAllocator<char>(orderPool_)) {}
 
 RiskController::~RiskController() {}
 
+void RiskController::reserve(const EngineConfig &config) {
+    bucketPool_.setHugePages(config.hugePages);
+    orderPool_.setHugePages(config.hugePages);
+    orderPool_.reserve(config.expectedOrders);
+    orderIndex_.reserve(config.expectedOrders);
+}
+
+size_t RiskController::memoryBytes() const {
+    return bucketPool_.bytesReserved() + orderPool_.bytesReserved() +
+           (activeOrders_.bucket_count() + orderIndex_.bucket_count()) *
+               sizeof(void *);
+}
+
 RiskController::RiskCheckResult RiskController::checkOrder(const Order &order) {
     if (isCrossTrade(order)) {
         return RiskCheckResult::CROSS_TRADE;
@@ -15,90 +36,103 @@ RiskController::RiskCheckResult RiskController::checkOrder(const Order &order) {
 }
 
 bool RiskController::isCrossTrade(const Order &order) {
-    // 第一步：查找该股东号是否存在活跃订单
-    auto shareholderIt = activeOrders_.find(order.shareholderId);
-    if (shareholderIt == activeOrders_.end()) {
+    // 第一步：确定股东和股票编号，未出现过的股东或股票不可能有活跃订单
+    ShareholderKey shareholder = order.shareholderKey;
+    SecurityKey security = order.securityKey;
+    if (shareholder == INVALID_KEY) {
+        shareholder = symbols_->findShareholder(order.shareholderId);
+    }
+    if (security == INVALID_KEY) {
+        security = symbols_->findSecurity(order.market, order.securityId);
+    }
+    if (shareholder == INVALID_KEY || security == INVALID_KEY) {
         return false;
     }
 
-    // 第二步：查找该股票是否存在活跃订单
-    auto securityIt = shareholderIt->second.find(order.securityId);
-    if (securityIt == shareholderIt->second.end()) {
+    // 第二步：查找该股东在该股票上是否存在活跃订单
+    auto bucketIt = activeOrders_.find(makeBucketKey(shareholder, security));
+    if (bucketIt == activeOrders_.end()) {
         return false;
     }
 
-    // 第三步：确定反方向（买单查卖单，卖单查买单）
+    // 第三步：检查反方向（买单查卖单，卖单查买单）是否有剩余数量
     // 这里由调用方保证不会有 Side::Unknown
     Side oppositeSide = (order.side == Side::BUY) ? Side::SELL : Side::BUY;
-    auto oppositeIt = securityIt->second.find(oppositeSide);
-    if (oppositeIt == securityIt->second.end()) {
-        return false;
+    return bucketIt->second[sideIndex(oppositeSide)].liveQty > 0;
+}
+
+void RiskController::onOrderAccepted(const Order &order) {
+    if (order.qty == 0) {
+        return;
+    }
+    // 同一订单重复接受时只保留第一次的记录
+    auto [indexIt, inserted] = orderIndex_.try_emplace(order.clOrderId);
+    if (!inserted) {
+        return;
     }
 
-    // 第四步：检查反方向订单是否有剩余数量
-    // 只有剩余数量大于0的订单才构成对敲风险
-    for (const auto &orderInfo : oppositeIt->second) {
-        if (orderInfo.remainingQty > 0) {
-            return true;
-        }
+    ShareholderKey shareholder = order.shareholderKey;
+    SecurityKey security = order.securityKey;
+    if (shareholder == INVALID_KEY) {
+        shareholder = symbols_->internShareholder(order.shareholderId);
+    }
+    if (security == INVALID_KEY) {
+        security = symbols_->internSecurity(order.market, order.securityId);
     }
 
-    return false;
-}
+    // 将订单计入 (股东, 股票) 桶的对应方向
+    uint64_t bucketKey = makeBucketKey(shareholder, security);
+    SideTotals &totals = activeOrders_[bucketKey][sideIndex(order.side)];
+    totals.liveQty += order.qty;
+    totals.liveCount++;
 
-void RiskController::onOrderAccepted(const Order &order) {
-    // 创建订单信息对象
-    OrderInfo orderInfo;
-    orderInfo.clOrderId = order.clOrderId;
-    orderInfo.securityId = order.securityId;
+    // 填写订单信息
+    OrderInfo &orderInfo = indexIt->second;
+    orderInfo.totals = &totals;
+    orderInfo.bucketKey = bucketKey;
     orderInfo.side = order.side;
     orderInfo.price = order.price;
     orderInfo.remainingQty = order.qty;
+}
+
+void RiskController::removeOrder(
+    PooledHashMap<ClOrderId, OrderInfo>::iterator it) {
+    const OrderInfo &orderInfo = it->second;
+    uint64_t bucketKey = orderInfo.bucketKey;
+    orderInfo.totals->liveQty -= orderInfo.remainingQty;
+    orderInfo.totals->liveCount--;
+    orderIndex_.erase(it);
 
-    // 将订单添加到三层索引结构中
-    // 路径：股东号 -> 股票代码 -> 买卖方向 -> 订单列表
-    activeOrders_[order.shareholderId][order.securityId][order.side].push_back(
-        orderInfo);
+    // 买卖两边都已空，删除整个桶，避免已结束的股东/股票残留
+    auto bucketIt = activeOrders_.find(bucketKey);
+    const BothSides &bothSides = bucketIt->second;
+    if (bothSides[0].liveCount == 0 && bothSides[1].liveCount == 0) {
+        activeOrders_.erase(bucketIt);
+    }
 }
 
-void RiskController::onOrderCanceled(const std::string &origClOrderId) {
-    // 遍历三层索引结构，查找并删除指定订单
-    for (auto &shareholderPair : activeOrders_) {
-        for (auto &securityPair : shareholderPair.second) {
-            for (auto &sidePair : securityPair.second) {
-                auto &orders = sidePair.second;
-                for (auto it = orders.begin(); it != orders.end(); ++it) {
-                    if (it->clOrderId == origClOrderId) {
-                        orders.erase(it);
-                        return;
-                    }
-                }
-            }
-        }
+void RiskController::onOrderCanceled(const ClOrderId &origClOrderId) {
+    auto it = orderIndex_.find(origClOrderId);
+    if (it == orderIndex_.end()) {
+        return;
     }
+    removeOrder(it);
 }
 
-void RiskController::onOrderExecuted(const std::string &clOrderId,
+void RiskController::onOrderExecuted(const ClOrderId &clOrderId,
                                      uint32_t execQty) {
-    // 遍历三层索引结构，查找并更新指定订单的剩余数量
-    for (auto &shareholderPair : activeOrders_) {
-        for (auto &securityPair : shareholderPair.second) {
-            for (auto &sidePair : securityPair.second) {
-                for (auto &orderInfo : sidePair.second) {
-                    if (orderInfo.clOrderId == clOrderId) {
-                        // 更新剩余数量
-                        if (execQty >= orderInfo.remainingQty) {
-                            // 完全成交，剩余数量设为0
-                            orderInfo.remainingQty = 0;
-                        } else {
-                            // 部分成交，减少剩余数量
-                            orderInfo.remainingQty -= execQty;
-                        }
-                        return;
-                    }
-                }
-            }
-        }
+    auto it = orderIndex_.find(clOrderId);
+    if (it == orderIndex_.end()) {
+        return;
+    }
+    OrderInfo &orderInfo = it->second;
+    if (execQty >= orderInfo.remainingQty) {
+        // 完全成交，不再参与对敲检测，直接回收
+        removeOrder(it);
+    } else {
+        // 部分成交，减少剩余数量
+        orderInfo.remainingQty -= execQty;
+        orderInfo.totals->liveQty -= execQty;
     }
 }
 
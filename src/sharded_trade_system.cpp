@@ -0,0 +1,207 @@
+#include "sharded_trade_system.h"
+#include "order_parser.h"
+#include <stdexcept>
+
+namespace hdf {
+
+namespace {
+
+EngineConfig shardConfig(const EngineConfig &config, size_t index,
+                         size_t count) {
+    EngineConfig result = config;
+    result.expectedOrders = (config.expectedOrders + count - 1) / count;
+    result.expectedPendingMatches =
+        (config.expectedPendingMatches + count - 1) / count;
+    result.shardIndex = static_cast<uint32_t>(index);
+    result.shardCount = static_cast<uint32_t>(count);
+    // 分片不推进时间，见类注释
+    result.pendingCancelTimeoutNs = 0;
+    return result;
+}
+
+} // namespace
+
+ShardedTradeSystem::Shard::Shard(const EngineConfig &config,
+                                 size_t ringCapacity, bool toExchange)
+    : inbound(ringCapacity), outbound(ringCapacity), egressSink(outbound),
+      core(config) {
+    core.setClientSink(&egressSink);
+    if (toExchange) {
+        core.setExchangeSink(&egressSink);
+    }
+}
+
+ShardedTradeSystem::ShardedTradeSystem(size_t shardCount,
+                                       ClientSink &clientSink,
+                                       ExchangeSink *exchangeSink,
+                                       const EngineConfig &config,
+                                       size_t ringCapacity)
+    : clientSink_(clientSink), exchangeSink_(exchangeSink),
+      routes_(ringCapacity) {
+    if (shardCount == 0) {
+        shardCount = 1;
+    }
+    shards_.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; i++) {
+        shards_.push_back(std::make_unique<Shard>(
+            shardConfig(config, i, shardCount), ringCapacity,
+            exchangeSink_ != nullptr));
+    }
+    for (auto &shard : shards_) {
+        shard->thread = std::thread([this, &shard = *shard] {
+            shardLoop(shard);
+        });
+    }
+    mergeThread_ = std::thread([this] { mergeLoop(); });
+}
+
+ShardedTradeSystem::~ShardedTradeSystem() { stop(); }
+
+void ShardedTradeSystem::stop() {
+    if (stopped_) {
+        return;
+    }
+    stopped_ = true;
+    inputClosed_.store(true, std::memory_order_release);
+    for (auto &shard : shards_) {
+        shard->thread.join();
+    }
+    mergeThread_.join();
+}
+
+size_t ShardedTradeSystem::shardOf(Market market,
+                                   const SecurityId &securityId) const {
+    size_t hash = securityId.hash() ^
+                  (static_cast<size_t>(market) * 0x9E3779B97F4A7C15ULL);
+    return hash % shards_.size();
+}
+
+uint32_t ShardedTradeSystem::shardOfResponse(
+    Market market, const SecurityId &securityId) const {
+    // 默认交给某个分片会让它找不到订单，真正的分片却留着已成交的挂单
+    if (market == Market::UNKNOWN || securityId.empty()) {
+        throw std::invalid_argument(
+            "ShardedTradeSystem: response without market/securityId");
+    }
+    return static_cast<uint32_t>(shardOf(market, securityId));
+}
+
+void ShardedTradeSystem::submit(uint32_t shard, InboundMessage &&message) {
+    // 先放入分片队列再登记路由，合并线程等待的输出一定已在路上
+    shards_[shard]->inbound.push(std::move(message));
+    routes_.push(shard);
+}
+
+void ShardedTradeSystem::submitOrder(const Order &order) {
+    auto shard =
+        static_cast<uint32_t>(shardOf(order.market, order.securityId));
+    submit(shard, InboundMessage{InboundMessage::ORDER, order});
+}
+
+void ShardedTradeSystem::submitCancel(const CancelOrder &cancel) {
+    auto shard =
+        static_cast<uint32_t>(shardOf(cancel.market, cancel.securityId));
+    submit(shard, InboundMessage{InboundMessage::CANCEL, cancel});
+}
+
+void ShardedTradeSystem::submitResponse(const OrderResponse &response) {
+    submit(shardOfResponse(response.market, response.securityId),
+           InboundMessage{InboundMessage::ORDER_RESPONSE, response});
+}
+
+void ShardedTradeSystem::submitResponse(const CancelResponse &response) {
+    // 内部撮合触发的撤单和用户撤单都由被撤订单所在的分片处理。
+    // 内部撤单的序号以分片号+1为起点、以分片数为步长，不需要股票也能定位
+    uint32_t slot;
+    uint64_t seq;
+    uint32_t shard =
+        PendingMatchTable::parseCancelId(response.clOrderId, slot, seq) &&
+                seq > 0
+            ? static_cast<uint32_t>((seq - 1) % shards_.size())
+            : shardOfResponse(response.market, response.securityId);
+    submit(shard, InboundMessage{InboundMessage::CANCEL_RESPONSE, response});
+}
+
+void ShardedTradeSystem::submitOrderRaw(std::string_view input) {
+    Order order;
+    if (const char *error = parseOrder(input, order)) {
+        submit(0, InboundMessage{InboundMessage::ORDER_REJECT,
+                                 makeInvalidOrderReject(
+                                     findIdField(input, "clOrderId"), error)});
+        return;
+    }
+    submitOrder(order);
+}
+
+void ShardedTradeSystem::submitCancelRaw(std::string_view input) {
+    CancelOrder cancel;
+    if (const char *error = parseCancelOrder(input, cancel)) {
+        submit(0, InboundMessage{
+                      InboundMessage::CANCEL_REJECT,
+                      makeInvalidCancelReject(
+                          findIdField(input, "clOrderId"),
+                          findIdField(input, "origClOrderId"), error)});
+        return;
+    }
+    submitCancel(cancel);
+}
+
+void ShardedTradeSystem::shardLoop(Shard &shard) {
+    SpinWait idle;
+    auto handle = [&shard](InboundMessage &message) {
+        dispatchInbound(shard.core, shard.egressSink, message);
+        // 结束标记：本条消息的输出已全部放入出站队列
+        shard.outbound.push(OutboundMessage{});
+    };
+    while (true) {
+        size_t n = shard.inbound.popBatch(handle, MAX_BATCH);
+        if (n > 0) {
+            idle.reset();
+            continue;
+        }
+        // 先确认输入已关闭再检查队列，保证关闭前提交的消息都已取出
+        if (inputClosed_.load(std::memory_order_acquire) &&
+            shard.inbound.empty()) {
+            break;
+        }
+        idle.wait();
+    }
+}
+
+void ShardedTradeSystem::forward(Shard &shard) {
+    SpinWait idle;
+    bool done = false;
+    auto deliver = [this, &done](OutboundMessage &message) {
+        if (std::holds_alternative<std::monostate>(message.payload)) {
+            done = true;
+            return true;
+        }
+        deliverOutbound(message, clientSink_, exchangeSink_);
+        return false;
+    };
+    while (!done) {
+        if (shard.outbound.popUntil(deliver, MAX_BATCH) > 0) {
+            idle.reset();
+        } else {
+            idle.wait();
+        }
+    }
+}
+
+void ShardedTradeSystem::mergeLoop() {
+    SpinWait idle;
+    while (true) {
+        size_t n = routes_.popBatch(
+            [this](uint32_t shard) { forward(*shards_[shard]); }, MAX_BATCH);
+        if (n > 0) {
+            idle.reset();
+            continue;
+        }
+        if (inputClosed_.load(std::memory_order_acquire) && routes_.empty()) {
+            break;
+        }
+        idle.wait();
+    }
+}
+
+} // namespace hdf
@@ -0,0 +1,471 @@
+#include "snapshot.h"
+#include "basic_trade_system.h"
+#include "journal.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace hdf {
+
+namespace {
+
+using namespace snapshot;
+
+constexpr size_t align8(size_t n) { return (n + 7) & ~size_t{7}; }
+
+template <typename T> size_t sectionBytes(uint64_t count) {
+    return align8(count * sizeof(T));
+}
+
+// 按文件头中的记录数计算映像总长度
+size_t imageSize(const Header &h) {
+    return sizeof(Header) + sectionBytes<SecurityRecord>(h.securityCount) +
+           sectionBytes<ShareholderRecord>(h.shareholderCount) +
+           sectionBytes<BookOrderRecord>(h.bookOrderCount) +
+           sectionBytes<RiskOrderRecord>(h.riskOrderCount) +
+           sectionBytes<FreeSlotRecord>(h.freeSlotCount) +
+           sectionBytes<PendingMatchRecord>(h.pendingMatchCount) +
+           sectionBytes<PendingExecRecord>(h.pendingExecCount);
+}
+
+// 顺序写各段，每段写完补齐到8字节
+class SectionWriter {
+  public:
+    explicit SectionWriter(uint8_t *p) : p_(p) {}
+
+    template <typename T> T *next() {
+        T *record = reinterpret_cast<T *>(p_);
+        p_ += sizeof(T);
+        return record;
+    }
+
+    void endSection(uint8_t *base) {
+        p_ = base + align8(static_cast<size_t>(p_ - base));
+    }
+
+  private:
+    uint8_t *p_;
+};
+
+// 顺序读各段
+class SectionReader {
+  public:
+    explicit SectionReader(const uint8_t *p) : p_(p) {}
+
+    template <typename T> std::span<const T> next(uint64_t count) {
+        const T *records = reinterpret_cast<const T *>(p_);
+        p_ += sectionBytes<T>(count);
+        return {records, static_cast<size_t>(count)};
+    }
+
+  private:
+    const uint8_t *p_;
+};
+
+[[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void writeFile(int fd, const uint8_t *data, size_t n) {
+    while (n > 0) {
+        ssize_t written = ::write(fd, data, n);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwErrno("SnapshotWriter: write");
+        }
+        data += written;
+        n -= static_cast<size_t>(written);
+    }
+}
+
+} // namespace
+
+namespace snapshot {
+
+void capture(const TradeCore &core, uint64_t journalSequence,
+             std::vector<uint8_t> &image) {
+    const PendingMatchTable &pending = core.pendingMatches;
+
+    Header h{};
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.journalSequence = journalSequence;
+    h.nowNs = core.nowNs;
+    h.nextExecId = core.matchingEngine.nextExecId();
+    h.execIdStep = core.matchingEngine.execIdStep();
+    h.nextCancelSeq = pending.nextCancelSeq();
+    h.cancelSeqStep = pending.cancelSeqStep();
+    h.securityCount = core.symbols.securityCount();
+    h.shareholderCount = core.symbols.shareholderCount();
+    h.bookOrderCount = core.matchingEngine.orderCount();
+    h.riskOrderCount = core.riskController.orderCount();
+    h.pendingSlotCount = pending.slotCount();
+    h.freeSlotCount = pending.freeSlots().size();
+    h.pendingMatchCount = pending.size();
+    for (uint32_t slot = 0; slot < pending.slotCount(); ++slot) {
+        if (pending.at(slot).firstCancelSeq != 0) {
+            h.pendingExecCount += pending.at(slot).executions.size();
+        }
+    }
+
+    // 先整体清零，记录间的填充字节也是确定的
+    size_t size = imageSize(h);
+    image.resize(size);
+    std::memset(image.data(), 0, size);
+    uint8_t *body = image.data() + sizeof(Header);
+    SectionWriter out(body);
+
+    for (SecurityKey key = 0; key < h.securityCount; ++key) {
+        SecurityRecord *r = out.next<SecurityRecord>();
+        r->securityId = core.symbols.securityIdOf(key);
+        r->market = core.symbols.marketOf(key);
+    }
+    out.endSection(body);
+    for (ShareholderKey key = 0; key < h.shareholderCount; ++key) {
+        *out.next<ShareholderRecord>() = core.symbols.shareholderIdOf(key);
+    }
+    out.endSection(body);
+    core.matchingEngine.forEachOrder([&out](const Order &order,
+                                            uint32_t origQty) {
+        BookOrderRecord *r = out.next<BookOrderRecord>();
+        r->order = order;
+        r->origQty = origQty;
+    });
+    out.endSection(body);
+    core.riskController.forEachOrder(
+        [&out](const RiskOrderRecord &entry) {
+            *out.next<RiskOrderRecord>() = entry;
+        });
+    out.endSection(body);
+    for (uint32_t slot : pending.freeSlots()) {
+        *out.next<FreeSlotRecord>() = slot;
+    }
+    out.endSection(body);
+    for (uint32_t slot = 0; slot < pending.slotCount(); ++slot) {
+        const PendingMatchTable::Match &match = pending.at(slot);
+        if (match.firstCancelSeq == 0) {
+            continue;
+        }
+        PendingMatchRecord *r = out.next<PendingMatchRecord>();
+        r->activeOrder = match.activeOrder;
+        r->firstCancelSeq = match.firstCancelSeq;
+        r->deadlineNs = core.pendingTimeouts.deadlineNs(match.timer);
+        r->acquiredNs = match.acquiredNs;
+        r->slot = slot;
+        r->remainingQty = match.remainingQty;
+        r->pendingCancelCount = match.pendingCancelCount;
+        r->execCount = static_cast<uint32_t>(match.executions.size());
+    }
+    out.endSection(body);
+    for (uint32_t slot = 0; slot < pending.slotCount(); ++slot) {
+        const PendingMatchTable::Match &match = pending.at(slot);
+        if (match.firstCancelSeq == 0) {
+            continue;
+        }
+        for (size_t i = 0; i < match.executions.size(); ++i) {
+            const OrderResponse &exec = match.executions[i];
+            PendingExecRecord *r = out.next<PendingExecRecord>();
+            r->clOrderId = exec.clOrderId;
+            r->execId = exec.execId;
+            r->securityId = exec.securityId;
+            r->shareholderId = exec.shareholderId;
+            r->price = exec.price;
+            r->execPrice = exec.execPrice;
+            r->qty = exec.qty;
+            r->execQty = exec.execQty;
+            r->market = exec.market;
+            r->side = exec.side;
+            r->answered = match.answered[i / 64] >> (i % 64) & 1;
+            r->confirmed = match.isConfirmed(i);
+        }
+    }
+
+    h.checksum = journal::checksum(body, size - sizeof(Header));
+    std::memcpy(image.data(), &h, sizeof(Header));
+}
+
+} // namespace snapshot
+
+SnapshotReader::SnapshotReader(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throwErrno("SnapshotReader: open");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(),
+                                "SnapshotReader: fstat");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("SnapshotReader: file too short");
+    }
+    void *p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        throw std::system_error(err, std::generic_category(),
+                                "SnapshotReader: mmap");
+    }
+    data_ = static_cast<const uint8_t *>(p);
+    header_ = reinterpret_cast<const Header *>(data_);
+    ::madvise(p, size_, MADV_WILLNEED);
+
+    const char *error = nullptr;
+    if (header_->magic != MAGIC || header_->version != VERSION) {
+        error = "SnapshotReader: not a snapshot file";
+    } else if (imageSize(*header_) != size_) {
+        error = "SnapshotReader: size mismatch";
+    } else if (journal::checksum(data_ + sizeof(Header),
+                                 size_ - sizeof(Header)) !=
+               header_->checksum) {
+        error = "SnapshotReader: checksum mismatch";
+    }
+    if (error) {
+        ::munmap(p, size_);
+        throw std::runtime_error(error);
+    }
+}
+
+SnapshotReader::~SnapshotReader() {
+    ::munmap(const_cast<uint8_t *>(data_), size_);
+}
+
+void SnapshotReader::restore(TradeCore &core) const {
+    if (core.symbols.securityCount() != 0 ||
+        core.symbols.shareholderCount() != 0 ||
+        core.matchingEngine.orderCount() != 0 ||
+        core.riskController.orderCount() != 0 ||
+        core.pendingMatches.slotCount() != 0) {
+        throw std::logic_error("SnapshotReader: trade core is not empty");
+    }
+    const Header &h = *header_;
+    SectionReader in(data_ + sizeof(Header));
+    auto securities = in.next<SecurityRecord>(h.securityCount);
+    auto shareholders = in.next<ShareholderRecord>(h.shareholderCount);
+    auto bookOrders = in.next<BookOrderRecord>(h.bookOrderCount);
+    auto riskOrders = in.next<RiskOrderRecord>(h.riskOrderCount);
+    auto freeSlots = in.next<FreeSlotRecord>(h.freeSlotCount);
+    auto matches = in.next<PendingMatchRecord>(h.pendingMatchCount);
+    auto execs = in.next<PendingExecRecord>(h.pendingExecCount);
+
+    // 按编号顺序驻留，编号与原系统相同
+    for (const SecurityRecord &r : securities) {
+        core.symbols.internSecurity(r.market, r.securityId);
+    }
+    for (const ShareholderRecord &r : shareholders) {
+        core.symbols.internShareholder(r);
+    }
+
+    for (const BookOrderRecord &r : bookOrders) {
+        core.matchingEngine.restoreOrder(r.order, r.origQty);
+    }
+    core.matchingEngine.setExecIdSequence(h.nextExecId, h.execIdStep);
+
+    for (const RiskOrderRecord &r : riskOrders) {
+        Order order;
+        order.clOrderId = r.clOrderId;
+        order.market = core.symbols.marketOf(r.securityKey);
+        order.securityId = core.symbols.securityIdOf(r.securityKey);
+        order.side = r.side;
+        order.price = r.price;
+        order.qty = r.remainingQty;
+        order.shareholderId = core.symbols.shareholderIdOf(r.shareholderKey);
+        order.securityKey = r.securityKey;
+        order.shareholderKey = r.shareholderKey;
+        core.riskController.onOrderAccepted(order);
+    }
+
+    PendingMatchTable &pending = core.pendingMatches;
+    pending.restoreSlots(h.pendingSlotCount, freeSlots);
+    pending.setCancelIdSequence(h.nextCancelSeq, h.cancelSeqStep);
+    core.nowNs = h.nowNs;
+    core.pendingTimeouts.advance(h.nowNs, [](uint64_t) {});
+    size_t execPos = 0;
+    for (const PendingMatchRecord &r : matches) {
+        PendingMatchTable::Match &match = pending.at(r.slot);
+        match.activeOrder = r.activeOrder;
+        match.firstCancelSeq = r.firstCancelSeq;
+        match.remainingQty = r.remainingQty;
+        match.pendingCancelCount = r.pendingCancelCount;
+        size_t words = (r.execCount + 63) / 64;
+        match.answered.assign(words, 0);
+        match.confirmed.assign(words, 0);
+        match.executions.resize(r.execCount);
+        for (size_t i = 0; i < r.execCount; ++i) {
+            const PendingExecRecord &e = execs[execPos++];
+            OrderResponse &exec = match.executions[i];
+            exec.clOrderId = e.clOrderId;
+            exec.market = e.market;
+            exec.securityId = e.securityId;
+            exec.side = e.side;
+            exec.qty = e.qty;
+            exec.price = e.price;
+            exec.shareholderId = e.shareholderId;
+            exec.execId = e.execId;
+            exec.execQty = e.execQty;
+            exec.execPrice = e.execPrice;
+            exec.type = OrderResponse::EXECUTION;
+            uint64_t bit = uint64_t{1} << (i % 64);
+            if (e.answered) {
+                match.answered[i / 64] |= bit;
+            }
+            if (e.confirmed) {
+                match.confirmed[i / 64] |= bit;
+            }
+        }
+        // 原进程的单调时钟在这里不可比，等待时间从恢复时算起
+        match.acquiredNs = r.acquiredNs != 0 ? EngineMetrics::clockNs() : 0;
+        match.timer = r.deadlineNs != 0
+                          ? core.pendingTimeouts.schedule(r.deadlineNs, r.slot)
+                          : 0;
+    }
+}
+
+SnapshotWriter::SnapshotWriter(std::string path)
+    : path_(std::move(path)), thread_([this] { run(); }) {}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::unique_lock lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+bool SnapshotWriter::capture(const TradeCore &core,
+                             uint64_t journalSequence) {
+    {
+        std::unique_lock lock(mutex_);
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+        if (child_ != 0) {
+            return false;
+        }
+    }
+    // fork 时不持有 mutex_：子进程只有调用线程，不会再碰这把锁
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        throwErrno("SnapshotWriter: fork");
+    }
+    if (pid == 0) {
+        // 子进程：内存是 fork 时刻的写时复制映像，处理线程继续撮合不影响它。
+        // 以退出码把错误交回父进程，不运行析构和 atexit，不冲刷父进程的缓冲区
+        int code = 0;
+        try {
+            std::vector<uint8_t> image;
+            snapshot::capture(core, journalSequence, image);
+            persist(path_, image);
+        } catch (const std::system_error &e) {
+            code = e.code().value() > 0 && e.code().value() < 255
+                       ? e.code().value()
+                       : 255;
+        } catch (...) {
+            code = 255;
+        }
+        ::_exit(code);
+    }
+    {
+        std::unique_lock lock(mutex_);
+        child_ = pid;
+        childSequence_ = journalSequence;
+    }
+    cv_.notify_all();
+    return true;
+}
+
+void SnapshotWriter::wait() {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this] { return child_ == 0; });
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+uint64_t SnapshotWriter::writtenSequence() {
+    std::unique_lock lock(mutex_);
+    return writtenSequence_;
+}
+
+void SnapshotWriter::run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return child_ != 0 || stop_; });
+        if (child_ == 0) {
+            return;
+        }
+        pid_t pid = child_;
+        lock.unlock();
+        int status = 0;
+        pid_t reaped;
+        do {
+            reaped = ::waitpid(pid, &status, 0);
+        } while (reaped < 0 && errno == EINTR);
+        int waitError = reaped < 0 ? errno : 0;
+        lock.lock();
+        child_ = 0;
+        if (waitError != 0) {
+            error_ = std::make_exception_ptr(std::system_error(
+                waitError, std::generic_category(), "SnapshotWriter: waitpid"));
+        } else if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            writtenSequence_ = childSequence_;
+        } else {
+            int code = WIFEXITED(status) && WEXITSTATUS(status) != 255
+                           ? WEXITSTATUS(status)
+                           : EIO;
+            error_ = std::make_exception_ptr(std::system_error(
+                code, std::generic_category(),
+                "SnapshotWriter: snapshot process failed"));
+        }
+        cv_.notify_all();
+    }
+}
+
+void SnapshotWriter::persist(const std::string &path,
+                             const std::vector<uint8_t> &image) {
+    // 先写临时文件再改名，崩溃时目标文件要么是旧快照要么是新快照
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0) {
+        throwErrno("SnapshotWriter: open");
+    }
+    try {
+        writeFile(fd, image.data(), image.size());
+        if (::fdatasync(fd) != 0) {
+            throwErrno("SnapshotWriter: fdatasync");
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    if (::rename(tmp.c_str(), path.c_str()) != 0) {
+        throwErrno("SnapshotWriter: rename");
+    }
+    // 改名本身也要落盘
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    int dirFd = ::open(dir.empty() ? "." : dir.c_str(),
+                       O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+} // namespace hdf
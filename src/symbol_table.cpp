@@ -0,0 +1,60 @@
+#include "symbol_table.h"
+
+namespace hdf {
+
+SymbolTable::SymbolTable() {}
+
+SymbolTable::~SymbolTable() {}
+
+SecurityKey SymbolTable::internSecurity(Market market,
+                                        const SecurityId &securityId) {
+    SecurityName name{market, securityId};
+    auto [it, inserted] = securityKeys_.try_emplace(
+        name, static_cast<SecurityKey>(securities_.size()));
+    if (inserted) {
+        securities_.push_back(name);
+    }
+    return it->second;
+}
+
+ShareholderKey
+SymbolTable::internShareholder(const ShareholderId &shareholderId) {
+    auto [it, inserted] = shareholderKeys_.try_emplace(
+        shareholderId, static_cast<ShareholderKey>(shareholders_.size()));
+    if (inserted) {
+        shareholders_.push_back(shareholderId);
+    }
+    return it->second;
+}
+
+SecurityKey SymbolTable::findSecurity(Market market,
+                                      const SecurityId &securityId) const {
+    auto it = securityKeys_.find(SecurityName{market, securityId});
+    return it == securityKeys_.end() ? INVALID_KEY : it->second;
+}
+
+ShareholderKey
+SymbolTable::findShareholder(const ShareholderId &shareholderId) const {
+    auto it = shareholderKeys_.find(shareholderId);
+    return it == shareholderKeys_.end() ? INVALID_KEY : it->second;
+}
+
+size_t SymbolTable::memoryBytes() const {
+    constexpr size_t NODE_OVERHEAD = 2 * sizeof(void *);
+    return securities_.capacity() * sizeof(SecurityName) +
+           shareholders_.capacity() * sizeof(ShareholderId) +
+           securityKeys_.size() *
+               (sizeof(decltype(securityKeys_)::value_type) + NODE_OVERHEAD) +
+           shareholderKeys_.size() *
+               (sizeof(decltype(shareholderKeys_)::value_type) +
+                NODE_OVERHEAD) +
+           (securityKeys_.bucket_count() + shareholderKeys_.bucket_count()) *
+               sizeof(void *);
+}
+
+void SymbolTable::intern(Order &order) {
+    order.securityKey = internSecurity(order.market, order.securityId);
+    order.shareholderKey = internShareholder(order.shareholderId);
+}
+
+} // namespace hdf
@@ -0,0 +1,142 @@
+#include "timer_wheel.h"
+
+namespace hdf {
+
+TimerWheel::TimerWheel(uint64_t tickNs) : tickNs_(tickNs ? tickNs : 1) {
+    heads_.fill(NIL);
+}
+
+void TimerWheel::reserve(size_t timers) {
+    nodes_.reserve(timers);
+    freeNodes_.reserve(timers);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(uint64_t deadlineNs, uint64_t data) {
+    uint32_t index;
+    if (freeNodes_.empty()) {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    } else {
+        index = freeNodes_.back();
+        freeNodes_.pop_back();
+    }
+    Node &node = nodes_[index];
+    // 向上取整，不提前触发；已过期的在下一个刻度触发
+    uint64_t deadline = deadlineNs / tickNs_ + (deadlineNs % tickNs_ != 0);
+    node.deadline = deadline > now_ ? deadline : now_ + 1;
+    node.data = data;
+    node.active = true;
+    insert(index);
+    size_++;
+    return uint64_t{node.generation} << 32 | (uint64_t{index} + 1);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint64_t index = (id & UINT32_MAX) - 1;
+    if (id == INVALID_TIMER || index >= nodes_.size()) {
+        return false;
+    }
+    Node &node = nodes_[index];
+    if (!node.active || node.generation != id >> 32) {
+        return false;
+    }
+    unlink(static_cast<uint32_t>(index));
+    release(static_cast<uint32_t>(index));
+    return true;
+}
+
+uint64_t TimerWheel::deadlineNs(TimerId id) const {
+    uint64_t index = (id & UINT32_MAX) - 1;
+    if (id == INVALID_TIMER || index >= nodes_.size()) {
+        return 0;
+    }
+    const Node &node = nodes_[index];
+    if (!node.active || node.generation != id >> 32) {
+        return 0;
+    }
+    return node.deadline * tickNs_;
+}
+
+void TimerWheel::insert(uint32_t index) {
+    Node &node = nodes_[index];
+    uint64_t delta = node.deadline - now_;
+    size_t level = 0;
+    size_t slot;
+    while (level + 1 < LEVELS && delta >> (LEVEL_BITS * (level + 1)) != 0) {
+        level++;
+    }
+    if (delta >> (LEVEL_BITS * LEVELS) != 0) {
+        // 超出范围：放在最高层最晚被下放的槽，届时重新计算
+        slot = ((now_ >> (LEVEL_BITS * level)) - 1) & (SLOTS - 1);
+    } else {
+        slot = (node.deadline >> (LEVEL_BITS * level)) & (SLOTS - 1);
+    }
+    node.bucket = static_cast<uint16_t>(level * SLOTS + slot);
+    uint32_t &head = heads_[node.bucket];
+    node.prev = NIL;
+    node.next = head;
+    if (head != NIL) {
+        nodes_[head].prev = index;
+    }
+    head = index;
+    levelCounts_[level]++;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node &node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.bucket] = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    levelCounts_[node.bucket / SLOTS]--;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node &node = nodes_[index];
+    node.active = false;
+    node.generation++;
+    freeNodes_.push_back(index);
+    size_--;
+}
+
+void TimerWheel::cascade(size_t level) {
+    size_t slot = (now_ >> (LEVEL_BITS * level)) & (SLOTS - 1);
+    uint32_t index = heads_[level * SLOTS + slot];
+    heads_[level * SLOTS + slot] = NIL;
+    while (index != NIL) {
+        uint32_t next = nodes_[index].next;
+        levelCounts_[level]--;
+        insert(index);
+        index = next;
+    }
+}
+
+void TimerWheel::step(uint64_t target) {
+    size_t lowest = 0;
+    while (lowest < LEVELS && levelCounts_[lowest] == 0) {
+        lowest++;
+    }
+    if (lowest == LEVELS) {
+        now_ = target;
+        return;
+    }
+    // 低于 lowest 的层都是空的，可以直接跳到 lowest 层的下一个槽边界
+    size_t shift = LEVEL_BITS * lowest;
+    uint64_t next = ((now_ >> shift) + 1) << shift;
+    if (next > target) {
+        now_ = target;
+        return;
+    }
+    now_ = next;
+    for (size_t level = LEVELS - 1; level > 0; level--) {
+        if ((now_ & ((uint64_t{1} << (LEVEL_BITS * level)) - 1)) == 0) {
+            cascade(level);
+        }
+    }
+}
+
+} // namespace hdf
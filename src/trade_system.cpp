@@ -1,215 +1,184 @@
 #include "trade_system.h"
 #include "constants.h"
+#include "journal.h"
+#include "snapshot.h"
+#include "order_parser.h"
 #include "types.h"
+#include "wire_protocol.h"
 
 namespace hdf {
 
-TradeSystem::TradeSystem() {}
+TradeSystem::TradeSystem() : clientSink_(&nullClientSink_) {}
+
+TradeSystem::TradeSystem(const EngineConfig &config)
+    : core_(config), clientSink_(&nullClientSink_) {}
 
 TradeSystem::~TradeSystem() {}
 
+namespace {
+
+// 从格式错误的请求中尽量取回编号用于拒绝回报，取不到时留空
+ClOrderId idOrEmpty(const nlohmann::json &input, const char *key) {
+    if (!input.is_object()) {
+        return {};
+    }
+    auto it = input.find(key);
+    if (it == input.end() || !it->is_string()) {
+        return {};
+    }
+    const auto &value = it->get_ref<const std::string &>();
+    if (value.size() > ClOrderId::CAPACITY) {
+        return {};
+    }
+    return ClOrderId(value);
+}
+
+// 记录从 start 开始的解析耗时
+void recordParse(TradeCore &core, LatencyMessage message, uint64_t start) {
+    core.latency.record(message, LatencyStage::PARSE, latency::now() - start);
+}
+
+} // namespace
+
+namespace detail {
+template struct TradeLogic<TradeMode::EXCHANGE, ClientSink, ExchangeSink>;
+template struct TradeLogic<TradeMode::PRE_EXCHANGE, ClientSink, ExchangeSink>;
+} // namespace detail
+
 void TradeSystem::setSendToClient(SendToClient callback) {
-    sendToClient_ = callback;
+    if (callback) {
+        jsonClientSink_ = std::make_unique<JsonClientSink>(std::move(callback));
+        clientSink_ = jsonClientSink_.get();
+    } else {
+        clientSink_ = &nullClientSink_;
+        jsonClientSink_.reset();
+    }
 }
 
 void TradeSystem::setSendToExchange(SendToExchange callback) {
-    sendToExchange_ = callback;
+    if (callback) {
+        jsonExchangeSink_ =
+            std::make_unique<JsonExchangeSink>(std::move(callback));
+        exchangeSink_ = jsonExchangeSink_.get();
+    } else {
+        exchangeSink_ = nullptr;
+        jsonExchangeSink_.reset();
+    }
+}
+
+void TradeSystem::setClientSink(ClientSink *sink) {
+    clientSink_ = sink ? sink : &nullClientSink_;
+    jsonClientSink_.reset();
+}
+
+void TradeSystem::setExchangeSink(ExchangeSink *sink) {
+    exchangeSink_ = sink;
+    jsonExchangeSink_.reset();
+}
+
+void TradeSystem::setJournal(JournalWriter *journal) { journal_ = journal; }
+
+void TradeSystem::setMetrics(EngineMetrics *metrics) {
+    core_.metrics = metrics;
+}
+
+void TradeSystem::publishMetrics() {
+    if (core_.metrics) {
+        core_.metrics->publish(core_);
+    }
+}
+
+bool TradeSystem::takeSnapshot(SnapshotWriter &writer) {
+    uint64_t sequence = 0;
+    if (journal_) {
+        // 快照覆盖的记录须先于快照落盘，否则重启后日志序号会倒退
+        journal_->commit();
+        sequence = journal_->nextSequence() - 1;
+    }
+    return writer.capture(core_, sequence);
+}
+
+uint64_t TradeSystem::restoreSnapshot(const SnapshotReader &reader) {
+    reader.restore(core_);
+    return reader.journalSequence();
 }
 
 void TradeSystem::handleOrder(const nlohmann::json &input) {
+    uint64_t start = latency::now();
     Order order;
     try {
         order = input.get<Order>();
     } catch (const std::exception &e) {
         // JSON解析失败：缺少字段、类型错误、枚举值非法等
-        if (sendToClient_) {
-            nlohmann::json response;
-            response["clOrderId"] = input.value("clOrderId", "");
-            response["rejectCode"] = ORDER_INVALID_FORMAT_REJECT_CODE;
-            response["rejectText"] =
-                ORDER_INVALID_FORMAT_REJECT_REASON + ": " + e.what();
-            sendToClient_(response);
-        }
+        rejectInvalidOrder(idOrEmpty(input, "clOrderId"), e.what());
         return;
     }
+    recordParse(core_, LatencyMessage::ORDER, start);
+    handleOrder(order);
+}
 
-    // 风控
-    auto riskResult = riskController_.checkOrder(order);
-
-    if (riskResult == RiskController::RiskCheckResult::CROSS_TRADE) {
-        // 检测到对敲，生成对敲非法回报，并传给客户端
-        if (sendToClient_) {
-            nlohmann::json response;
-            response["clOrderId"] = order.clOrderId;
-            response["market"] = to_string(order.market);
-            response["securityId"] = order.securityId;
-            response["side"] = to_string(order.side);
-            response["qty"] = order.qty;
-            response["price"] = order.price;
-            response["shareholderId"] = order.shareholderId;
-            response["rejectCode"] = ORDER_CROSS_TRADE_REJECT_CODE;
-            response["rejectText"] = ORDER_CROSS_TRADE_REJECT_REASON;
-            sendToClient_(response);
-        }
+void TradeSystem::handleOrderRaw(std::string_view input) {
+    uint64_t start = latency::now();
+    Order order;
+    const char *error = parseOrder(input, order);
+    recordParse(core_, LatencyMessage::ORDER, start);
+    if (error) {
+        rejectInvalidOrder(findIdField(input, "clOrderId"), error);
+        return;
+    }
+    handleOrder(order);
+}
+
+void TradeSystem::handleOrder(const Order &order) {
+    if (journal_) {
+        journal_->append(order);
+    }
+    // 每条消息只判断一次模式，之后进入对应模式的实例
+    if (exchangeSink_) {
+        PreExchangeLogic::handleOrder(core_, *clientSink_, exchangeSink_,
+                                      order);
     } else {
-        // 尝试撮合交易
-        auto matchResult = matchingEngine_.match(order);
-        if (matchResult.has_value()) {
-            auto &executions = matchResult->executions;
-            if (sendToExchange_) {
-                // 交易所前置模式：对手方订单之前已转发给交易所，
-                // 需要先向交易所发送撤单请求，等待所有撤单确认后才发成交回报。
-                PendingMatch pending;
-                pending.activeOrder = order;
-                pending.activeOrderRawInput = input;
-                pending.executions = executions;
-                pending.remainingQty = matchResult->remainingQty;
-                pending.pendingCancelCount = executions.size();
-                pendingMatches_[order.clOrderId] = std::move(pending);
-
-                for (const auto &exec : executions) {
-                    // 建立反向映射
-                    cancelToActiveOrder_[exec.clOrderId] = order.clOrderId;
-
-                    // 向交易所发送撤单请求
-                    nlohmann::json cancelRequest;
-                    // TODO: 生成撤单唯一编号
-                    cancelRequest["clOrderId"] = "";
-                    cancelRequest["origClOrderId"] = exec.clOrderId;
-                    cancelRequest["market"] = to_string(exec.market);
-                    cancelRequest["securityId"] = exec.securityId;
-                    cancelRequest["shareholderId"] = exec.shareholderId;
-                    cancelRequest["side"] = to_string(exec.side);
-                    sendToExchange_(cancelRequest);
-                }
-            } else {
-                // 纯撮合模式：无需等待，直接发送成交回报
-                uint32_t totalExecQty = 0;
-                for (const auto &exec : executions) {
-                    // 更新对手方（被动方）风控状态
-                    riskController_.onOrderExecuted(exec.clOrderId,
-                                                    exec.execQty);
-                    totalExecQty += exec.execQty;
-                    if (sendToClient_) {
-                        // 对手方（被动方）成交回报
-                        nlohmann::json passiveResponse;
-                        passiveResponse["clOrderId"] = exec.clOrderId;
-                        passiveResponse["market"] = to_string(exec.market);
-                        passiveResponse["securityId"] = exec.securityId;
-                        passiveResponse["side"] = to_string(exec.side);
-                        passiveResponse["qty"] = exec.qty;
-                        passiveResponse["price"] = exec.price;
-                        passiveResponse["shareholderId"] = exec.shareholderId;
-                        passiveResponse["execId"] = exec.execId;
-                        passiveResponse["execQty"] = exec.execQty;
-                        passiveResponse["execPrice"] = exec.execPrice;
-                        sendToClient_(passiveResponse);
-
-                        // 主动方（taker）成交回报
-                        nlohmann::json activeResponse;
-                        activeResponse["clOrderId"] = order.clOrderId;
-                        activeResponse["market"] = to_string(order.market);
-                        activeResponse["securityId"] = order.securityId;
-                        activeResponse["side"] = to_string(order.side);
-                        activeResponse["qty"] = order.qty;
-                        activeResponse["price"] = order.price;
-                        activeResponse["shareholderId"] = order.shareholderId;
-                        activeResponse["execId"] = exec.execId;
-                        activeResponse["execQty"] = exec.execQty;
-                        activeResponse["execPrice"] = exec.execPrice;
-                        sendToClient_(activeResponse);
-                    }
-                }
-                // 更新主动方风控状态
-                riskController_.onOrderExecuted(order.clOrderId, totalExecQty);
-
-                // 部分成交：剩余数量需要显式入簿，并生成确认回报
-                if (matchResult->remainingQty > 0) {
-                    // 由调用方显式将剩余量加入订单簿
-                    Order remainingOrder = order;
-                    remainingOrder.qty = matchResult->remainingQty;
-                    matchingEngine_.addOrder(remainingOrder);
-
-                    if (sendToClient_) {
-                        nlohmann::json confirmResponse;
-                        confirmResponse["clOrderId"] = order.clOrderId;
-                        confirmResponse["market"] = to_string(order.market);
-                        confirmResponse["securityId"] = order.securityId;
-                        confirmResponse["side"] = to_string(order.side);
-                        confirmResponse["qty"] = matchResult->remainingQty;
-                        confirmResponse["price"] = order.price;
-                        confirmResponse["shareholderId"] = order.shareholderId;
-                        sendToClient_(confirmResponse);
-                    }
-                }
-            }
-        } else {
-            // 没有匹配成功：
-            // 如果此系统是交易所前置，则转发给交易所；
-            // 如果是纯撮合系统，则入订单簿并生成确认回报。
-            if (sendToExchange_) {
-                // 系统是交易所前置：入内部簿（供后续内部撮合）+ 转发交易所
-                matchingEngine_.addOrder(order);
-                sendToExchange_(input);
-            } else {
-                // 纯撮合系统：显式入订单簿，生成确认回报
-                matchingEngine_.addOrder(order);
-                nlohmann::json response;
-                response["clOrderId"] = order.clOrderId;
-                response["market"] = to_string(order.market);
-                response["securityId"] = order.securityId;
-                response["side"] = to_string(order.side);
-                response["qty"] = order.qty;
-                response["price"] = order.price;
-                response["shareholderId"] = order.shareholderId;
-                sendToClient_(response);
-            }
-            // 更新风控系统订单状态
-            riskController_.onOrderAccepted(order);
-        }
+        ExchangeLogic::handleOrder(core_, *clientSink_, nullptr, order);
     }
 }
 
 void TradeSystem::handleCancel(const nlohmann::json &input) {
+    uint64_t start = latency::now();
     CancelOrder order;
     try {
         order = input.get<CancelOrder>();
     } catch (const std::exception &e) {
         // JSON解析失败
-        if (sendToClient_) {
-            nlohmann::json response;
-            response["clOrderId"] = input.value("clOrderId", "");
-            response["origClOrderId"] = input.value("origClOrderId", "");
-            response["rejectCode"] = ORDER_INVALID_FORMAT_REJECT_CODE;
-            response["rejectText"] =
-                ORDER_INVALID_FORMAT_REJECT_REASON + ": " + e.what();
-            sendToClient_(response);
-        }
+        rejectInvalidCancel(idOrEmpty(input, "clOrderId"),
+                            idOrEmpty(input, "origClOrderId"), e.what());
+        return;
+    }
+    recordParse(core_, LatencyMessage::CANCEL, start);
+    handleCancel(order);
+}
+
+void TradeSystem::handleCancelRaw(std::string_view input) {
+    uint64_t start = latency::now();
+    CancelOrder order;
+    const char *error = parseCancelOrder(input, order);
+    recordParse(core_, LatencyMessage::CANCEL, start);
+    if (error) {
+        rejectInvalidCancel(findIdField(input, "clOrderId"),
+                            findIdField(input, "origClOrderId"), error);
         return;
     }
+    handleCancel(order);
+}
 
-    if (sendToExchange_) {
-        // 系统是交易所前置，转发给交易所
-        sendToExchange_(input);
+void TradeSystem::handleCancel(const CancelOrder &order) {
+    if (journal_) {
+        journal_->append(order);
+    }
+    if (exchangeSink_) {
+        PreExchangeLogic::handleCancel(core_, *clientSink_, exchangeSink_,
+                                       order);
     } else {
-        // 更新撮合引擎订单状态
-        CancelResponse result =
-            matchingEngine_.cancelOrder(order.origClOrderId);
-        // 更新风控系统订单状态
-        riskController_.onOrderCanceled(order.origClOrderId);
-        // 纯撮合系统，生成撤单确认回报
-        nlohmann::json response;
-        response["clOrderId"] = result.clOrderId;
-        response["origClOrderId"] = result.origClOrderId;
-        response["market"] = to_string(result.market);
-        response["securityId"] = result.securityId;
-        response["shareholderId"] = result.shareholderId;
-        response["side"] = to_string(result.side);
-        response["qty"] = result.qty;
-        response["price"] = result.price;
-        response["cumQty"] = result.cumQty;
-        response["canceledQty"] = result.canceledQty;
-        sendToClient_(response);
+        ExchangeLogic::handleCancel(core_, *clientSink_, nullptr, order);
     }
 }
 
@@ -218,137 +187,122 @@ void TradeSystem::handleMarketData(const nlohmann::json &input) {
 }
 
 void TradeSystem::handleResponse(const nlohmann::json &input) {
-    if (input.contains("execId")) {
-        // 处理成交回报：直接转发给客户端
-        if (sendToClient_) {
-            sendToClient_(input);
-        }
-        // 交易所主动成交了订单，需要从内部订单簿中减少对应订单数量
-        // 同时更新风控状态
-        std::string clOrderId = input["clOrderId"].get<std::string>();
-        uint32_t execQty = input["execQty"].get<uint32_t>();
-        matchingEngine_.reduceOrderQty(clOrderId, execQty);
-        riskController_.onOrderExecuted(clOrderId, execQty);
-    } else if (input.contains("origClOrderId")) {
-        // 处理撤单回报
-        std::string origClOrderId = input["origClOrderId"].get<std::string>();
-
-        // 检查是否是内部撮合触发的撤单回报
-        auto reverseIt = cancelToActiveOrder_.find(origClOrderId);
-        if (reverseIt != cancelToActiveOrder_.end()) {
-            std::string activeOrderId = reverseIt->second;
-            cancelToActiveOrder_.erase(reverseIt);
-
-            auto it = pendingMatches_.find(activeOrderId);
-            if (it == pendingMatches_.end()) {
-                return; // 异常情况，不应发生
-            }
-            auto &pending = it->second;
-
-            if (input.contains("rejectCode")) {
-                pending.rejectedIds.insert(origClOrderId);
-            } else {
-                pending.confirmedIds.insert(origClOrderId);
-            }
-            pending.pendingCancelCount--;
-
-            // 所有撤单回报都回来了，处理最终结果
-            if (pending.pendingCancelCount == 0) {
-                resolvePendingMatch(activeOrderId);
-            }
-        } else {
-            // 普通撤单回报（用户主动撤单的确认），直接转发
-            if (sendToClient_) {
-                sendToClient_(input);
-            }
-            // TODO: 更新风控状态
-            // riskController_.onOrderCanceled(origClOrderId);
-        }
+    uint64_t start = latency::now();
+    if (input.contains("origClOrderId") && !input.contains("execId")) {
+        auto response = input.get<CancelResponse>();
+        recordParse(core_, LatencyMessage::CANCEL_RESPONSE, start);
+        handleResponse(response);
+    } else {
+        auto response = input.get<OrderResponse>();
+        recordParse(core_, LatencyMessage::ORDER_RESPONSE, start);
+        handleResponse(response);
+    }
+}
+
+void TradeSystem::handleResponse(const OrderResponse &response) {
+    if (journal_) {
+        journal_->append(response);
+    }
+    // 订单回报的处理与模式无关
+    ExchangeLogic::handleResponse(core_, *clientSink_, response);
+}
+
+void TradeSystem::handleResponse(const CancelResponse &response) {
+    if (journal_) {
+        journal_->append(response);
+    }
+    if (exchangeSink_) {
+        PreExchangeLogic::handleResponse(core_, *clientSink_, exchangeSink_,
+                                         response);
     } else {
-        // 确认回报等，直接转发给客户端
-        if (sendToClient_) {
-            sendToClient_(input);
+        ExchangeLogic::handleResponse(core_, *clientSink_, nullptr, response);
+    }
+}
+
+void TradeSystem::advanceTime(uint64_t nowNs) {
+    if (exchangeSink_) {
+        // 只有前置模式的撤单回报超时依赖时间，其他情况不必记录
+        if (journal_ && core_.pendingCancelTimeoutNs > 0) {
+            journal_->appendTime(nowNs);
         }
+        PreExchangeLogic::advanceTime(core_, *clientSink_, exchangeSink_,
+                                      nowNs);
+    } else {
+        ExchangeLogic::advanceTime(core_, *clientSink_, nullptr, nowNs);
     }
 }
 
-void TradeSystem::resolvePendingMatch(const std::string &activeOrderId) {
-    auto it = pendingMatches_.find(activeOrderId);
-    if (it == pendingMatches_.end())
+void TradeSystem::handleWire(std::span<const uint8_t> message) {
+    uint64_t start = latency::now();
+    wire::MessageHeader header;
+    if (wire::decodeHeader(message, header) == 0) {
+        throw std::invalid_argument("wire: incomplete message");
+    }
+    switch (header.templateId) {
+    case wire::TemplateId::NEW_ORDER: {
+        Order order;
+        const char *error = wire::decode(message, order);
+        recordParse(core_, LatencyMessage::ORDER, start);
+        if (error) {
+            rejectInvalidOrder(order.clOrderId, error);
+            return;
+        }
+        handleOrder(order);
         return;
-    auto &pending = it->second;
-
-    uint32_t rejectedQty = 0;
-
-    // 对于撤单确认的部分，发送成交回报
-    uint32_t confirmedQty = 0;
-    for (const auto &exec : pending.executions) {
-        if (pending.confirmedIds.count(exec.clOrderId)) {
-            // 撤单确认 → 成交生效
-            riskController_.onOrderExecuted(exec.clOrderId, exec.execQty);
-            confirmedQty += exec.execQty;
-            if (sendToClient_) {
-                // 对手方（被动方）成交回报
-                nlohmann::json passiveResponse;
-                passiveResponse["clOrderId"] = exec.clOrderId;
-                passiveResponse["market"] = to_string(exec.market);
-                passiveResponse["securityId"] = exec.securityId;
-                passiveResponse["side"] = to_string(exec.side);
-                passiveResponse["qty"] = exec.qty;
-                passiveResponse["price"] = exec.price;
-                passiveResponse["shareholderId"] = exec.shareholderId;
-                passiveResponse["execId"] = exec.execId;
-                passiveResponse["execQty"] = exec.execQty;
-                passiveResponse["execPrice"] = exec.execPrice;
-                sendToClient_(passiveResponse);
-
-                // 主动方（taker）成交回报
-                nlohmann::json activeResponse;
-                activeResponse["clOrderId"] = pending.activeOrder.clOrderId;
-                activeResponse["market"] =
-                    to_string(pending.activeOrder.market);
-                activeResponse["securityId"] = pending.activeOrder.securityId;
-                activeResponse["side"] = to_string(pending.activeOrder.side);
-                activeResponse["qty"] = pending.activeOrder.qty;
-                activeResponse["price"] = pending.activeOrder.price;
-                activeResponse["shareholderId"] =
-                    pending.activeOrder.shareholderId;
-                activeResponse["execId"] = exec.execId;
-                activeResponse["execQty"] = exec.execQty;
-                activeResponse["execPrice"] = exec.execPrice;
-                sendToClient_(activeResponse);
-            }
-        } else {
-            // 撤单被拒 → 该部分作废，累计未成交量
-            rejectedQty += exec.execQty;
+    }
+    case wire::TemplateId::CANCEL_ORDER: {
+        CancelOrder cancel;
+        const char *error = wire::decode(message, cancel);
+        recordParse(core_, LatencyMessage::CANCEL, start);
+        if (error) {
+            rejectInvalidCancel(cancel.clOrderId, cancel.origClOrderId,
+                                error);
+            return;
         }
+        handleCancel(cancel);
+        return;
     }
-
-    // 更新主动方风控状态
-    if (confirmedQty > 0) {
-        riskController_.onOrderExecuted(pending.activeOrder.clOrderId,
-                                        confirmedQty);
+    case wire::TemplateId::ORDER_CONFIRM:
+    case wire::TemplateId::ORDER_REJECT:
+    case wire::TemplateId::EXECUTION_REPORT: {
+        OrderResponse response;
+        if (const char *error = wire::decode(message, response)) {
+            throw std::invalid_argument(std::string("wire: ") + error);
+        }
+        recordParse(core_, LatencyMessage::ORDER_RESPONSE, start);
+        handleResponse(response);
+        return;
     }
-
-    // 若有作废部分或撮合时的剩余量，将未成交的量转发给交易所并入内部簿
-    uint32_t totalUnfilledQty = rejectedQty + pending.remainingQty;
-    if (totalUnfilledQty > 0) {
-        Order remainingOrder = pending.activeOrder;
-        remainingOrder.qty = totalUnfilledQty;
-        // 入内部簿，供后续内部撮合
-        matchingEngine_.addOrder(remainingOrder);
-        if (sendToExchange_) {
-            nlohmann::json newOrder = pending.activeOrderRawInput;
-            newOrder["qty"] = totalUnfilledQty;
-            // TODO: 可能需要生成新的 clOrderId
-            sendToExchange_(newOrder);
+    case wire::TemplateId::CANCEL_CONFIRM:
+    case wire::TemplateId::CANCEL_REJECT: {
+        CancelResponse response;
+        if (const char *error = wire::decode(message, response)) {
+            throw std::invalid_argument(std::string("wire: ") + error);
         }
+        recordParse(core_, LatencyMessage::CANCEL_RESPONSE, start);
+        handleResponse(response);
+        return;
+    }
     }
+    // 未知模板（更新版本的协议）忽略
+}
 
-    // 主动方订单的风控状态更新
-    riskController_.onOrderAccepted(pending.activeOrder);
+void TradeSystem::rejectInvalidOrder(const ClOrderId &clOrderId,
+                                     std::string_view reason) {
+    if (core_.metrics) {
+        core_.metrics->countReject(ORDER_INVALID_FORMAT_REJECT_CODE);
+    }
+    clientSink_->onOrderResponse(makeInvalidOrderReject(clOrderId, reason));
+}
 
-    pendingMatches_.erase(it);
+void TradeSystem::rejectInvalidCancel(const ClOrderId &clOrderId,
+                                      const ClOrderId &origClOrderId,
+                                      std::string_view reason) {
+    if (core_.metrics) {
+        core_.metrics->countReject(ORDER_INVALID_FORMAT_REJECT_CODE);
+    }
+    clientSink_->onCancelResponse(
+        makeInvalidCancelReject(clOrderId, origClOrderId, reason));
 }
 
 } // namespace hdf
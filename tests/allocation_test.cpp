@@ -0,0 +1,437 @@
+// 稳态零分配检查：替换全局 operator new，统计每次调用处理接口时的堆分配次数。
+// 替换分配函数会影响同一程序中的所有代码，因此单独构建为 allocation_tests。
+#include "basic_trade_system.h"
+#include "engine_metrics.h"
+#include "trade_system.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 只统计本线程在计数区间内的分配
+thread_local bool counting = false;
+thread_local uint64_t allocations = 0;
+
+void *allocate(std::size_t size) {
+    if (counting) {
+        ++allocations;
+    }
+    return std::malloc(size ? size : 1);
+}
+
+void *allocateAligned(std::size_t size, std::align_val_t align) {
+    if (counting) {
+        ++allocations;
+    }
+    auto alignment = static_cast<std::size_t>(align);
+    // aligned_alloc 要求大小是对齐值的整数倍
+    std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded ? rounded : alignment);
+}
+
+} // namespace
+
+// 标准库中数组和 nothrow 版本的默认实现都转调以下两个函数，
+// 引擎的对象池、容器和字符串也都经由它们分配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void *operator new(std::size_t size) {
+    if (void *p = allocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void *operator new(std::size_t size, std::align_val_t align) {
+    if (void *p = allocateAligned(size, align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+using namespace hdf;
+
+namespace {
+
+/**
+ * @brief 按处理接口统计每次调用的分配次数。
+ */
+class AllocationProfile {
+  public:
+    enum Call { HANDLE_ORDER, HANDLE_CANCEL, HANDLE_RESPONSE, CALLS };
+
+    template <typename F> void measure(Call call, F &&f) {
+        allocations = 0;
+        counting = true;
+        f();
+        counting = false;
+        Entry &entry = entries_[call];
+        entry.calls++;
+        entry.allocations += allocations;
+        if (allocations > 0) {
+            entry.allocatingCalls++;
+        }
+        entry.maxPerCall = std::max(entry.maxPerCall, allocations);
+    }
+
+    uint64_t allocationsOf(Call call) const {
+        return entries_[call].allocations;
+    }
+    uint64_t callsOf(Call call) const { return entries_[call].calls; }
+
+    void reset() { entries_ = {}; }
+
+    std::string format() const {
+        static const char *names[] = {"handleOrder", "handleCancel",
+                                      "handleResponse"};
+        std::string out;
+        char line[128];
+        std::snprintf(line, sizeof(line), "%-16s %8s %10s %12s %8s\n", "call",
+                      "calls", "allocating", "allocations", "max");
+        out += line;
+        for (size_t i = 0; i < CALLS; ++i) {
+            const Entry &e = entries_[i];
+            std::snprintf(line, sizeof(line),
+                          "%-16s %8llu %10llu %12llu %8llu\n", names[i],
+                          static_cast<unsigned long long>(e.calls),
+                          static_cast<unsigned long long>(e.allocatingCalls),
+                          static_cast<unsigned long long>(e.allocations),
+                          static_cast<unsigned long long>(e.maxPerCall));
+            out += line;
+        }
+        return out;
+    }
+
+  private:
+    struct Entry {
+        uint64_t calls = 0;
+        uint64_t allocatingCalls = 0; // 至少分配一次的调用数
+        uint64_t allocations = 0;
+        uint64_t maxPerCall = 0;
+    };
+    std::array<Entry, CALLS> entries_{};
+};
+
+// sink 只按回报类型计数，自身不分配
+struct CountingClient {
+    uint64_t confirms = 0;
+    uint64_t rejects = 0;
+    uint64_t executions = 0;
+    uint64_t cancelConfirms = 0;
+    uint64_t cancelRejects = 0;
+
+    void onOrderResponse(const OrderResponse &r) {
+        switch (r.type) {
+        case OrderResponse::CONFIRM:
+            confirms++;
+            break;
+        case OrderResponse::REJECT:
+            rejects++;
+            break;
+        case OrderResponse::EXECUTION:
+            executions++;
+            break;
+        }
+    }
+    void onCancelResponse(const CancelResponse &r) {
+        (r.type == CancelResponse::REJECT ? cancelRejects : cancelConfirms)++;
+    }
+};
+
+struct CountingExchange {
+    static constexpr size_t CAPACITY = 8;
+    uint64_t orders = 0;
+    // 最近一次清空后发出的撤单，按发出顺序
+    std::array<CancelOrder, CAPACITY> cancels{};
+    size_t cancelCount = 0;
+
+    void onOrder(const Order &) { orders++; }
+    void onCancel(const CancelOrder &cancel) {
+        if (cancelCount < CAPACITY) {
+            cancels[cancelCount] = cancel;
+        }
+        cancelCount++;
+    }
+};
+
+struct VirtualCountingClient final : ClientSink {
+    CountingClient counts;
+    void onOrderResponse(const OrderResponse &r) override {
+        counts.onOrderResponse(r);
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        counts.onCancelResponse(r);
+    }
+};
+
+Order makeOrder(const std::string &id, Side side, double price, uint32_t qty,
+                const char *shareholder) {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+CancelOrder makeCancel(const std::string &id, const Order &orig) {
+    CancelOrder cancel;
+    cancel.clOrderId = id;
+    cancel.origClOrderId = orig.clOrderId;
+    cancel.market = orig.market;
+    cancel.securityId = orig.securityId;
+    cancel.shareholderId = orig.shareholderId;
+    cancel.side = orig.side;
+    return cancel;
+}
+
+CancelResponse answerCancel(const CancelOrder &cancel,
+                            CancelResponse::Type type) {
+    CancelResponse response;
+    response.clOrderId = cancel.clOrderId;
+    response.origClOrderId = cancel.origClOrderId;
+    response.market = cancel.market;
+    response.securityId = cancel.securityId;
+    response.shareholderId = cancel.shareholderId;
+    response.side = cancel.side;
+    response.type = type;
+    return response;
+}
+
+OrderResponse exchangeResponse(const Order &order, OrderResponse::Type type,
+                               uint32_t execQty = 0) {
+    OrderResponse response = detail::makeConfirm(order, order.qty);
+    response.type = type;
+    if (type == OrderResponse::EXECUTION) {
+        response.execId = "EX-" + std::string(order.clOrderId.view());
+        response.execQty = execQty;
+        response.execPrice = order.price;
+    }
+    return response;
+}
+
+/**
+ * @brief 纯撮合模式的一轮消息，结束后簿和风控回到空状态。
+ * 覆盖入簿确认、对敲拒绝、多笔成交、部分成交入簿、撤单确认和撤单被拒。
+ * 编号在计数区间外构造，每轮不同。
+ */
+struct ExchangeCycle {
+    std::vector<Order> orders;
+    std::vector<CancelOrder> cancels;
+
+    explicit ExchangeCycle(int round) {
+        std::string n = std::to_string(round);
+        orders = {
+            makeOrder("S1-" + n, Side::SELL, 10.00, 300, "SH001"),
+            makeOrder("S2-" + n, Side::SELL, 10.01, 200, "SH001"),
+            makeOrder("B1-" + n, Side::BUY, 9.99, 100, "SH002"),
+            makeOrder("X1-" + n, Side::BUY, 10.00, 100, "SH001"), // 对敲
+            makeOrder("B2-" + n, Side::BUY, 10.01, 400, "SH002"), // 两笔成交
+            makeOrder("B3-" + n, Side::BUY, 10.02, 300, "SH002"), // 剩余入簿
+        };
+        cancels = {
+            makeCancel("C1-" + n, orders[5]), // 撤部分成交后的剩余
+            makeCancel("C2-" + n, orders[0]), // 已成交，撤单被拒
+            makeCancel("C3-" + n, orders[2]),
+        };
+    }
+
+    template <typename System>
+    void run(System &system, AllocationProfile &profile) const {
+        for (const Order &order : orders) {
+            profile.measure(AllocationProfile::HANDLE_ORDER,
+                            [&] { system.handleOrder(order); });
+        }
+        for (const CancelOrder &cancel : cancels) {
+            profile.measure(AllocationProfile::HANDLE_CANCEL,
+                            [&] { system.handleCancel(cancel); });
+        }
+    }
+};
+
+// 预热轮数：让哈希表、对象池、价格档位和待定撮合槽达到稳定容量
+constexpr int WARMUP_ROUNDS = 16;
+constexpr int MEASURED_ROUNDS = 64;
+
+// 每轮结束后簿和风控都应为空，否则状态在增长，稳态不成立
+template <typename System> void expectDrained(System &system) {
+    EngineMetrics metrics;
+    system.setMetrics(&metrics);
+    system.publishMetrics();
+    system.setMetrics(nullptr);
+    MetricsSnapshot s = metrics.snapshot();
+    EXPECT_EQ(s.gauge(MetricGauge::RESTING_ORDERS), 0u);
+    EXPECT_EQ(s.gauge(MetricGauge::RISK_ORDERS), 0u);
+    EXPECT_EQ(s.gauge(MetricGauge::PENDING_MATCHES), 0u);
+}
+
+template <typename System, typename Client>
+void checkExchangeSteadyState(System &system, const Client &client) {
+    std::vector<ExchangeCycle> cycles;
+    for (int round = 0; round < WARMUP_ROUNDS + MEASURED_ROUNDS; ++round) {
+        cycles.emplace_back(round);
+    }
+    AllocationProfile profile;
+    for (int round = 0; round < WARMUP_ROUNDS; ++round) {
+        cycles[round].run(system, profile);
+    }
+    profile.reset();
+    for (int round = WARMUP_ROUNDS; round < WARMUP_ROUNDS + MEASURED_ROUNDS;
+         ++round) {
+        cycles[round].run(system, profile);
+    }
+
+    int rounds = WARMUP_ROUNDS + MEASURED_ROUNDS;
+    EXPECT_EQ(client.confirms, 4u * rounds);
+    EXPECT_EQ(client.rejects, 1u * rounds);
+    EXPECT_EQ(client.executions, 6u * rounds);
+    EXPECT_EQ(client.cancelConfirms, 2u * rounds);
+    EXPECT_EQ(client.cancelRejects, 1u * rounds);
+    EXPECT_EQ(profile.callsOf(AllocationProfile::HANDLE_ORDER),
+              6u * MEASURED_ROUNDS);
+    EXPECT_EQ(profile.allocationsOf(AllocationProfile::HANDLE_ORDER), 0u)
+        << profile.format();
+    EXPECT_EQ(profile.allocationsOf(AllocationProfile::HANDLE_CANCEL), 0u)
+        << profile.format();
+    expectDrained(system);
+}
+
+} // namespace
+
+TEST(Allocation, CounterSeesAllocations) {
+    AllocationProfile profile;
+    std::vector<int> v;
+    profile.measure(AllocationProfile::HANDLE_ORDER, [&] { v.resize(16); });
+    EXPECT_EQ(profile.allocationsOf(AllocationProfile::HANDLE_ORDER), 1u);
+
+    // JSON 入口的回报序列化仍会分配，只要求类型化接口零分配
+    OrderResponse response = exchangeResponse(
+        makeOrder("S1", Side::SELL, 10.0, 100, "SH001"), OrderResponse::CONFIRM);
+    std::string json;
+    profile.measure(AllocationProfile::HANDLE_RESPONSE,
+                    [&] { json = nlohmann::json(response).dump(); });
+    EXPECT_GT(profile.allocationsOf(AllocationProfile::HANDLE_RESPONSE), 0u);
+}
+
+TEST(Allocation, ExchangeModeSteadyStateIsAllocationFree) {
+    CountingClient client;
+    BasicTradeSystem<TradeMode::EXCHANGE, CountingClient> system(client);
+    checkExchangeSteadyState(system, client);
+}
+
+TEST(Allocation, TypeErasedSteadyStateIsAllocationFree) {
+    VirtualCountingClient client;
+    TradeSystem system;
+    system.setClientSink(&client);
+    checkExchangeSteadyState(system, client.counts);
+}
+
+TEST(Allocation, PreExchangeSteadyStateIsAllocationFree) {
+    CountingClient client;
+    CountingExchange exchange;
+    EngineConfig config;
+    config.pendingCancelTimeoutNs = 1'000'000'000;
+    BasicTradeSystem<TradeMode::PRE_EXCHANGE, CountingClient, CountingExchange>
+        system(client, exchange, config);
+    AllocationProfile profile;
+
+    // 交易所的回报按内部撮合发出的撤单请求生成，须在计数区间外构造
+    auto answerInternalCancels = [&] {
+        std::array<CancelResponse, CountingExchange::CAPACITY> answers;
+        size_t count = std::min(exchange.cancelCount, answers.size());
+        for (size_t i = 0; i < count; ++i) {
+            answers[i] =
+                answerCancel(exchange.cancels[i], CancelResponse::CONFIRM);
+        }
+        exchange.cancelCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            profile.measure(AllocationProfile::HANDLE_RESPONSE,
+                            [&] { system.handleResponse(answers[i]); });
+        }
+    };
+
+    auto runCycle = [&](int round) {
+        std::string n = std::to_string(round);
+        Order s1 = makeOrder("S1-" + n, Side::SELL, 10.00, 300, "SH001");
+        Order s2 = makeOrder("S2-" + n, Side::SELL, 10.01, 200, "SH001");
+        Order b1 = makeOrder("B1-" + n, Side::BUY, 10.01, 500, "SH002");
+        Order s3 = makeOrder("S3-" + n, Side::SELL, 10.00, 100, "SH001");
+        Order b2 = makeOrder("B2-" + n, Side::BUY, 10.00, 300, "SH002");
+        OrderResponse s1Confirm = exchangeResponse(s1, OrderResponse::CONFIRM);
+        OrderResponse s2Confirm = exchangeResponse(s2, OrderResponse::CONFIRM);
+        Order b2Rest = b2;
+        b2Rest.qty = 200;
+        OrderResponse b2Fill =
+            exchangeResponse(b2Rest, OrderResponse::EXECUTION, 200);
+        CancelOrder cancel = makeCancel("C1-" + n, s1);
+        CancelResponse cancelReject =
+            answerCancel(cancel, CancelResponse::REJECT);
+        cancelReject.rejectCode = CANCEL_ORDER_NOT_FOUND_REJECT_CODE;
+
+        auto order = [&](const Order &o) {
+            profile.measure(AllocationProfile::HANDLE_ORDER,
+                            [&] { system.handleOrder(o); });
+        };
+        auto response = [&](const auto &r) {
+            profile.measure(AllocationProfile::HANDLE_RESPONSE,
+                            [&] { system.handleResponse(r); });
+        };
+
+        // 挂单转发给交易所并得到确认
+        order(s1);
+        order(s2);
+        response(s1Confirm);
+        response(s2Confirm);
+        // 内部撮合两笔，撤单全部确认后成交生效
+        order(b1);
+        answerInternalCancels();
+        // 内部撮合一笔，剩余量转发给交易所，之后在交易所成交
+        order(s3);
+        order(b2);
+        answerInternalCancels();
+        response(b2Fill);
+        // 撤已成交的订单，交易所拒绝
+        profile.measure(AllocationProfile::HANDLE_CANCEL,
+                        [&] { system.handleCancel(cancel); });
+        exchange.cancelCount = 0;
+        response(cancelReject);
+    };
+
+    for (int round = 0; round < WARMUP_ROUNDS; ++round) {
+        runCycle(round);
+    }
+    profile.reset();
+    for (int round = WARMUP_ROUNDS; round < WARMUP_ROUNDS + MEASURED_ROUNDS;
+         ++round) {
+        runCycle(round);
+    }
+
+    int rounds = WARMUP_ROUNDS + MEASURED_ROUNDS;
+    // 挂单确认2笔；内部成交3笔各两条回报，加交易所成交1条
+    EXPECT_EQ(client.confirms, 2u * rounds);
+    EXPECT_EQ(client.executions, 7u * rounds);
+    EXPECT_EQ(client.cancelRejects, 1u * rounds);
+    EXPECT_EQ(exchange.orders, 4u * rounds);
+    EXPECT_EQ(profile.allocationsOf(AllocationProfile::HANDLE_ORDER), 0u)
+        << profile.format();
+    EXPECT_EQ(profile.allocationsOf(AllocationProfile::HANDLE_CANCEL), 0u)
+        << profile.format();
+    EXPECT_EQ(profile.allocationsOf(AllocationProfile::HANDLE_RESPONSE), 0u)
+        << profile.format();
+    expectDrained(system);
+}
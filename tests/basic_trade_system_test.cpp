@@ -0,0 +1,216 @@
+#include "basic_trade_system.h"
+#include "trade_system.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+// 非虚 sink，作为模板参数时直接调用
+struct ClientLog {
+    std::vector<OrderResponse> orders;
+    std::vector<CancelResponse> cancels;
+
+    void onOrderResponse(const OrderResponse &r) { orders.push_back(r); }
+    void onCancelResponse(const CancelResponse &r) { cancels.push_back(r); }
+};
+
+struct ExchangeLog {
+    std::vector<Order> orders;
+    std::vector<CancelOrder> cancels;
+
+    void onOrder(const Order &order) { orders.push_back(order); }
+    void onCancel(const CancelOrder &cancel) { cancels.push_back(cancel); }
+};
+
+// 供 TradeSystem 使用的虚函数适配器
+struct VirtualClientLog : ClientSink {
+    ClientLog log;
+    void onOrderResponse(const OrderResponse &r) override {
+        log.onOrderResponse(r);
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        log.onCancelResponse(r);
+    }
+};
+
+struct VirtualExchangeLog : ExchangeSink {
+    ExchangeLog log;
+    void onOrder(const Order &order) override { log.onOrder(order); }
+    void onCancel(const CancelOrder &cancel) override { log.onCancel(cancel); }
+};
+
+Order makeOrder(const std::string &id, Side side, double price, uint32_t qty,
+                const char *shareholder) {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+CancelOrder makeCancel(const std::string &id, const std::string &orig) {
+    CancelOrder cancel;
+    cancel.clOrderId = id;
+    cancel.origClOrderId = orig;
+    cancel.market = Market::XSHG;
+    cancel.securityId = "600030";
+    cancel.shareholderId = "SH001";
+    cancel.side = Side::SELL;
+    return cancel;
+}
+
+} // namespace
+
+TEST(BasicTradeSystem, ExchangeModeMatchesTradeSystem) {
+    ClientLog typed;
+    BasicTradeSystem<TradeMode::EXCHANGE, ClientLog> basic(typed);
+    VirtualClientLog erased;
+    TradeSystem system;
+    system.setClientSink(&erased);
+
+    auto run = [](auto &target) {
+        target.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+        target.handleOrder(makeOrder("S2", Side::SELL, 10.1, 200, "SH001"));
+        target.handleOrder(makeOrder("B1", Side::BUY, 10.5, 400, "SH002"));
+        // 对敲
+        target.handleOrder(makeOrder("B2", Side::BUY, 10.1, 100, "SH001"));
+        target.handleCancel(makeCancel("C1", "S2"));
+        target.handleCancel(makeCancel("C2", "S1"));
+        target.handleOrderRaw(R"({"clOrderId":"BAD"})");
+    };
+    run(basic);
+    run(system);
+
+    const auto &expected = erased.log;
+    ASSERT_EQ(typed.orders.size(), expected.orders.size());
+    for (size_t i = 0; i < expected.orders.size(); i++) {
+        EXPECT_EQ(typed.orders[i].clOrderId, expected.orders[i].clOrderId);
+        EXPECT_EQ(typed.orders[i].type, expected.orders[i].type);
+        EXPECT_EQ(typed.orders[i].qty, expected.orders[i].qty);
+        EXPECT_EQ(typed.orders[i].execQty, expected.orders[i].execQty);
+        EXPECT_EQ(typed.orders[i].rejectCode, expected.orders[i].rejectCode);
+    }
+    ASSERT_EQ(typed.cancels.size(), 2u);
+    ASSERT_EQ(expected.cancels.size(), 2u);
+    EXPECT_EQ(typed.cancels[0].type, CancelResponse::CONFIRM);
+    EXPECT_EQ(typed.cancels[0].canceledQty, 100u);
+    EXPECT_EQ(typed.cancels[1].type, CancelResponse::REJECT);
+    EXPECT_EQ(expected.cancels[1].type, CancelResponse::REJECT);
+}
+
+TEST(BasicTradeSystem, PreExchangeModeWaitsForCancelConfirm) {
+    ClientLog client;
+    ExchangeLog exchange;
+    BasicTradeSystem<TradeMode::PRE_EXCHANGE, ClientLog, ExchangeLog> system(
+        client, exchange);
+
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("S2", Side::SELL, 10.0, 100, "SH003"));
+    ASSERT_EQ(exchange.orders.size(), 2u);
+    EXPECT_TRUE(client.orders.empty());
+
+    // 撮合两个对手方，分别撤回
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 300, "SH002"));
+    ASSERT_EQ(exchange.cancels.size(), 2u);
+    EXPECT_TRUE(client.orders.empty());
+
+    // 撤单回报带回系统生成的撤单编号
+    CancelResponse confirm;
+    confirm.clOrderId = exchange.cancels[0].clOrderId;
+    confirm.origClOrderId = "S1";
+    confirm.type = CancelResponse::CONFIRM;
+    system.handleResponse(confirm);
+    EXPECT_TRUE(client.orders.empty());
+
+    CancelResponse reject;
+    reject.clOrderId = exchange.cancels[1].clOrderId;
+    reject.origClOrderId = "S2";
+    reject.type = CancelResponse::REJECT;
+    system.handleResponse(reject);
+    // 重复回报被丢弃
+    system.handleResponse(reject);
+
+    // S1 成交生效，S2 作废；剩余 200 转发交易所
+    ASSERT_EQ(client.orders.size(), 2u);
+    EXPECT_EQ(client.orders[0].clOrderId, "S1");
+    EXPECT_EQ(client.orders[1].clOrderId, "B1");
+    EXPECT_EQ(client.orders[1].execQty, 100u);
+    ASSERT_EQ(exchange.orders.size(), 3u);
+    EXPECT_EQ(exchange.orders[2].clOrderId, "B1");
+    EXPECT_EQ(exchange.orders[2].qty, 200u);
+
+    // 客户端撤单直接转发交易所
+    system.handleCancel(makeCancel("C1", "B1"));
+    ASSERT_EQ(exchange.cancels.size(), 3u);
+    EXPECT_EQ(exchange.cancels[2].origClOrderId, "B1");
+}
+
+TEST(BasicTradeSystem, NullSinksCompileAway) {
+    NullClientSink client;
+    BasicTradeSystem<TradeMode::EXCHANGE, NullClientSink> system(client);
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+    system.handleCancelRaw("not json");
+    SUCCEED();
+}
+
+TEST(BasicTradeSystem, UnansweredCancelsExpireAsRejected) {
+    ClientLog client;
+    ExchangeLog exchange;
+    EngineConfig config;
+    config.pendingCancelTimeoutNs = 5'000'000;
+    BasicTradeSystem<TradeMode::PRE_EXCHANGE, ClientLog, ExchangeLog> system(
+        client, exchange, config);
+
+    system.advanceTime(1'000'000'000);
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("S2", Side::SELL, 10.0, 100, "SH003"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 200, "SH002"));
+    ASSERT_EQ(exchange.cancels.size(), 2u);
+
+    CancelResponse confirm;
+    confirm.clOrderId = exchange.cancels[0].clOrderId;
+    confirm.origClOrderId = "S1";
+    confirm.type = CancelResponse::CONFIRM;
+    system.handleResponse(confirm);
+
+    system.advanceTime(1'004'000'000);
+    EXPECT_TRUE(client.orders.empty());
+
+    // S2 的撤单回报超时，按被拒结算：S1 成交，剩余 100 转发交易所
+    system.advanceTime(1'006'000'000);
+    ASSERT_EQ(client.orders.size(), 2u);
+    EXPECT_EQ(client.orders[0].clOrderId, "S1");
+    EXPECT_EQ(client.orders[1].clOrderId, "B1");
+    ASSERT_EQ(exchange.orders.size(), 3u);
+    EXPECT_EQ(exchange.orders[2].qty, 100u);
+
+    // 超时前同一股东反向下单构成对敲：S2 仍被视为在交易所挂着
+    system.handleOrder(makeOrder("B2", Side::BUY, 10.0, 100, "SH003"));
+    ASSERT_EQ(client.orders.size(), 3u);
+    EXPECT_EQ(client.orders[2].rejectCode, ORDER_CROSS_TRADE_REJECT_CODE);
+
+    // 迟到的撤单确认：S2 其实已在交易所撤销，转发给其所有者并清理风控
+    CancelResponse late;
+    late.clOrderId = exchange.cancels[1].clOrderId;
+    late.origClOrderId = "S2";
+    late.type = CancelResponse::CONFIRM;
+    system.handleResponse(late);
+    ASSERT_EQ(client.cancels.size(), 1u);
+    EXPECT_EQ(client.cancels[0].origClOrderId, "S2");
+    EXPECT_EQ(client.cancels[0].type, CancelResponse::CONFIRM);
+    system.handleOrder(makeOrder("B3", Side::BUY, 10.0, 100, "SH003"));
+    EXPECT_EQ(client.orders.size(), 3u);
+    EXPECT_EQ(exchange.orders.back().clOrderId, "B3");
+
+    // 重复的回报被丢弃
+    system.handleResponse(late);
+    EXPECT_EQ(client.cancels.size(), 1u);
+}
@@ -0,0 +1,174 @@
+#include "constants.h"
+#include "engine_metrics.h"
+#include "trade_system.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+using namespace hdf;
+
+namespace {
+
+Order makeOrder(const std::string &id, Side side, double price, uint32_t qty,
+                const char *shareholder, const char *security = "600030") {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = security;
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+CancelOrder makeCancel(const std::string &id, const std::string &orig) {
+    CancelOrder cancel;
+    cancel.clOrderId = id;
+    cancel.origClOrderId = orig;
+    cancel.market = Market::XSHG;
+    cancel.securityId = "600030";
+    cancel.shareholderId = "SH001";
+    cancel.side = Side::SELL;
+    return cancel;
+}
+
+struct IgnoreExchange : ExchangeSink {
+    void onOrder(const Order &) override {}
+    void onCancel(const CancelOrder &) override {}
+};
+
+} // namespace
+
+TEST(EngineMetrics, CountsMessagesRejectsAndDepth) {
+    EngineMetrics metrics;
+    TradeSystem system;
+    system.setMetrics(&metrics);
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("S2", Side::SELL, 10.1, 100, "SH001"));
+    system.handleOrder(makeOrder("X1", Side::SELL, 20.0, 100, "SH002",
+                                 "000001"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 9.0, 100, "SH001"));
+    system.handleCancel(makeCancel("C1", "S2"));
+    system.handleCancel(makeCancel("C2", "NOPE"));
+    system.handleOrderRaw("{not json");
+
+    MetricsSnapshot before = metrics.snapshot();
+    EXPECT_EQ(before.publishCount, 0u);
+    EXPECT_EQ(before.gauge(MetricGauge::RESTING_ORDERS), 0u);
+
+    system.publishMetrics();
+    MetricsSnapshot s = metrics.snapshot();
+    EXPECT_EQ(s.publishCount, 1u);
+    EXPECT_EQ(s.counter(MetricCounter::ORDERS), 4u);
+    EXPECT_EQ(s.counter(MetricCounter::CANCELS), 2u);
+    EXPECT_EQ(s.rejects[ORDER_CROSS_TRADE_REJECT_CODE], 1u);
+    EXPECT_EQ(s.rejects[ORDER_INVALID_FORMAT_REJECT_CODE], 1u);
+    EXPECT_EQ(s.rejects[CANCEL_ORDER_NOT_FOUND_REJECT_CODE], 1u);
+    EXPECT_EQ(s.gauge(MetricGauge::RESTING_ORDERS), 2u);
+    EXPECT_EQ(s.gauge(MetricGauge::RISK_ORDERS), 2u);
+    EXPECT_EQ(s.gauge(MetricGauge::RISK_BUCKETS), 2u);
+    EXPECT_EQ(s.gauge(MetricGauge::SECURITIES), 2u);
+    EXPECT_GT(s.gauge(MetricGauge::MATCHING_BYTES), 0u);
+    EXPECT_GT(s.gauge(MetricGauge::RISK_BYTES), 0u);
+    ASSERT_EQ(s.securities.size(), 2u);
+    EXPECT_EQ(s.securities[0].securityId, "600030");
+    EXPECT_EQ(s.securities[0].restingOrders, 1u);
+    EXPECT_EQ(s.securities[1].restingOrders, 1u);
+
+    std::string text = s.toText();
+    EXPECT_NE(text.find("hdf_orders_total 4\n"), std::string::npos);
+    EXPECT_NE(text.find("hdf_rejects_total{code=\"1\"} 1\n"),
+              std::string::npos);
+    EXPECT_NE(
+        text.find("hdf_security_resting_orders{security=\"XSHG.000001\"} 1\n"),
+        std::string::npos);
+    nlohmann::json j = nlohmann::json::parse(s.toJson());
+    EXPECT_EQ(j["gauges"]["resting_orders"], 2);
+    EXPECT_EQ(j["rejects"]["3"], 1);
+    EXPECT_EQ(j["securities"]["XSHG.600030"], 1);
+}
+
+TEST(EngineMetrics, PendingMatchSizeAndAge) {
+    // 默认配置：没有撤单回报超时，调用方从不调用 advanceTime
+    EngineMetrics metrics;
+    IgnoreExchange exchange;
+    TradeSystem system;
+    system.setExchangeSink(&exchange);
+    system.setMetrics(&metrics);
+    uint64_t before = EngineMetrics::clockNs();
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("S2", Side::SELL, 10.0, 100, "SH003"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 200, "SH002"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    system.publishMetrics();
+    uint64_t after = EngineMetrics::clockNs();
+
+    MetricsSnapshot s = metrics.snapshot();
+    EXPECT_GE(s.publishedNs, before);
+    EXPECT_LE(s.publishedNs, after);
+    EXPECT_EQ(s.gauge(MetricGauge::PENDING_MATCHES), 1u);
+    EXPECT_EQ(s.gauge(MetricGauge::PENDING_CANCELS), 2u);
+    EXPECT_GE(s.gauge(MetricGauge::OLDEST_PENDING_AGE_NS), 5'000'000u);
+    EXPECT_LE(s.gauge(MetricGauge::OLDEST_PENDING_AGE_NS), after - before);
+    EXPECT_GT(s.gauge(MetricGauge::PENDING_MATCH_BYTES), 0u);
+}
+
+TEST(EngineMetrics, PendingMatchBeforeMetricsHasNoAge) {
+    // 设置指标之前的撮合没有记录时间，不计入等待时间
+    EngineMetrics metrics;
+    IgnoreExchange exchange;
+    TradeSystem system;
+    system.setExchangeSink(&exchange);
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+    system.setMetrics(&metrics);
+    system.publishMetrics();
+
+    MetricsSnapshot s = metrics.snapshot();
+    EXPECT_EQ(s.gauge(MetricGauge::PENDING_MATCHES), 1u);
+    EXPECT_EQ(s.gauge(MetricGauge::OLDEST_PENDING_AGE_NS), 0u);
+}
+
+TEST(EngineMetrics, ReaderSeesConsistentSamples) {
+    EngineMetrics metrics;
+    TradeSystem system;
+    system.setMetrics(&metrics);
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> reads{0};
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            MetricsSnapshot s = metrics.snapshot();
+            uint64_t sum = 0;
+            for (const auto &security : s.securities) {
+                sum += security.restingOrders;
+            }
+            // 同一次采样中各股票挂单之和等于总挂单数
+            if (s.publishCount > 0 &&
+                sum != s.gauge(MetricGauge::RESTING_ORDERS)) {
+                torn++;
+            }
+            reads++;
+        }
+    });
+
+    const char *securities[] = {"600030", "600031", "600032", "600033"};
+    for (int i = 0; i < 20000; ++i) {
+        system.handleOrder(makeOrder("S" + std::to_string(i), Side::SELL,
+                                     10.0 + (i % 7) * 0.01, 100, "SH001",
+                                     securities[i % 4]));
+        if (i % 3 == 0) {
+            system.handleCancel(
+                makeCancel("C" + std::to_string(i), "S" + std::to_string(i)));
+        }
+        system.publishMetrics();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(torn.load(), 0u);
+}
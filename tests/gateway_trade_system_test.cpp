@@ -0,0 +1,169 @@
+#include "gateway_trade_system.h"
+#include "mpsc_queue.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hdf;
+
+TEST(MpscQueue, PushPopAndWrapAround) {
+    MpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    std::vector<int> popped;
+    auto collect = [&](int &v) { popped.push_back(v); };
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            EXPECT_TRUE(queue.tryPush(round * 10 + i));
+        }
+        EXPECT_FALSE(queue.tryPush(99)); // 已满
+        EXPECT_EQ(queue.size(), 4u);
+        EXPECT_EQ(queue.popBatch(collect, 3), 3u);
+        EXPECT_EQ(queue.popBatch(collect, 3), 1u);
+        EXPECT_EQ(queue.popBatch(collect, 3), 0u);
+        EXPECT_TRUE(queue.empty());
+    }
+    ASSERT_EQ(popped.size(), 12u);
+    EXPECT_EQ(popped[4], 10);
+    EXPECT_EQ(popped[11], 23);
+}
+
+TEST(MpscQueue, PerProducerOrderingAcrossThreads) {
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t COUNT = 50000;
+    MpscQueue<uint64_t> queue(64);
+
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&, p] {
+            for (uint64_t i = 0; i < COUNT; i++) {
+                queue.push(p << 32 | i);
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    bool ordered = true;
+    uint64_t received = 0;
+    SpinWait idle;
+    while (received < PRODUCERS * COUNT) {
+        size_t n = queue.popBatch(
+            [&](uint64_t &v) {
+                uint64_t producer = v >> 32;
+                ordered = ordered && (v & 0xffffffff) == next[producer];
+                next[producer]++;
+            },
+            16);
+        received += n;
+        if (n == 0) {
+            idle.wait();
+        } else {
+            idle.reset();
+        }
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.empty());
+}
+
+namespace {
+
+struct CountingSink : ClientSink {
+    std::vector<OrderResponse> orders;
+    std::vector<CancelResponse> cancels;
+
+    void onOrderResponse(const OrderResponse &r) override {
+        orders.push_back(r);
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        cancels.push_back(r);
+    }
+};
+
+Order makeOrder(const std::string &id, const char *shareholder, Side side) {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.side = side;
+    order.price = Price::fromDouble(10.0);
+    order.qty = 100;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+} // namespace
+
+TEST(GatewayTradeSystem, ConcurrentGatewaysAllProcessed) {
+    constexpr int GATEWAYS = 4;
+    constexpr int PER_GATEWAY = 2000;
+    const char *shareholders[GATEWAYS] = {"SH001", "SH002", "SH003",
+                                          "SH004"};
+
+    CountingSink sink;
+    GatewayTradeSystem system(sink, nullptr, {}, GATEWAYS, 16);
+
+    std::vector<std::thread> threads;
+    for (int g = 0; g < GATEWAYS; g++) {
+        threads.emplace_back([&, g] {
+            auto gateway = system.openGateway();
+            uint64_t last = 0;
+            for (int i = 0; i < PER_GATEWAY; i++) {
+                // 偶数网关买、奇数网关卖，互相成交而不触发对敲
+                last = gateway.submitOrder(makeOrder(
+                    "G" + std::to_string(g) + "-" + std::to_string(i),
+                    shareholders[g], g % 2 ? Side::SELL : Side::BUY));
+            }
+            EXPECT_EQ(last, uint64_t{PER_GATEWAY});
+            SpinWait wait;
+            while (gateway.processedSequence() < last) {
+                wait.wait();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_THROW(system.openGateway(), std::length_error);
+    system.stop();
+
+    auto stats = system.stats();
+    EXPECT_EQ(stats.depth, 0u);
+    EXPECT_EQ(stats.dequeued, uint64_t{GATEWAYS * PER_GATEWAY});
+    EXPECT_GE(stats.batches, 1u);
+    EXPECT_GE(stats.totalLatencyNs, stats.maxLatencyNs);
+
+    // 数量相同，每笔成交恰好一张挂单对一张主动单：挂单有确认、主动单全部成交
+    // 不发确认；每笔成交两条回报
+    size_t confirms = 0, fills = 0;
+    for (const auto &r : sink.orders) {
+        if (r.type == OrderResponse::CONFIRM) {
+            confirms++;
+        } else if (r.type == OrderResponse::EXECUTION) {
+            fills++;
+        }
+    }
+    EXPECT_EQ(confirms, size_t{GATEWAYS * PER_GATEWAY / 2});
+    EXPECT_EQ(fills, size_t{GATEWAYS * PER_GATEWAY});
+}
+
+TEST(GatewayTradeSystem, RawRejectKeepsGatewaySequence) {
+    CountingSink sink;
+    GatewayTradeSystem system(sink, nullptr);
+    auto gateway = system.openGateway();
+
+    EXPECT_EQ(gateway.submitOrderRaw(R"({"clOrderId":"BAD","qty":1})"), 1u);
+    EXPECT_EQ(gateway.submitOrder(makeOrder("O1", "SH001", Side::BUY)), 2u);
+    EXPECT_EQ(gateway.submitCancelRaw(R"({"clOrderId":"C1"})"), 3u);
+    system.stop();
+
+    EXPECT_EQ(gateway.processedSequence(), 3u);
+    ASSERT_EQ(sink.orders.size(), 2u);
+    EXPECT_EQ(sink.orders[0].type, OrderResponse::REJECT);
+    EXPECT_EQ(sink.orders[1].type, OrderResponse::CONFIRM);
+    ASSERT_EQ(sink.cancels.size(), 1u);
+    EXPECT_EQ(sink.cancels[0].type, CancelResponse::REJECT);
+}
@@ -0,0 +1,297 @@
+#include "journal.h"
+#include "trade_system.h"
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/resource.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+struct ClientLog : ClientSink {
+    std::vector<OrderResponse> orders;
+    std::vector<CancelResponse> cancels;
+
+    void onOrderResponse(const OrderResponse &r) override {
+        orders.push_back(r);
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        cancels.push_back(r);
+    }
+};
+
+struct ExchangeLog : ExchangeSink {
+    std::vector<Order> orders;
+    std::vector<CancelOrder> cancels;
+
+    void onOrder(const Order &order) override { orders.push_back(order); }
+    void onCancel(const CancelOrder &cancel) override {
+        cancels.push_back(cancel);
+    }
+};
+
+Order makeOrder(const std::string &id, Side side, double price, uint32_t qty,
+                const char *shareholder) {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+CancelOrder makeCancel(const std::string &id, const std::string &orig) {
+    CancelOrder cancel;
+    cancel.clOrderId = id;
+    cancel.origClOrderId = orig;
+    cancel.market = Market::XSHG;
+    cancel.securityId = "600030";
+    cancel.shareholderId = "SH001";
+    cancel.side = Side::SELL;
+    return cancel;
+}
+
+std::string tempJournal(const char *name) {
+    std::string path = testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+} // namespace
+
+TEST(Journal, RecordsAreReadBackInOrder) {
+    std::string path = tempJournal("journal_records.hdj");
+    {
+        JournalWriter writer(path);
+        EXPECT_EQ(writer.append(makeOrder("S1", Side::SELL, 10.0, 100,
+                                          "SH001")),
+                  1u);
+        EXPECT_EQ(writer.append(makeCancel("C1", "S1")), 2u);
+        EXPECT_EQ(writer.appendTime(42), 3u);
+        EXPECT_EQ(writer.committedSequence(), 0u);
+        writer.commit();
+        EXPECT_EQ(writer.committedSequence(), 3u);
+    }
+
+    JournalReader reader(path);
+    std::vector<uint64_t> sequences;
+    std::vector<journal::RecordKind> kinds;
+    JournalScan scan = reader.forEach(
+        [&](uint64_t seq, journal::RecordKind kind,
+            std::span<const uint8_t>) {
+            sequences.push_back(seq);
+            kinds.push_back(kind);
+        });
+    EXPECT_EQ(scan.records, 3u);
+    EXPECT_EQ(scan.lastSequence, 3u);
+    EXPECT_FALSE(scan.truncated);
+    EXPECT_EQ(sequences, (std::vector<uint64_t>{1, 2, 3}));
+    EXPECT_EQ(kinds[0], journal::RecordKind::WIRE);
+    EXPECT_EQ(kinds[2], journal::RecordKind::TIME);
+}
+
+TEST(Journal, GroupCommitsWhenFull) {
+    std::string path = tempJournal("journal_group.hdj");
+    JournalOptions options;
+    options.sync = JournalSync::NONE;
+    options.groupRecords = 2;
+    JournalWriter writer(path, options);
+    writer.appendTime(1);
+    EXPECT_EQ(writer.committedSequence(), 0u);
+    writer.appendTime(2);
+    EXPECT_EQ(writer.committedSequence(), 2u);
+    writer.appendTime(3);
+    EXPECT_EQ(writer.committedSequence(), 2u);
+}
+
+TEST(Journal, ReplayRebuildsBook) {
+    std::string path = tempJournal("journal_replay.hdj");
+    ClientLog live;
+    {
+        JournalWriter writer(path);
+        TradeSystem system;
+        system.setClientSink(&live);
+        system.setJournal(&writer);
+        system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+        system.handleOrder(makeOrder("S2", Side::SELL, 10.1, 200, "SH001"));
+        system.handleCancel(makeCancel("C1", "S2"));
+        system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+    }
+
+    TradeSystem restored;
+    JournalScan scan = JournalReader(path).replay(restored);
+    EXPECT_EQ(scan.records, 4u);
+
+    // 重建后的撮合簿：S1 剩余 200，S2 已撤
+    ClientLog after;
+    restored.setClientSink(&after);
+    restored.handleCancel(makeCancel("C2", "S2"));
+    restored.handleOrder(makeOrder("B2", Side::BUY, 10.0, 200, "SH002"));
+    ASSERT_EQ(after.cancels.size(), 1u);
+    EXPECT_EQ(after.cancels[0].type, CancelResponse::REJECT);
+    ASSERT_EQ(after.orders.size(), 2u);
+    EXPECT_EQ(after.orders[0].clOrderId, "S1");
+    EXPECT_EQ(after.orders[0].execQty, 200u);
+    EXPECT_EQ(after.orders[1].clOrderId, "B2");
+}
+
+TEST(Journal, ReplayReproducesPendingCancelTimeout) {
+    std::string path = tempJournal("journal_timeout.hdj");
+    EngineConfig config;
+    config.pendingCancelTimeoutNs = 5'000'000;
+
+    auto run = [](TradeSystem &system, ExchangeLog &exchange) {
+        system.advanceTime(1'000'000'000);
+        system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+        system.handleOrder(makeOrder("S2", Side::SELL, 10.0, 100, "SH003"));
+        system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 200, "SH002"));
+        CancelResponse confirm;
+        confirm.clOrderId = exchange.cancels[0].clOrderId;
+        confirm.origClOrderId = "S1";
+        confirm.type = CancelResponse::CONFIRM;
+        system.handleResponse(confirm);
+        system.advanceTime(1'006'000'000);
+    };
+
+    ClientLog live;
+    ExchangeLog liveExchange;
+    {
+        JournalWriter writer(path);
+        TradeSystem system(config);
+        system.setClientSink(&live);
+        system.setExchangeSink(&liveExchange);
+        system.setJournal(&writer);
+        run(system, liveExchange);
+    }
+    ASSERT_EQ(live.orders.size(), 2u);
+
+    ClientLog replayed;
+    ExchangeLog replayedExchange;
+    TradeSystem restored(config);
+    restored.setClientSink(&replayed);
+    restored.setExchangeSink(&replayedExchange);
+    JournalScan scan = JournalReader(path).replay(restored);
+    EXPECT_EQ(scan.records, 6u);
+    ASSERT_EQ(replayed.orders.size(), live.orders.size());
+    for (size_t i = 0; i < live.orders.size(); ++i) {
+        EXPECT_EQ(replayed.orders[i].clOrderId, live.orders[i].clOrderId);
+        EXPECT_EQ(replayed.orders[i].execQty, live.orders[i].execQty);
+    }
+    EXPECT_EQ(replayedExchange.orders.size(), liveExchange.orders.size());
+}
+
+TEST(Journal, TornTailIsTruncatedOnReopen) {
+    std::string path = tempJournal("journal_torn.hdj");
+    {
+        JournalWriter writer(path);
+        writer.appendTime(1);
+        writer.appendTime(2);
+        writer.appendTime(3);
+    }
+    // 模拟崩溃：最后一条记录只写了一半
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    auto fullSize = static_cast<off_t>(in.tellg());
+    in.close();
+    ASSERT_EQ(::truncate(path.c_str(), fullSize - 4), 0);
+
+    {
+        JournalScan scan = JournalReader(path).forEach(
+            [](uint64_t, journal::RecordKind, std::span<const uint8_t>) {});
+        EXPECT_TRUE(scan.truncated);
+        EXPECT_EQ(scan.records, 2u);
+    }
+
+    {
+        JournalWriter writer(path);
+        EXPECT_EQ(writer.nextSequence(), 3u);
+        writer.appendTime(4);
+    }
+
+    std::vector<uint64_t> times;
+    JournalScan scan = JournalReader(path).forEach(
+        [&times](uint64_t, journal::RecordKind,
+                 std::span<const uint8_t> payload) {
+            times.push_back(journal::loadU64(payload.data()));
+        });
+    EXPECT_FALSE(scan.truncated);
+    EXPECT_EQ(scan.lastSequence, 3u);
+    EXPECT_EQ(times, (std::vector<uint64_t>{1, 2, 4}));
+}
+
+TEST(Journal, FailedCommitStopsWriter) {
+    std::string path = tempJournal("journal_failed.hdj");
+    JournalOptions options;
+    options.sync = JournalSync::NONE;
+    {
+        JournalWriter writer(path, options);
+        writer.appendTime(1);
+        writer.commit();
+
+        // 文件长度上限设为当前长度，下一组写不出去
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        auto size = static_cast<rlim_t>(in.tellg());
+        in.close();
+        auto oldHandler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit oldLimit;
+        ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &oldLimit), 0);
+        rlimit limit = oldLimit;
+        limit.rlim_cur = size;
+        ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+        writer.appendTime(2);
+        writer.appendTime(3);
+        EXPECT_THROW(writer.commit(), std::system_error);
+        ::setrlimit(RLIMIT_FSIZE, &oldLimit);
+        std::signal(SIGXFSZ, oldHandler);
+
+        // 缓冲中的记录没有写出，之后不能跳过它们继续编号
+        EXPECT_TRUE(writer.failed());
+        EXPECT_EQ(writer.committedSequence(), 1u);
+        EXPECT_THROW(writer.appendTime(4), std::runtime_error);
+        EXPECT_THROW(writer.commit(), std::runtime_error);
+        EXPECT_EQ(writer.nextSequence(), 4u);
+    }
+
+    JournalWriter reopened(path, options);
+    EXPECT_EQ(reopened.nextSequence(), 2u);
+}
+
+TEST(Journal, SequenceGapFailsReplay) {
+    std::string path = tempJournal("journal_gap.hdj");
+    {
+        JournalWriter writer(path);
+        writer.appendTime(1);
+        writer.appendTime(2);
+        writer.appendTime(3);
+    }
+    // 去掉中间一条完整的记录，其余记录的校验和仍然正确
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    constexpr size_t RECORD = journal::RECORD_HEADER_SIZE + 8;
+    auto middle = bytes.begin() + journal::FILE_HEADER_SIZE + RECORD;
+    bytes.erase(middle, middle + RECORD);
+    std::ofstream(path, std::ios::binary | std::ios::trunc)
+        .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+    TradeSystem system;
+    EXPECT_THROW(JournalReader(path).replay(system), std::runtime_error);
+    EXPECT_THROW(JournalWriter writer(path), std::runtime_error);
+}
+
+TEST(Journal, RejectsForeignFile) {
+    std::string path = tempJournal("journal_foreign.hdj");
+    std::ofstream(path) << "not a journal";
+    EXPECT_THROW(JournalReader reader(path), std::runtime_error);
+    EXPECT_THROW(JournalWriter writer(path), std::runtime_error);
+}
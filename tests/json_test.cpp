@@ -19,7 +19,7 @@ TEST(OrderFromJson, ValidOrder) {
     EXPECT_EQ(order.market, Market::XSHG);
     EXPECT_EQ(order.securityId, "600030");
     EXPECT_EQ(order.side, Side::BUY);
-    EXPECT_DOUBLE_EQ(order.price, 10.5);
+    EXPECT_EQ(order.price, Price::fromDouble(10.5));
     EXPECT_EQ(order.qty, 1000);
     EXPECT_EQ(order.shareholderId, "SH001");
 }
@@ -253,3 +253,55 @@ TEST(EnumConversion, MarketFromString) {
     EXPECT_THROW(market_from_string("NYSE"), std::invalid_argument);
     EXPECT_THROW(market_from_string(""), std::invalid_argument);
 }
+
+TEST(OrderFromJson, PriceNotOnTickGrid) {
+    json j = {{"clOrderId", "1001"},     {"market", "XSHG"},
+              {"securityId", "600030"},  {"side", "B"},
+              {"price", 10.005},         {"qty", 100},
+              {"shareholderId", "SH001"}};
+
+    EXPECT_THROW(j.get<Order>(), std::invalid_argument);
+}
+
+// ==================== 定点价格 ====================
+
+TEST(PriceConversion, RoundTrip) {
+    Price price = Price::fromDouble(10.05);
+    EXPECT_EQ(price.raw(), 100500);
+    EXPECT_EQ(price.ticks(), 1005);
+    EXPECT_DOUBLE_EQ(price.toDouble(), 10.05);
+    EXPECT_LT(Price::fromDouble(10.04), price);
+
+    json j = price;
+    EXPECT_DOUBLE_EQ(j.get<double>(), 10.05);
+    EXPECT_EQ(j.get<Price>(), price);
+}
+
+// ==================== 定长标识符 ====================
+
+TEST(OrderFromJson, IdentifierTooLong) {
+    json j = {{"clOrderId", "1001"},     {"market", "XSHG"},
+              {"securityId", "600030123"}, {"side", "B"},
+              {"price", 10.0},           {"qty", 100},
+              {"shareholderId", "SH001"}};
+
+    EXPECT_THROW(j.get<Order>(), std::invalid_argument);
+}
+
+TEST(FixedStringTest, EqualityAndHash) {
+    ClOrderId a = "ORD00000000000001";
+    ClOrderId b = std::string("ORD00000000000001");
+    ClOrderId c = "ORD0000000000000";
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.size(), 17);
+    EXPECT_EQ(a, "ORD00000000000001");
+    EXPECT_EQ(std::hash<ClOrderId>{}(a), std::hash<ClOrderId>{}(b));
+
+    // 重新赋值为更短的值后尾部补0，比较结果不受旧内容影响
+    a = "X";
+    b = "X";
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(json(a).get<std::string>(), "X");
+}
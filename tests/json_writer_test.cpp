@@ -0,0 +1,109 @@
+#include "constants.h"
+#include "json_writer.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+using namespace hdf;
+using json = nlohmann::json;
+
+namespace {
+
+// 把 writeJsonLine 的输出经临时文件读回
+template <typename T> std::string writeToString(const T &message) {
+    FILE *file = std::tmpfile();
+    {
+        BufferedWriter out(fileno(file), 16);
+        writeJsonLine(out, message);
+    }
+    std::string result;
+    std::rewind(file);
+    char buffer[256];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        result.append(buffer, n);
+    }
+    std::fclose(file);
+    return result;
+}
+
+OrderResponse makeResponse() {
+    OrderResponse response;
+    response.clOrderId = "1001";
+    response.market = Market::XSHG;
+    response.securityId = "600030";
+    response.side = Side::BUY;
+    response.qty = 1000;
+    response.price = Price::fromDouble(10.5);
+    response.shareholderId = "SH001";
+    return response;
+}
+
+} // namespace
+
+TEST(JsonWriter, MatchesNlohmannDump) {
+    OrderResponse confirm = makeResponse();
+    EXPECT_EQ(writeToString(confirm), json(confirm).dump() + "\n");
+
+    OrderResponse exec = makeResponse();
+    exec.type = OrderResponse::EXECUTION;
+    exec.execId = "E1";
+    exec.execQty = 300;
+    exec.execPrice = Price::fromDouble(10.0);
+    EXPECT_EQ(writeToString(exec), json(exec).dump() + "\n");
+
+    OrderResponse reject;
+    reject.clOrderId = "B\"1";
+    reject.type = OrderResponse::REJECT;
+    reject.rejectCode = ORDER_INVALID_FORMAT_REJECT_CODE;
+    reject.rejectText = "bad \\ input\n\x01";
+    EXPECT_EQ(writeToString(reject), json(reject).dump() + "\n");
+
+    CancelResponse cancel;
+    cancel.clOrderId = "C1";
+    cancel.origClOrderId = "1001";
+    cancel.market = Market::BJSE;
+    cancel.securityId = "430047";
+    cancel.shareholderId = "BJ001";
+    cancel.side = Side::SELL;
+    cancel.qty = 300;
+    cancel.price = Price::fromDouble(0.05);
+    cancel.cumQty = 100;
+    cancel.canceledQty = 200;
+    EXPECT_EQ(writeToString(cancel), json(cancel).dump() + "\n");
+
+    cancel.type = CancelResponse::REJECT;
+    cancel.rejectCode = CANCEL_ORDER_NOT_FOUND_REJECT_CODE;
+    cancel.rejectText = CANCEL_ORDER_NOT_FOUND_REJECT_REASON;
+    EXPECT_EQ(writeToString(cancel), json(cancel).dump() + "\n");
+
+    Order order;
+    order.clOrderId = "1001";
+    order.market = Market::XSHE;
+    order.securityId = "000001";
+    order.side = Side::SELL;
+    order.price = Price::fromDouble(1234.56);
+    order.qty = 7;
+    order.shareholderId = "SZ001";
+    EXPECT_EQ(writeToString(order), json(order).dump() + "\n");
+
+    CancelOrder cancelOrder{"C2", "1001", Market::XSHG, "600030", "SH001",
+                            Side::BUY};
+    EXPECT_EQ(writeToString(cancelOrder), json(cancelOrder).dump() + "\n");
+}
+
+TEST(JsonWriter, BufferedWriterFlushesLargeWrites) {
+    FILE *file = std::tmpfile();
+    std::string big(100, 'x');
+    {
+        BufferedWriter out(fileno(file), 8);
+        out.write("ab");
+        out.write(big);
+        out.put('c');
+        EXPECT_EQ(out.bytesWritten(), 103u);
+    }
+    std::fseek(file, 0, SEEK_END);
+    EXPECT_EQ(std::ftell(file), 103);
+    std::fclose(file);
+}
@@ -0,0 +1,82 @@
+#include "latency_stats.h"
+#include "trade_system.h"
+#include <gtest/gtest.h>
+
+using namespace hdf;
+
+TEST(LatencyHistogram, BucketsBoundRelativeError) {
+    // 小值精确，大值的桶上界与真实值的相对误差不超过 1/32
+    for (uint64_t v = 0; v < LatencyHistogram::SUB_BUCKETS; ++v) {
+        EXPECT_EQ(LatencyHistogram::bucketUpperBound(
+                      LatencyHistogram::bucketOf(v)),
+                  v);
+    }
+    for (uint64_t v : {32ULL, 33ULL, 63ULL, 64ULL, 1000ULL, 123456ULL,
+                       (1ULL << 39) + 12345}) {
+        size_t bucket = LatencyHistogram::bucketOf(v);
+        uint64_t upper = LatencyHistogram::bucketUpperBound(bucket);
+        EXPECT_GE(upper, v);
+        EXPECT_LE(upper - v, v / 32) << v;
+        EXPECT_LT(LatencyHistogram::bucketUpperBound(bucket - 1), v) << v;
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(~0ULL),
+              LatencyHistogram::BUCKETS - 1);
+}
+
+TEST(LatencyHistogram, Percentiles) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        h.record(v);
+    }
+    h.record(1'000'000);
+    EXPECT_EQ(h.count(), 1001u);
+    EXPECT_EQ(h.max(), 1'000'000u);
+    EXPECT_NEAR(static_cast<double>(h.percentile(0.5)), 501, 501 / 32.0);
+    EXPECT_NEAR(static_cast<double>(h.percentile(0.99)), 991, 991 / 32.0);
+    EXPECT_EQ(h.percentile(1.0), 1'000'000u);
+    h.reset();
+    EXPECT_EQ(h.count(), 0u);
+    EXPECT_EQ(h.max(), 0u);
+}
+
+TEST(LatencyStats, RecordsStagesPerMessageType) {
+    TradeSystem system;
+    system.handleOrderRaw(R"({"clOrderId":"S1","market":"XSHG",)"
+                          R"("securityId":"600030","side":"S","price":10.0,)"
+                          R"("qty":100,"shareholderId":"SH001"})");
+    system.handleOrderRaw(R"({"clOrderId":"B1","market":"XSHG",)"
+                          R"("securityId":"600030","side":"B","price":10.0,)"
+                          R"("qty":200,"shareholderId":"SH002"})");
+    CancelOrder cancel;
+    cancel.clOrderId = "C1";
+    cancel.origClOrderId = "B1";
+    system.handleCancel(cancel);
+
+    const LatencyStats &stats = system.latencyStats();
+    auto count = [&](LatencyMessage message, LatencyStage stage) {
+        return stats.summary(message, stage).count;
+    };
+    if constexpr (!LATENCY_STATS_ENABLED) {
+        EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::TOTAL), 0u);
+        EXPECT_NE(stats.format().find("disabled"), std::string::npos);
+        return;
+    }
+    EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::PARSE), 2u);
+    EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::RISK_CHECK), 2u);
+    EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::MATCH), 2u);
+    // S1 入簿；B1 成交后剩余100股入簿
+    EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::ADD_ORDER), 2u);
+    EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::TOTAL), 2u);
+    EXPECT_EQ(count(LatencyMessage::CANCEL, LatencyStage::PARSE), 0u);
+    EXPECT_EQ(count(LatencyMessage::CANCEL, LatencyStage::CANCEL), 1u);
+    EXPECT_EQ(count(LatencyMessage::CANCEL, LatencyStage::TOTAL), 1u);
+
+    LatencySummary total =
+        stats.summary(LatencyMessage::ORDER, LatencyStage::TOTAL);
+    EXPECT_LE(total.p50Ns, total.maxNs);
+    EXPECT_NE(stats.format().find("riskCheck"), std::string::npos);
+
+    system.latencyStats().reset();
+    EXPECT_EQ(count(LatencyMessage::ORDER, LatencyStage::TOTAL), 0u);
+}
@@ -7,6 +7,20 @@ using namespace hdf;
 class MatchingEngineTest : public ::testing::Test {
   protected:
     MatchingEngine engine;
+
+    Order createOrder(const std::string &clOrderId, Side side, double price,
+                      uint32_t qty,
+                      const std::string &shareholderId = "SH001") {
+        Order order;
+        order.clOrderId = clOrderId;
+        order.market = Market::XSHG;
+        order.securityId = "600030";
+        order.side = side;
+        order.price = Price::fromDouble(price);
+        order.qty = qty;
+        order.shareholderId = shareholderId;
+        return order;
+    }
 };
 
 TEST_F(MatchingEngineTest, SimpleMatch) {
@@ -15,7 +29,7 @@ TEST_F(MatchingEngineTest, SimpleMatch) {
     buyOrder.market = Market::XSHG;
     buyOrder.securityId = "600030";
     buyOrder.side = Side::BUY;
-    buyOrder.price = 10.0;
+    buyOrder.price = Price::fromDouble(10.0);
     buyOrder.qty = 1000;
     buyOrder.shareholderId = "SH001";
 
@@ -26,7 +40,7 @@ TEST_F(MatchingEngineTest, SimpleMatch) {
     sellOrder.market = Market::XSHG;
     sellOrder.securityId = "600030";
     sellOrder.side = Side::SELL;
-    sellOrder.price = 10.0;
+    sellOrder.price = Price::fromDouble(10.0);
     sellOrder.qty = 500;
     sellOrder.shareholderId = "SH002";
 
@@ -39,3 +53,198 @@ TEST_F(MatchingEngineTest, SimpleMatch) {
     EXPECT_EQ(result->executions[0].execQty, 500);
     EXPECT_EQ(result->remainingQty, 0); // 卖单完全成交，无剩余
 }
+
+TEST_F(MatchingEngineTest, NoMatchWhenPricesDoNotCross) {
+    engine.addOrder(createOrder("1001", Side::BUY, 9.99, 100));
+
+    // 卖价高于买价，不能成交
+    EXPECT_FALSE(engine.match(createOrder("1002", Side::SELL, 10.0, 100))
+                     .has_value());
+    // 其他股票没有订单簿
+    Order other = createOrder("1003", Side::SELL, 9.0, 100);
+    other.securityId = "600000";
+    EXPECT_FALSE(engine.match(other).has_value());
+}
+
+TEST_F(MatchingEngineTest, PricePriorityAndMakerPrice) {
+    engine.addOrder(createOrder("1001", Side::SELL, 10.02, 100));
+    engine.addOrder(createOrder("1002", Side::SELL, 10.00, 100));
+    engine.addOrder(createOrder("1003", Side::SELL, 10.01, 100));
+
+    auto result = engine.match(createOrder("2001", Side::BUY, 10.05, 300));
+
+    // 按卖价从低到高依次成交，成交价为被动方挂单价
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 3);
+    EXPECT_EQ(result->executions[0].clOrderId, "1002");
+    EXPECT_EQ(result->executions[0].execPrice, Price::fromDouble(10.00));
+    EXPECT_EQ(result->executions[1].clOrderId, "1003");
+    EXPECT_EQ(result->executions[1].execPrice, Price::fromDouble(10.01));
+    EXPECT_EQ(result->executions[2].clOrderId, "1001");
+    EXPECT_EQ(result->executions[2].execPrice, Price::fromDouble(10.02));
+    EXPECT_EQ(result->remainingQty, 0);
+    EXPECT_NE(result->executions[0].execId, result->executions[1].execId);
+}
+
+TEST_F(MatchingEngineTest, TimePriorityAtSamePrice) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 100));
+    engine.addOrder(createOrder("1002", Side::BUY, 10.0, 100));
+
+    auto result = engine.match(createOrder("2001", Side::SELL, 10.0, 100));
+
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 1);
+    EXPECT_EQ(result->executions[0].clOrderId, "1001");
+
+    result = engine.match(createOrder("2002", Side::SELL, 10.0, 100));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->executions[0].clOrderId, "1002");
+}
+
+TEST_F(MatchingEngineTest, PartialFillAcrossLevels) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.1, 200));
+    engine.addOrder(createOrder("1002", Side::BUY, 10.0, 300));
+
+    // 卖单吃掉第一档全部和第二档部分，剩余量返回给调用方
+    auto result = engine.match(createOrder("2001", Side::SELL, 10.0, 350));
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 2);
+    EXPECT_EQ(result->executions[0].execQty, 200);
+    EXPECT_EQ(result->executions[1].execQty, 150);
+    EXPECT_EQ(result->remainingQty, 0);
+
+    // 第二档剩余150股
+    result = engine.match(createOrder("2002", Side::SELL, 9.0, 500));
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 1);
+    EXPECT_EQ(result->executions[0].clOrderId, "1002");
+    EXPECT_EQ(result->executions[0].execQty, 150);
+    EXPECT_EQ(result->remainingQty, 350);
+}
+
+TEST_F(MatchingEngineTest, OddLotSellMatchesRoundLotBuy) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 100));
+
+    auto result = engine.match(createOrder("2001", Side::SELL, 10.0, 50));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->executions[0].execQty, 50);
+    EXPECT_EQ(result->remainingQty, 0);
+}
+
+TEST_F(MatchingEngineTest, CancelOrder) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 1000));
+    engine.match(createOrder("2001", Side::SELL, 10.0, 300));
+
+    CancelResponse response = engine.cancelOrder("1001");
+    EXPECT_EQ(response.type, CancelResponse::CONFIRM);
+    EXPECT_EQ(response.origClOrderId, "1001");
+    EXPECT_EQ(response.securityId, "600030");
+    EXPECT_EQ(response.qty, 1000);
+    EXPECT_EQ(response.cumQty, 300);
+    EXPECT_EQ(response.canceledQty, 700);
+
+    // 撤单后不再参与撮合，重复撤单被拒绝
+    EXPECT_FALSE(engine.match(createOrder("2002", Side::SELL, 10.0, 100))
+                     .has_value());
+    EXPECT_EQ(engine.cancelOrder("1001").type, CancelResponse::REJECT);
+}
+
+TEST_F(MatchingEngineTest, ReduceOrderQty) {
+    engine.addOrder(createOrder("1001", Side::SELL, 10.0, 500));
+    engine.addOrder(createOrder("1002", Side::SELL, 10.0, 500));
+
+    engine.reduceOrderQty("1001", 200);
+    auto result = engine.match(createOrder("2001", Side::BUY, 10.0, 300));
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 1);
+    EXPECT_EQ(result->executions[0].clOrderId, "1001");
+    EXPECT_EQ(result->executions[0].execQty, 300);
+
+    // 减少到0后自动移出订单簿
+    engine.reduceOrderQty("1002", 500);
+    EXPECT_EQ(engine.cancelOrder("1002").type, CancelResponse::REJECT);
+}
+
+TEST_F(MatchingEngineTest, BookGrowsBeyondInitialRange) {
+    // 价格跨度远超初始档位范围，订单簿按需扩展
+    engine.addOrder(createOrder("1001", Side::SELL, 100.0, 100));
+    engine.addOrder(createOrder("1002", Side::SELL, 1.0, 100));
+    engine.addOrder(createOrder("1003", Side::SELL, 500.0, 100));
+
+    auto result = engine.match(createOrder("2001", Side::BUY, 1000.0, 300));
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 3);
+    EXPECT_EQ(result->executions[0].clOrderId, "1002");
+    EXPECT_EQ(result->executions[1].clOrderId, "1001");
+    EXPECT_EQ(result->executions[2].clOrderId, "1003");
+}
+
+TEST_F(MatchingEngineTest, PriceFarFromBookIsNotRested) {
+    EXPECT_TRUE(engine.addOrder(createOrder("1001", Side::SELL, 10.0, 100)));
+
+    // 离本边挂单太远的价格不入簿，也不留下句柄
+    Order far = createOrder("1002", Side::SELL, 99999.99, 100);
+    EXPECT_FALSE(engine.canRest(far));
+    EXPECT_FALSE(engine.addOrder(far));
+    EXPECT_EQ(engine.orderCount(), 1u);
+    EXPECT_EQ(engine.cancelOrder("1002").type, CancelResponse::REJECT);
+
+    // 对手方不受影响；本边撤空后以新价格重建档位范围
+    EXPECT_TRUE(engine.canRest(createOrder("2001", Side::BUY, 99999.99, 100)));
+    EXPECT_EQ(engine.cancelOrder("1001").canceledQty, 100);
+    EXPECT_TRUE(engine.addOrder(far));
+    EXPECT_FALSE(engine.canRest(createOrder("1003", Side::SELL, 10.0, 100)));
+    EXPECT_EQ(engine.cancelOrder("1002").canceledQty, 100);
+}
+
+TEST_F(MatchingEngineTest, LowSideGrowthStaysWithinMaxLevels) {
+    // 档位数组初始覆盖 [4998.72, 5001.28)
+    EXPECT_TRUE(engine.addOrder(createOrder("1001", Side::SELL, 5000.0, 100)));
+
+    // 向低价扩展到恰好 MAX_LEVELS 个价位，预留量不能再越过上限
+    EXPECT_TRUE(engine.addOrder(createOrder("1002", Side::SELL, 2379.85, 100)));
+    EXPECT_FALSE(engine.canRest(createOrder("1003", Side::SELL, 2379.83, 100)));
+    EXPECT_TRUE(engine.canRest(createOrder("1004", Side::SELL, 2379.84, 100)));
+}
+
+TEST_F(MatchingEngineTest, FilledOrderLeavesHandleIndex) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 100));
+    engine.match(createOrder("2001", Side::SELL, 10.0, 100));
+
+    // 完全成交后句柄已删除，撤单和减量都找不到该订单
+    EXPECT_EQ(engine.cancelOrder("1001").type, CancelResponse::REJECT);
+    engine.reduceOrderQty("1001", 100);
+
+    // 同一 clOrderId 可以在成交后重新入簿
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 200));
+    EXPECT_EQ(engine.cancelOrder("1001").canceledQty, 200);
+}
+
+TEST_F(MatchingEngineTest, DuplicateClOrderIdIgnored) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 100));
+    engine.addOrder(createOrder("1001", Side::BUY, 11.0, 500));
+
+    auto result = engine.match(createOrder("2001", Side::SELL, 10.0, 1000));
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->executions.size(), 1);
+    EXPECT_EQ(result->executions[0].execQty, 100);
+    EXPECT_EQ(result->remainingQty, 900);
+}
+
+TEST_F(MatchingEngineTest, BooksSeparatedByMarket) {
+    engine.addOrder(createOrder("1001", Side::BUY, 10.0, 100));
+
+    // 同一代码在深市是另一只股票，不能与沪市订单成交
+    Order sellOrder = createOrder("2001", Side::SELL, 10.0, 100);
+    sellOrder.market = Market::XSHE;
+    EXPECT_FALSE(engine.match(sellOrder).has_value());
+
+    // 预先驻留编号的订单与未驻留的订单落在同一订单簿
+    SymbolTable symbols;
+    MatchingEngine shared(symbols);
+    Order buyOrder = createOrder("1002", Side::BUY, 10.0, 100);
+    symbols.intern(buyOrder);
+    shared.addOrder(buyOrder);
+    EXPECT_TRUE(shared.match(createOrder("2002", Side::SELL, 10.0, 100))
+                    .has_value());
+}
@@ -0,0 +1,72 @@
+#include "object_pool.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace hdf;
+
+TEST(BlockPoolTest, ReusesFreedBlocks) {
+    BlockPool pool(24, 4);
+
+    void *a = pool.allocate();
+    void *b = pool.allocate();
+    EXPECT_NE(a, b);
+    EXPECT_EQ(pool.inUse(), 2);
+    EXPECT_EQ(pool.capacity(), 4);
+
+    // 释放的块优先被再次分配
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(), a);
+
+    // 超出 slab 容量时追加新的 slab
+    for (int i = 0; i < 3; ++i) {
+        pool.allocate();
+    }
+    EXPECT_EQ(pool.capacity(), 8);
+    EXPECT_EQ(pool.inUse(), 5);
+}
+
+TEST(BlockPoolTest, DeferredReserveUntilBlockSizeKnown) {
+    BlockPool pool;
+    pool.reserve(100);
+    EXPECT_EQ(pool.capacity(), 0);
+
+    // 第一次单对象分配确定块大小，并补做预分配
+    EXPECT_TRUE(pool.accepts(40));
+    EXPECT_GE(pool.capacity(), 100);
+    EXPECT_FALSE(pool.accepts(4096));
+}
+
+TEST(BlockPoolTest, HugePagesFallBackGracefully) {
+    BlockPool pool(64, 16);
+    pool.setHugePages(true);
+    pool.reserve(16);
+
+    // 无论系统是否配置了大页，都应能正常分配
+    EXPECT_GE(pool.capacity(), 16);
+    EXPECT_NE(pool.allocate(), nullptr);
+}
+
+TEST(PooledHashMapTest, NodesComeFromPool) {
+    BlockPool pool;
+    {
+        PooledHashMap<int, std::string> map{PoolAllocator<char>(pool)};
+        map.reserve(64);
+        for (int i = 0; i < 50; ++i) {
+            map.emplace(i, std::to_string(i));
+        }
+        EXPECT_EQ(pool.inUse(), 50);
+        for (int i = 0; i < 50; i += 2) {
+            map.erase(i);
+        }
+        EXPECT_EQ(pool.inUse(), 25);
+        EXPECT_EQ(map.at(7), "7");
+
+        // 再次插入复用空闲块，不再扩容
+        size_t capacity = pool.capacity();
+        for (int i = 100; i < 125; ++i) {
+            map.emplace(i, "x");
+        }
+        EXPECT_EQ(pool.capacity(), capacity);
+    }
+    EXPECT_EQ(pool.inUse(), 0);
+}
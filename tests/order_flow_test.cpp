@@ -0,0 +1,137 @@
+#include "constants.h"
+#include "order_flow.h"
+#include "trade_system.h"
+#include "wire_protocol.h"
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+using Kind = OrderFlowGenerator::Message::Kind;
+
+struct ClientLog : ClientSink {
+    std::vector<OrderResponse> orders;
+    std::vector<CancelResponse> cancels;
+
+    void onOrderResponse(const OrderResponse &r) override {
+        orders.push_back(r);
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        cancels.push_back(r);
+    }
+};
+
+std::vector<uint8_t> encodeStream(const OrderFlowConfig &config, size_t n) {
+    OrderFlowGenerator generator(config);
+    std::vector<uint8_t> out;
+    uint8_t buf[wire::MAX_MESSAGE_SIZE];
+    for (size_t i = 0; i < n; ++i) {
+        const auto &message = generator.next();
+        size_t len = message.kind == Kind::ORDER
+                         ? wire::encode(message.order, buf)
+                         : wire::encode(message.cancel, buf);
+        out.insert(out.end(), buf, buf + len);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(OrderFlow, SameSeedGivesSameStream) {
+    OrderFlowConfig config;
+    config.seed = 42;
+    EXPECT_EQ(encodeStream(config, 5000), encodeStream(config, 5000));
+    config.seed = 43;
+    std::vector<uint8_t> other = encodeStream(config, 5000);
+    config.seed = 42;
+    EXPECT_NE(other, encodeStream(config, 5000));
+}
+
+TEST(OrderFlow, SecurityCodesStayWithinSixDigits) {
+    OrderFlowConfig config;
+    config.securities = OrderFlowConfig::MAX_SECURITIES;
+    config.zipfExponent = 0;
+    config.shareholders = 10;
+    config.cancelRatio = 0;
+    OrderFlowGenerator generator(config);
+    std::set<std::string> codes;
+    for (size_t i = 0; i < 20000; ++i) {
+        const Order &order = generator.next().order;
+        EXPECT_EQ(order.securityId.size(), 6u);
+        codes.insert(order.securityId.str());
+    }
+    EXPECT_GT(codes.size(), 10000u);
+    EXPECT_LE(*codes.rbegin(), "999999");
+
+    config.securities = OrderFlowConfig::MAX_SECURITIES + 1;
+    EXPECT_THROW(OrderFlowGenerator{config}, std::invalid_argument);
+    config.securities = 10;
+    config.shareholders = OrderFlowConfig::MAX_SHAREHOLDERS + 1;
+    EXPECT_THROW(OrderFlowGenerator{config}, std::invalid_argument);
+}
+
+TEST(OrderFlow, OrdersAreValidAndRatiosHold) {
+    OrderFlowConfig config;
+    config.securities = 20;
+    config.cancelRatio = 0.25;
+    config.oddLotSellRatio = 0.1;
+    OrderFlowGenerator generator(config);
+
+    size_t orders = 0;
+    size_t cancels = 0;
+    size_t sells = 0;
+    size_t oddLots = 0;
+    std::set<std::string> securities;
+    std::set<std::string> ids;
+    for (size_t i = 0; i < 20000; ++i) {
+        const auto &message = generator.next();
+        if (message.kind == Kind::CANCEL) {
+            cancels++;
+            EXPECT_TRUE(ids.contains(message.cancel.origClOrderId.str()));
+            EXPECT_TRUE(ids.insert(message.cancel.clOrderId.str()).second);
+            continue;
+        }
+        const Order &order = message.order;
+        orders++;
+        EXPECT_EQ(validateOrder(order), nullptr) << order.clOrderId.view();
+        EXPECT_TRUE(ids.insert(order.clOrderId.str()).second);
+        securities.insert(order.securityId.str());
+        if (order.side == Side::SELL) {
+            sells++;
+            oddLots += order.qty % 100 != 0;
+        }
+    }
+    EXPECT_EQ(generator.generated(), 20000u);
+    EXPECT_EQ(securities.size(), 20u);
+    EXPECT_NEAR(static_cast<double>(cancels) / (orders + cancels), 0.25, 0.02);
+    EXPECT_NEAR(static_cast<double>(oddLots) / sells, 0.1, 0.02);
+}
+
+TEST(OrderFlow, SelfCrossOrdersHitRiskReject) {
+    OrderFlowConfig config;
+    config.securities = 10;
+    config.shareholders = 500;
+    config.cancelRatio = 0;
+    config.aggressiveness = 0;
+    config.selfCrossRatio = 0.05;
+    OrderFlowGenerator generator(config);
+
+    ClientLog log;
+    TradeSystem system;
+    system.setClientSink(&log);
+    for (size_t i = 0; i < 5000; ++i) {
+        system.handleOrder(generator.next().order);
+    }
+    size_t crossRejects = 0;
+    for (const OrderResponse &response : log.orders) {
+        if (response.type == OrderResponse::REJECT) {
+            EXPECT_EQ(response.rejectCode, ORDER_CROSS_TRADE_REJECT_CODE);
+            crossRejects++;
+        }
+    }
+    // 被动订单从不成交，对敲订单的目标一定还在簿上
+    EXPECT_NEAR(static_cast<double>(crossRejects) / 5000, 0.05, 0.015);
+}
@@ -0,0 +1,147 @@
+#include "constants.h"
+#include "order_parser.h"
+#include "trade_system.h"
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+using namespace hdf;
+using json = nlohmann::json;
+
+TEST(OrderParser, ParsesOrderInAnyFieldOrder) {
+    Order order;
+    const char *error = parseOrder(
+        R"( { "qty": 1000, "shareholderId": "SH001", "side": "B",
+              "price": 10.5, "securityId": "600030", "market": "XSHG",
+              "clOrderId": "1001" } )",
+        order);
+
+    ASSERT_EQ(error, nullptr);
+    EXPECT_EQ(order.clOrderId, "1001");
+    EXPECT_EQ(order.market, Market::XSHG);
+    EXPECT_EQ(order.securityId, "600030");
+    EXPECT_EQ(order.side, Side::BUY);
+    EXPECT_EQ(order.price, Price::fromDouble(10.5));
+    EXPECT_EQ(order.qty, 1000u);
+    EXPECT_EQ(order.shareholderId, "SH001");
+}
+
+TEST(OrderParser, SkipsUnknownFieldsAndDecodesEscapes) {
+    Order order;
+    const char *error = parseOrder(
+        R"({"clOrderId":"A1\/2","extra":{"a":[1,2.5e3,true,null,"x\"y"]},
+            "market":"XSHE","securityId":"000001","side":"S",
+            "price":2e1,"qty":50,"shareholderId":"SZ001"})",
+        order);
+
+    ASSERT_EQ(error, nullptr);
+    EXPECT_EQ(order.clOrderId, "A1/2");
+    EXPECT_EQ(order.price, Price::fromDouble(20.0));
+    EXPECT_EQ(order.qty, 50u);
+}
+
+TEST(OrderParser, RejectsSameInputsAsJsonParser) {
+    const char *inputs[] = {
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":10.5,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"S","price":10.5,"qty":7,"shareholderId":"SH001"})",
+        R"({"market":"XSHG","securityId":"600030","side":"B","price":10.5,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"NYSE","securityId":"600030","side":"B","price":10.5,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"X","price":10.5,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":"10.5","qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":10.5,"qty":"1000","shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":-1,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":0,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":10.505,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":100000000.00,"qty":1000,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"S","price":10.5,"qty":0,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":10.5,"qty":150,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"6000300000","side":"B","price":10.5,"qty":100,"shareholderId":"SH001"})",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":10.5,"qty":100,"shareholderId":"SH001"} x)",
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B","price":10.5,"qty":100,)",
+        R"([1,2,3])",
+        R"()",
+    };
+
+    for (const char *input : inputs) {
+        bool jsonAccepts = true;
+        try {
+            json::parse(input).get<Order>();
+        } catch (const std::exception &) {
+            jsonAccepts = false;
+        }
+        Order order;
+        EXPECT_EQ(parseOrder(input, order) == nullptr, jsonAccepts) << input;
+    }
+}
+
+TEST(OrderParser, ReportsValidationError) {
+    Order order;
+    const char *error = parseOrder(
+        R"({"clOrderId":"1","market":"XSHG","securityId":"600030","side":"B",
+            "price":10.5,"qty":150,"shareholderId":"SH001"})",
+        order);
+    ASSERT_NE(error, nullptr);
+    EXPECT_STREQ(error, "buy qty must be a multiple of 100");
+
+    error = parseOrder(R"({"clOrderId":"1"})", order);
+    ASSERT_NE(error, nullptr);
+    EXPECT_STREQ(error, "missing field: market");
+}
+
+TEST(OrderParser, ParsesCancelOrder) {
+    CancelOrder cancel;
+    const char *error = parseCancelOrder(
+        R"({"clOrderId":"C1","origClOrderId":"1001","market":"XSHG",
+            "securityId":"600030","shareholderId":"SH001","side":"B"})",
+        cancel);
+
+    ASSERT_EQ(error, nullptr);
+    EXPECT_EQ(cancel.clOrderId, "C1");
+    EXPECT_EQ(cancel.origClOrderId, "1001");
+    EXPECT_EQ(cancel.side, Side::BUY);
+
+    EXPECT_NE(parseCancelOrder(R"({"clOrderId":"C1"})", cancel), nullptr);
+}
+
+TEST(OrderParser, FindIdFieldInMalformedInput) {
+    EXPECT_EQ(findIdField(R"({"clOrderId":"B7","qty":"x"})", "clOrderId"),
+              "B7");
+    EXPECT_EQ(findIdField(R"({"qty":1,"clOrderId":"B7",)", "clOrderId"),
+              "B7");
+    EXPECT_EQ(findIdField(R"({"clOrderId":12})", "clOrderId"), "");
+    EXPECT_EQ(findIdField("not json", "clOrderId"), "");
+}
+
+TEST(OrderParser, RawEntryPointMatchesJsonEntryPoint) {
+    const char *inputs[] = {
+        R"({"clOrderId":"S1","market":"XSHG","securityId":"600030","side":"S","price":10.0,"qty":600,"shareholderId":"SH001"})",
+        R"({"clOrderId":"B1","market":"XSHG","securityId":"600030","side":"B","price":10.0,"qty":150,"shareholderId":"SH002"})",
+        R"({"clOrderId":"B2","market":"XSHG","securityId":"600030","side":"B","price":10.0,"qty":500,"shareholderId":"SH002"})",
+        R"({"clOrderId":"B3","market":"XSHG","securityId":"600030","side":"B","price":10.0,"qty":100,"shareholderId":"SH001"})",
+    };
+
+    TradeSystem jsonSystem;
+    TradeSystem rawSystem;
+    std::vector<json> jsonOutputs;
+    std::vector<json> rawOutputs;
+    jsonSystem.setSendToClient(
+        [&](const json &o) { jsonOutputs.push_back(o); });
+    rawSystem.setSendToClient(
+        [&](const json &o) { rawOutputs.push_back(o); });
+
+    for (const char *input : inputs) {
+        jsonSystem.handleOrder(json::parse(input));
+        rawSystem.handleOrderRaw(input);
+    }
+    jsonSystem.handleCancel(json::parse(R"({"clOrderId":"C1"})"));
+    rawSystem.handleCancelRaw(R"({"clOrderId":"C1"})");
+
+    ASSERT_EQ(rawOutputs.size(), jsonOutputs.size());
+    for (size_t i = 0; i < rawOutputs.size(); i++) {
+        // 格式错误的拒绝原因描述可以不同，其余字段须一致
+        rawOutputs[i].erase("rejectText");
+        jsonOutputs[i].erase("rejectText");
+        EXPECT_EQ(rawOutputs[i], jsonOutputs[i]) << i;
+    }
+    EXPECT_EQ(rawOutputs[1]["rejectCode"], ORDER_INVALID_FORMAT_REJECT_CODE);
+    EXPECT_EQ(rawOutputs[4]["rejectCode"], ORDER_CROSS_TRADE_REJECT_CODE);
+}
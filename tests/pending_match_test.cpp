@@ -0,0 +1,112 @@
+#include "pending_match.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+std::vector<OrderResponse> makeExecutions(size_t count) {
+    std::vector<OrderResponse> executions(count);
+    for (size_t i = 0; i < count; i++) {
+        executions[i].clOrderId = "M" + std::to_string(i);
+        executions[i].execQty = 100;
+    }
+    return executions;
+}
+
+} // namespace
+
+TEST(PendingMatchTable, CancelIdsMapBackToExecution) {
+    PendingMatchTable table;
+    Order active;
+    active.clOrderId = "B1";
+    auto executions = makeExecutions(70); // 跨两个位图字
+    uint32_t slot = table.acquire(active, executions, 0);
+    EXPECT_EQ(table.size(), 1u);
+
+    uint32_t answered;
+    for (size_t i = 0; i < executions.size(); i++) {
+        auto expected = i + 1 == executions.size()
+                            ? PendingMatchTable::Answer::COMPLETE
+                            : PendingMatchTable::Answer::PENDING;
+        EXPECT_EQ(table.answer(table.cancelId(slot, i), i % 3 != 0, answered),
+                  expected);
+        EXPECT_EQ(answered, slot);
+    }
+    const auto &match = table.at(slot);
+    EXPECT_TRUE(!match.isConfirmed(0) && match.isConfirmed(1));
+    EXPECT_TRUE(!match.isConfirmed(69) && match.isConfirmed(68));
+}
+
+TEST(PendingMatchTable, DuplicateAndStaleAnswersIgnored) {
+    PendingMatchTable table;
+    Order active;
+    auto executions = makeExecutions(2);
+    uint32_t slot = table.acquire(active, executions, 0);
+    ClOrderId first = table.cancelId(slot, 0);
+
+    uint32_t answered;
+    EXPECT_EQ(table.answer(first, true, answered),
+              PendingMatchTable::Answer::PENDING);
+    EXPECT_EQ(table.answer(first, true, answered),
+              PendingMatchTable::Answer::STALE);
+
+    // 槽被复用后旧编号不再匹配
+    table.release(slot);
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT_EQ(table.acquire(active, executions, 0), slot);
+    EXPECT_NE(table.cancelId(slot, 0), first);
+    EXPECT_EQ(table.answer(first, true, answered),
+              PendingMatchTable::Answer::STALE);
+
+    EXPECT_EQ(table.answer("C1", true, answered),
+              PendingMatchTable::Answer::NOT_OURS);
+    EXPECT_EQ(table.answer("#x", true, answered),
+              PendingMatchTable::Answer::NOT_OURS);
+}
+
+TEST(PendingMatchTable, LateAnswerToExpiredCancelIsReportedOnce) {
+    PendingMatchTable table;
+    Order active;
+    auto executions = makeExecutions(2);
+    uint32_t slot = table.acquire(active, executions, 0);
+    ClOrderId first = table.cancelId(slot, 0);
+    ClOrderId second = table.cancelId(slot, 1);
+
+    uint32_t answered;
+    EXPECT_EQ(table.answer(first, true, answered),
+              PendingMatchTable::Answer::PENDING);
+    table.expire(slot);
+    table.release(slot);
+    table.acquire(active, executions, 0); // 复用同一个槽
+
+    // 已回报的撤单重复回报仍是 STALE；超时的撤单首个回报是 LATE
+    EXPECT_EQ(table.answer(first, true, answered),
+              PendingMatchTable::Answer::STALE);
+    EXPECT_EQ(table.answer(second, true, answered),
+              PendingMatchTable::Answer::LATE);
+    EXPECT_EQ(table.expiredOrder(answered), "M1");
+    EXPECT_EQ(table.answer(second, true, answered),
+              PendingMatchTable::Answer::STALE);
+}
+
+TEST(PendingMatchTable, InterleavedSequencesStayUnique) {
+    PendingMatchTable shard0, shard1;
+    shard0.setCancelIdSequence(1, 2);
+    shard1.setCancelIdSequence(2, 2);
+    Order active;
+    auto executions = makeExecutions(3);
+    uint32_t slot0 = shard0.acquire(active, executions, 0);
+    uint32_t slot1 = shard1.acquire(active, executions, 0);
+    for (size_t i = 0; i < executions.size(); i++) {
+        for (size_t j = 0; j < executions.size(); j++) {
+            EXPECT_NE(shard0.cancelId(slot0, i), shard1.cancelId(slot1, j));
+        }
+    }
+
+    // 最长的编号放得进 ClOrderId
+    ClOrderId longest =
+        PendingMatchTable::makeCancelId(UINT32_MAX, UINT64_MAX);
+    EXPECT_LE(longest.size(), ClOrderId::CAPACITY);
+}
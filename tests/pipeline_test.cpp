@@ -0,0 +1,183 @@
+#include "json_writer.h"
+#include "pipelined_trade_system.h"
+#include "spsc_ring.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hdf;
+
+TEST(SpscRing, PushPopAndWrapAround) {
+    SpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    std::vector<int> popped;
+    auto collect = [&](int &v) { popped.push_back(v); };
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            EXPECT_TRUE(ring.tryPush(round * 10 + i));
+        }
+        EXPECT_FALSE(ring.tryPush(99)); // 已满
+        EXPECT_EQ(ring.popBatch(collect, 3), 3u);
+        EXPECT_EQ(ring.popBatch(collect, 3), 1u);
+        EXPECT_EQ(ring.popBatch(collect, 3), 0u);
+        EXPECT_TRUE(ring.empty());
+    }
+    ASSERT_EQ(popped.size(), 12u);
+    EXPECT_EQ(popped[4], 10);
+    EXPECT_EQ(popped[11], 23);
+}
+
+TEST(SpscRing, CrossThreadOrdering) {
+    constexpr uint64_t COUNT = 200000;
+    SpscRing<uint64_t> ring(64);
+
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < COUNT; i++) {
+            ring.push(i);
+        }
+    });
+
+    uint64_t expected = 0;
+    bool ordered = true;
+    SpinWait idle;
+    while (expected < COUNT) {
+        size_t n = ring.popBatch(
+            [&](uint64_t &v) {
+                ordered = ordered && v == expected;
+                expected++;
+            },
+            16);
+        if (n == 0) {
+            idle.wait();
+        } else {
+            idle.reset();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring.empty());
+}
+
+namespace {
+
+// 把所有输出渲染为文本行，便于比较
+struct LineSink : ClientSink, ExchangeSink {
+    std::vector<std::string> lines;
+
+    void onOrderResponse(const OrderResponse &r) override {
+        lines.push_back("C " + nlohmann::json(r).dump());
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        lines.push_back("C " + nlohmann::json(r).dump());
+    }
+    void onOrder(const Order &o) override {
+        lines.push_back("X " + nlohmann::json(o).dump());
+    }
+    void onCancel(const CancelOrder &c) override {
+        lines.push_back("X " + nlohmann::json(c).dump());
+    }
+};
+
+std::vector<std::string> makeInputs() {
+    std::vector<std::string> inputs;
+    const char *shareholders[] = {"SH001", "SH002", "SH003"};
+    for (int i = 0; i < 3000; i++) {
+        bool buy = (i * 7) % 3 == 0;
+        int price = 1000 + (i * 13) % 9;
+        int qty = buy ? 100 * (1 + i % 5) : 50 + i % 300;
+        inputs.push_back(
+            R"({"clOrderId":"O)" + std::to_string(i) +
+            R"(","market":"XSHG","securityId":")" +
+            (i % 2 ? "600030" : "600000") + R"(","side":")" +
+            (buy ? "B" : "S") + R"(","price":)" + std::to_string(price / 100) +
+            "." + std::to_string(price % 100 / 10) +
+            std::to_string(price % 10) + R"(,"qty":)" + std::to_string(qty) +
+            R"(,"shareholderId":")" + shareholders[i % 3] + R"("})");
+        if (i % 10 == 9) {
+            // 撤销较早的订单，部分已成交
+            inputs.push_back(R"({"clOrderId":"C)" + std::to_string(i) +
+                             R"(","origClOrderId":"O)" +
+                             std::to_string(i - 5) +
+                             R"(","market":"XSHG","securityId":"600030",)"
+                             R"("shareholderId":"SH001","side":"B"})");
+        }
+        if (i % 97 == 0) {
+            inputs.push_back(R"({"clOrderId":"BAD)" + std::to_string(i) +
+                             R"(","qty":1})");
+        }
+    }
+    return inputs;
+}
+
+void feed(const std::vector<std::string> &inputs, auto &&order,
+          auto &&cancel) {
+    for (const auto &input : inputs) {
+        if (input.find("origClOrderId") != std::string::npos) {
+            cancel(input);
+        } else {
+            order(input);
+        }
+    }
+}
+
+} // namespace
+
+TEST(PipelinedTradeSystem, MatchesSingleThreadedOutput) {
+    auto inputs = makeInputs();
+
+    LineSink expected;
+    TradeSystem system;
+    system.setClientSink(&expected);
+    feed(
+        inputs, [&](const std::string &s) { system.handleOrderRaw(s); },
+        [&](const std::string &s) { system.handleCancelRaw(s); });
+
+    LineSink actual;
+    {
+        // 小队列，频繁触发反压
+        PipelinedTradeSystem pipeline(actual, nullptr, {}, 8);
+        feed(
+            inputs, [&](const std::string &s) { pipeline.submitOrderRaw(s); },
+            [&](const std::string &s) { pipeline.submitCancelRaw(s); });
+    }
+
+    ASSERT_GT(expected.lines.size(), inputs.size());
+    EXPECT_EQ(actual.lines, expected.lines);
+}
+
+TEST(PipelinedTradeSystem, PreExchangeRoutesToBothSinks) {
+    LineSink sink;
+    PipelinedTradeSystem pipeline(sink, &sink);
+
+    Order sell;
+    sell.clOrderId = "S1";
+    sell.market = Market::XSHG;
+    sell.securityId = "600030";
+    sell.side = Side::SELL;
+    sell.price = Price::fromDouble(10.0);
+    sell.qty = 100;
+    sell.shareholderId = "SH001";
+    pipeline.submitOrder(sell);
+
+    Order buy = sell;
+    buy.clOrderId = "B1";
+    buy.side = Side::BUY;
+    buy.shareholderId = "SH002";
+    pipeline.submitOrder(buy);
+
+    // 第一次内部撮合占用槽0，撤单序号从1开始
+    CancelResponse confirm;
+    confirm.clOrderId = PendingMatchTable::makeCancelId(0, 1);
+    confirm.origClOrderId = "S1";
+    pipeline.submitResponse(confirm);
+    pipeline.stop();
+
+    ASSERT_EQ(sink.lines.size(), 4u);
+    EXPECT_EQ(sink.lines[0].substr(0, 2), "X ");
+    EXPECT_NE(sink.lines[1].find("\"origClOrderId\":\"S1\""),
+              std::string::npos);
+    EXPECT_NE(sink.lines[2].find("\"execQty\":100"), std::string::npos);
+    EXPECT_NE(sink.lines[3].find("\"clOrderId\":\"B1\""), std::string::npos);
+}
@@ -35,7 +35,7 @@ class RiskControllerTest : public testing::Test {
         order.market = Market::XSHG;
         order.securityId = securityId;
         order.side = side;
-        order.price = price;
+        order.price = Price::fromDouble(price);
         order.qty = qty;
         order.shareholderId = shareholderId;
         return order;
@@ -353,3 +353,71 @@ TEST_F(RiskControllerTest, ExecuteNonExistentOrder) {
                                                     Side::BUY, 10.0, 1000)),
               RiskController::RiskCheckResult::PASSED);
 }
+
+/**
+ * @brief 测试：同一桶内按任意顺序撤单，单边汇总保持正确
+ *
+ * 验证同一 (股东, 股票) 桶中的订单不按接受顺序撤销时，
+ * 剩余订单仍构成对敲，最后一笔撤销后桶被删除，订单ID可以重新使用。
+ */
+TEST_F(RiskControllerTest, CancelInAnyOrderKeepsSideTotals) {
+    riskController.onOrderAccepted(
+        createOrder("1001", "SH001", "600000", Side::BUY, 10.0, 100));
+    riskController.onOrderAccepted(
+        createOrder("1002", "SH001", "600000", Side::BUY, 10.0, 100));
+    riskController.onOrderAccepted(
+        createOrder("1003", "SH001", "600000", Side::BUY, 10.0, 100));
+
+    // 先撤最早接受的订单，其余两笔仍在汇总中
+    riskController.onOrderCanceled("1001");
+    Order sellOrder =
+        createOrder("1004", "SH001", "600000", Side::SELL, 9.0, 100);
+    EXPECT_EQ(riskController.checkOrder(sellOrder),
+              RiskController::RiskCheckResult::CROSS_TRADE);
+
+    // 再撤最后接受的订单，只剩 1002 时仍构成对敲
+    riskController.onOrderCanceled("1003");
+    EXPECT_EQ(riskController.checkOrder(sellOrder),
+              RiskController::RiskCheckResult::CROSS_TRADE);
+    riskController.onOrderCanceled("1002");
+    EXPECT_EQ(riskController.checkOrder(sellOrder),
+              RiskController::RiskCheckResult::PASSED);
+
+    // 全部撤销后桶已删除，同一订单ID可以重新接受
+    riskController.onOrderAccepted(
+        createOrder("1001", "SH001", "600000", Side::BUY, 10.0, 100));
+    EXPECT_EQ(riskController.checkOrder(sellOrder),
+              RiskController::RiskCheckResult::CROSS_TRADE);
+}
+
+/**
+ * @brief 测试：汇总数量随部分成交和撤单正确增减
+ *
+ * 验证同一方向多笔订单部分成交、撤单、完全成交交替发生时，
+ * 只有全部剩余数量归零后才不再检测到对敲。
+ */
+TEST_F(RiskControllerTest, LiveQtyTracksMixedEvents) {
+    riskController.onOrderAccepted(
+        createOrder("1001", "SH001", "600000", Side::SELL, 10.0, 300));
+    riskController.onOrderAccepted(
+        createOrder("1002", "SH001", "600000", Side::SELL, 10.0, 50));
+
+    Order buyOrder =
+        createOrder("1003", "SH001", "600000", Side::BUY, 11.0, 100);
+
+    riskController.onOrderExecuted("1001", 100);
+    riskController.onOrderCanceled("1002");
+    EXPECT_EQ(riskController.checkOrder(buyOrder),
+              RiskController::RiskCheckResult::CROSS_TRADE);
+
+    // 超量成交按剩余数量扣减，订单随即回收
+    riskController.onOrderExecuted("1001", 1000);
+    EXPECT_EQ(riskController.checkOrder(buyOrder),
+              RiskController::RiskCheckResult::PASSED);
+
+    // 已回收的订单再收到成交或撤单不影响状态
+    riskController.onOrderExecuted("1001", 100);
+    riskController.onOrderCanceled("1001");
+    EXPECT_EQ(riskController.checkOrder(buyOrder),
+              RiskController::RiskCheckResult::PASSED);
+}
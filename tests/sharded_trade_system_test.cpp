@@ -0,0 +1,246 @@
+#include "sharded_trade_system.h"
+#include <gtest/gtest.h>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+// 把所有输出渲染为文本行，便于比较
+struct LineSink : ClientSink, ExchangeSink {
+    std::vector<std::string> lines;
+
+    void onOrderResponse(const OrderResponse &r) override {
+        lines.push_back("C " + nlohmann::json(r).dump());
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        lines.push_back("C " + nlohmann::json(r).dump());
+    }
+    void onOrder(const Order &o) override {
+        lines.push_back("X " + nlohmann::json(o).dump());
+    }
+    void onCancel(const CancelOrder &c) override {
+        lines.push_back("X " + nlohmann::json(c).dump());
+    }
+};
+
+const char *securityOf(int i) {
+    static const char *securities[] = {"600000", "600030", "000001",
+                                       "000002", "600519", "300750"};
+    return securities[i % 6];
+}
+
+const char *marketOf(int i) {
+    return i % 6 < 2 || i % 6 == 4 ? "XSHG" : "XSHE";
+}
+
+std::vector<std::string> makeInputs() {
+    std::vector<std::string> inputs;
+    const char *shareholders[] = {"SH001", "SH002", "SH003"};
+    for (int i = 0; i < 3000; i++) {
+        bool buy = i / 6 % 2 == 0;
+        int price = 1000 + (i * 13) % 9;
+        int qty = buy ? 100 * (1 + i % 5) : 50 + i % 300;
+        inputs.push_back(
+            R"({"clOrderId":"O)" + std::to_string(i) + R"(","market":")" +
+            marketOf(i) + R"(","securityId":")" + securityOf(i) +
+            R"(","side":")" + (buy ? "B" : "S") +
+            R"(","price":)" + std::to_string(price / 100) + "." +
+            std::to_string(price % 100 / 10) + std::to_string(price % 10) +
+            R"(,"qty":)" + std::to_string(qty) + R"(,"shareholderId":")" +
+            shareholders[i / 6 % 3] + R"("})");
+        if (i % 10 == 9) {
+            // 撤销同一股票较早的订单，部分已成交
+            int orig = i - 6;
+            bool origBuy = orig / 6 % 2 == 0;
+            inputs.push_back(
+                R"({"clOrderId":"C)" + std::to_string(i) +
+                R"(","origClOrderId":"O)" + std::to_string(orig) +
+                R"(","market":")" + marketOf(orig) + R"(","securityId":")" +
+                securityOf(orig) + R"(","shareholderId":")" +
+                shareholders[orig / 6 % 3] + R"(","side":")" +
+                (origBuy ? "B" : "S") + R"("})");
+        }
+        if (i % 97 == 0) {
+            inputs.push_back(R"({"clOrderId":"BAD)" + std::to_string(i) +
+                             R"(","qty":1})");
+        }
+    }
+    return inputs;
+}
+
+void feed(const std::vector<std::string> &inputs, auto &&order,
+          auto &&cancel) {
+    for (const auto &input : inputs) {
+        if (input.find("origClOrderId") != std::string::npos) {
+            cancel(input);
+        } else {
+            order(input);
+        }
+    }
+}
+
+// 各分片的成交编号不同，比较时去掉
+std::vector<std::string> withoutExecIds(std::vector<std::string> lines) {
+    static const std::regex execId(R"("execId":"E[0-9]+")");
+    for (auto &line : lines) {
+        line = std::regex_replace(line, execId, R"("execId":"")");
+    }
+    return lines;
+}
+
+Order makeOrder(const char *id, const char *securityId, Side side,
+                const char *shareholderId) {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = securityId;
+    order.side = side;
+    order.price = Price::fromDouble(10.0);
+    order.qty = 100;
+    order.shareholderId = shareholderId;
+    return order;
+}
+
+} // namespace
+
+TEST(ShardedTradeSystem, MatchesSingleThreadedOutput) {
+    auto inputs = makeInputs();
+
+    LineSink expected;
+    TradeSystem system;
+    system.setClientSink(&expected);
+    feed(
+        inputs, [&](const std::string &s) { system.handleOrderRaw(s); },
+        [&](const std::string &s) { system.handleCancelRaw(s); });
+
+    LineSink actual;
+    {
+        // 小队列，频繁触发反压
+        ShardedTradeSystem sharded(3, actual, nullptr, {}, 8);
+        feed(
+            inputs, [&](const std::string &s) { sharded.submitOrderRaw(s); },
+            [&](const std::string &s) { sharded.submitCancelRaw(s); });
+    }
+
+    ASSERT_GT(expected.lines.size(), inputs.size());
+    EXPECT_EQ(withoutExecIds(actual.lines), withoutExecIds(expected.lines));
+}
+
+TEST(ShardedTradeSystem, ExecIdsUniqueAcrossShards) {
+    LineSink sink;
+    ShardedTradeSystem sharded(4, sink, nullptr);
+    const char *securities[] = {"600000", "600030", "600519", "601318",
+                                "600036", "601166", "600887", "601888"};
+    for (const char *securityId : securities) {
+        sharded.submitOrder(makeOrder((std::string("S") + securityId).c_str(),
+                                      securityId, Side::SELL, "SH001"));
+        sharded.submitOrder(makeOrder((std::string("B") + securityId).c_str(),
+                                      securityId, Side::BUY, "SH002"));
+    }
+    sharded.stop();
+
+    std::set<std::string> execIds;
+    size_t executions = 0;
+    for (const auto &line : sink.lines) {
+        auto json = nlohmann::json::parse(line.substr(2));
+        if (json.contains("execId")) {
+            execIds.insert(json["execId"].get<std::string>());
+            executions++;
+        }
+    }
+    EXPECT_EQ(executions, 16u);
+    // 同一笔成交的买卖双方共用一个编号
+    EXPECT_EQ(execIds.size(), 8u);
+}
+
+TEST(ShardedTradeSystem, PreExchangeRoutesResponsesByOrder) {
+    LineSink sink;
+    ShardedTradeSystem sharded(2, sink, &sink);
+
+    sharded.submitOrder(makeOrder("S1", "600030", Side::SELL, "SH001"));
+    sharded.submitOrder(makeOrder("B1", "600030", Side::BUY, "SH002"));
+
+    // 撤单回报不带股票，由内部撤单编号中的序号找到分片
+    // 各分片的撤单序号从分片号+1开始
+    CancelResponse confirm;
+    confirm.clOrderId = PendingMatchTable::makeCancelId(
+        0, sharded.shardOf(Market::XSHG, "600030") + 1);
+    confirm.origClOrderId = "S1";
+    sharded.submitResponse(confirm);
+    sharded.stop();
+
+    ASSERT_EQ(sink.lines.size(), 4u);
+    EXPECT_EQ(sink.lines[0].substr(0, 2), "X ");
+    EXPECT_NE(sink.lines[1].find("\"origClOrderId\":\"S1\""),
+              std::string::npos);
+    EXPECT_NE(sink.lines[2].find("\"execQty\":100"), std::string::npos);
+    EXPECT_NE(sink.lines[3].find("\"clOrderId\":\"B1\""), std::string::npos);
+}
+
+TEST(ShardedTradeSystem, PreExchangeRoutesResponsesBySecurity) {
+    LineSink sink;
+    ShardedTradeSystem sharded(4, sink, &sink);
+
+    // 找两只落在不同分片、且都不在分片0的股票
+    std::vector<std::string> securities;
+    std::set<size_t> used = {0};
+    for (int code = 600000; securities.size() < 2; ++code) {
+        std::string security = std::to_string(code);
+        if (used.insert(sharded.shardOf(Market::XSHG, security.c_str()))
+                .second) {
+            securities.push_back(security);
+        }
+    }
+
+    for (size_t i = 0; i < securities.size(); ++i) {
+        std::string id = "S" + std::to_string(i);
+        Order sell = makeOrder(id.c_str(), securities[i].c_str(), Side::SELL,
+                               "SH001");
+        sharded.submitOrder(sell);
+        // 交易所成交了挂单，回报须送到该股票的分片，从内部簿中移除
+        OrderResponse fill;
+        fill.clOrderId = sell.clOrderId;
+        fill.market = sell.market;
+        fill.securityId = sell.securityId;
+        fill.side = sell.side;
+        fill.qty = sell.qty;
+        fill.price = sell.price;
+        fill.shareholderId = sell.shareholderId;
+        fill.execId = "X" + std::to_string(i);
+        fill.execQty = sell.qty;
+        fill.execPrice = sell.price;
+        fill.type = OrderResponse::EXECUTION;
+        sharded.submitResponse(fill);
+        // 内部簿已空，买单不再内部撮合，直接转发给交易所
+        std::string buyId = "B" + std::to_string(i);
+        sharded.submitOrder(makeOrder(buyId.c_str(), securities[i].c_str(),
+                                      Side::BUY, "SH002"));
+    }
+
+    // 不带股票的成交回报无法定位分片，拒绝接收而不是交给分片0
+    OrderResponse unrouted;
+    unrouted.clOrderId = "S0";
+    unrouted.execQty = 100;
+    unrouted.type = OrderResponse::EXECUTION;
+    EXPECT_THROW(sharded.submitResponse(unrouted), std::invalid_argument);
+    CancelResponse userCancel;
+    userCancel.clOrderId = "C1";
+    userCancel.origClOrderId = "S0";
+    EXPECT_THROW(sharded.submitResponse(userCancel), std::invalid_argument);
+    sharded.stop();
+
+    ASSERT_EQ(sink.lines.size(), 6u);
+    for (size_t i = 0; i < securities.size(); ++i) {
+        EXPECT_EQ(sink.lines[i * 3].substr(0, 2), "X ");
+        EXPECT_NE(sink.lines[i * 3 + 1].find("\"execQty\":100"),
+                  std::string::npos);
+        EXPECT_EQ(sink.lines[i * 3 + 2].substr(0, 2), "X ");
+        EXPECT_NE(sink.lines[i * 3 + 2].find("\"clOrderId\":\"B"),
+                  std::string::npos);
+    }
+}
@@ -0,0 +1,260 @@
+#include "journal.h"
+#include "snapshot.h"
+#include "trade_system.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+struct ClientLog : ClientSink {
+    std::vector<OrderResponse> orders;
+    std::vector<CancelResponse> cancels;
+
+    void onOrderResponse(const OrderResponse &r) override {
+        orders.push_back(r);
+    }
+    void onCancelResponse(const CancelResponse &r) override {
+        cancels.push_back(r);
+    }
+};
+
+struct ExchangeLog : ExchangeSink {
+    std::vector<Order> orders;
+    std::vector<CancelOrder> cancels;
+
+    void onOrder(const Order &order) override { orders.push_back(order); }
+    void onCancel(const CancelOrder &cancel) override {
+        cancels.push_back(cancel);
+    }
+};
+
+Order makeOrder(const std::string &id, Side side, double price, uint32_t qty,
+                const char *shareholder, const char *security = "600030") {
+    Order order;
+    order.clOrderId = id;
+    order.market = Market::XSHG;
+    order.securityId = security;
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholder;
+    return order;
+}
+
+CancelOrder makeCancel(const std::string &id, const std::string &orig,
+                       Side side = Side::SELL) {
+    CancelOrder cancel;
+    cancel.clOrderId = id;
+    cancel.origClOrderId = orig;
+    cancel.market = Market::XSHG;
+    cancel.securityId = "600030";
+    cancel.shareholderId = "SH001";
+    cancel.side = side;
+    return cancel;
+}
+
+std::string tempPath(const char *name) {
+    std::string path = testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+void expectSameOrders(const std::vector<OrderResponse> &a,
+                      const std::vector<OrderResponse> &b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].clOrderId, b[i].clOrderId);
+        EXPECT_EQ(a[i].type, b[i].type);
+        EXPECT_EQ(a[i].qty, b[i].qty);
+        EXPECT_EQ(a[i].execId, b[i].execId);
+        EXPECT_EQ(a[i].execQty, b[i].execQty);
+        EXPECT_EQ(a[i].rejectCode, b[i].rejectCode);
+    }
+}
+
+} // namespace
+
+TEST(Snapshot, RestoredBookMatchesOriginal) {
+    std::string path = tempPath("snapshot_book.hds");
+    TradeSystem original;
+    original.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+    original.handleOrder(makeOrder("S2", Side::SELL, 10.0, 200, "SH003"));
+    original.handleOrder(makeOrder("S3", Side::SELL, 10.2, 100, "SH001"));
+    original.handleOrder(makeOrder("B1", Side::BUY, 9.8, 100, "SH002"));
+    original.handleOrder(makeOrder("X1", Side::SELL, 20.0, 100, "SH004",
+                                   "000001"));
+    original.handleOrder(makeOrder("B2", Side::BUY, 10.0, 100, "SH002"));
+    {
+        SnapshotWriter writer(path);
+        EXPECT_TRUE(original.takeSnapshot(writer));
+        writer.wait();
+    }
+
+    TradeSystem restored;
+    SnapshotReader reader(path);
+    EXPECT_EQ(restored.restoreSnapshot(reader), 0u);
+    EXPECT_EQ(reader.header().bookOrderCount, 5u);
+
+    // 之后的处理结果相同：价格时间优先、累计成交量、成交编号、对敲检测
+    ClientLog a;
+    ClientLog b;
+    original.setClientSink(&a);
+    restored.setClientSink(&b);
+    for (TradeSystem *system : {&original, &restored}) {
+        system->handleOrder(makeOrder("B3", Side::BUY, 10.2, 500, "SH002"));
+        system->handleOrder(makeOrder("B4", Side::BUY, 10.0, 100, "SH001"));
+        system->handleCancel(makeCancel("C1", "B1", Side::BUY));
+        system->handleOrder(makeOrder("B5", Side::BUY, 20.0, 100, "SH002",
+                                      "000001"));
+    }
+    expectSameOrders(a.orders, b.orders);
+    ASSERT_EQ(a.cancels.size(), b.cancels.size());
+    EXPECT_EQ(b.cancels[0].type, CancelResponse::CONFIRM);
+}
+
+TEST(Snapshot, RestoresPendingMatches) {
+    std::string path = tempPath("snapshot_pending.hds");
+    EngineConfig config;
+    config.pendingCancelTimeoutNs = 5'000'000;
+
+    ExchangeLog exchangeA;
+    TradeSystem original(config);
+    original.setExchangeSink(&exchangeA);
+    original.advanceTime(1'000'000'000);
+    original.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    original.handleOrder(makeOrder("S2", Side::SELL, 10.0, 100, "SH003"));
+    original.handleOrder(makeOrder("B1", Side::BUY, 10.0, 200, "SH002"));
+    ASSERT_EQ(exchangeA.cancels.size(), 2u);
+    CancelResponse confirm;
+    confirm.clOrderId = exchangeA.cancels[0].clOrderId;
+    confirm.origClOrderId = "S1";
+    confirm.type = CancelResponse::CONFIRM;
+    original.handleResponse(confirm);
+    {
+        SnapshotWriter writer(path);
+        EXPECT_TRUE(original.takeSnapshot(writer));
+        writer.wait();
+    }
+
+    ExchangeLog exchangeB;
+    TradeSystem restored(config);
+    restored.setExchangeSink(&exchangeB);
+    SnapshotReader reader(path);
+    restored.restoreSnapshot(reader);
+    EXPECT_EQ(reader.header().pendingMatchCount, 1u);
+
+    ClientLog a;
+    ClientLog b;
+    original.setClientSink(&a);
+    restored.setClientSink(&b);
+    // 重复的回报被丢弃，另一笔撤单超时，之后的新撮合生成相同的撤单编号
+    for (TradeSystem *system : {&original, &restored}) {
+        system->handleResponse(confirm);
+        system->advanceTime(1'006'000'000);
+        system->handleOrder(makeOrder("S3", Side::SELL, 10.0, 100, "SH001"));
+        system->handleOrder(makeOrder("B2", Side::BUY, 10.0, 100, "SH004"));
+    }
+    expectSameOrders(a.orders, b.orders);
+    ASSERT_EQ(a.orders.size(), 2u);
+    ASSERT_EQ(exchangeB.cancels.size(), 1u);
+    EXPECT_EQ(exchangeA.cancels.back().clOrderId,
+              exchangeB.cancels.back().clOrderId);
+    EXPECT_EQ(exchangeA.orders.back().qty, exchangeB.orders.back().qty);
+}
+
+TEST(Snapshot, StartupReplaysOnlyJournalTail) {
+    std::string snapshotPath = tempPath("snapshot_tail.hds");
+    std::string journalPath = tempPath("snapshot_tail.hdj");
+    {
+        JournalWriter journal(journalPath);
+        TradeSystem system;
+        system.setJournal(&journal);
+        system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+        system.handleOrder(makeOrder("S2", Side::SELL, 10.1, 200, "SH001"));
+        SnapshotWriter writer(snapshotPath);
+        EXPECT_TRUE(system.takeSnapshot(writer));
+        writer.wait();
+        EXPECT_EQ(writer.writtenSequence(), 2u);
+        system.handleCancel(makeCancel("C1", "S2"));
+        system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+    }
+
+    TradeSystem restored;
+    uint64_t sequence = restored.restoreSnapshot(SnapshotReader(snapshotPath));
+    EXPECT_EQ(sequence, 2u);
+    JournalScan scan =
+        JournalReader(journalPath).replay(restored, sequence);
+    EXPECT_EQ(scan.lastSequence, 4u);
+
+    ClientLog after;
+    restored.setClientSink(&after);
+    restored.handleCancel(makeCancel("C2", "S2"));
+    restored.handleOrder(makeOrder("B2", Side::BUY, 10.1, 300, "SH002"));
+    ASSERT_EQ(after.cancels.size(), 1u);
+    EXPECT_EQ(after.cancels[0].type, CancelResponse::REJECT);
+    ASSERT_EQ(after.orders.size(), 3u);
+    EXPECT_EQ(after.orders[0].clOrderId, "S1");
+    EXPECT_EQ(after.orders[0].execQty, 200u);
+    EXPECT_EQ(after.orders[2].clOrderId, "B2");
+}
+
+TEST(Snapshot, CaptureSeesStateAtForkTime) {
+    std::string path = tempPath("snapshot_fork.hds");
+    TradeSystem original;
+    original.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+    {
+        SnapshotWriter writer(path);
+        EXPECT_TRUE(original.takeSnapshot(writer));
+        // 子进程写出期间处理线程继续处理，之后的改动不进入快照
+        original.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+        original.handleOrder(makeOrder("S2", Side::SELL, 10.1, 200, "SH003"));
+        writer.wait();
+    }
+
+    SnapshotReader reader(path);
+    EXPECT_EQ(reader.header().bookOrderCount, 1u);
+    TradeSystem restored;
+    restored.restoreSnapshot(reader);
+    ClientLog log;
+    restored.setClientSink(&log);
+    restored.handleOrder(makeOrder("B2", Side::BUY, 10.0, 300, "SH002"));
+    ASSERT_EQ(log.orders.size(), 2u);
+    EXPECT_EQ(log.orders[0].clOrderId, "S1");
+    EXPECT_EQ(log.orders[0].execQty, 300u);
+}
+
+TEST(Snapshot, WriteFailureSurfacesFromWait) {
+    TradeSystem system;
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+    SnapshotWriter writer(testing::TempDir() + "missing_dir/snapshot.hds");
+    EXPECT_TRUE(system.takeSnapshot(writer));
+    EXPECT_THROW(writer.wait(), std::system_error);
+    EXPECT_EQ(writer.writtenSequence(), 0u);
+}
+
+TEST(Snapshot, RejectsCorruptFileAndNonEmptySystem) {
+    std::string path = tempPath("snapshot_corrupt.hds");
+    TradeSystem original;
+    original.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+    {
+        SnapshotWriter writer(path);
+        original.takeSnapshot(writer);
+    }
+
+    EXPECT_THROW(original.restoreSnapshot(SnapshotReader(path)),
+                 std::logic_error);
+
+    {
+        std::fstream file(path,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(snapshot::Header) + 1);
+        file.put('\x7f');
+    }
+    EXPECT_THROW(SnapshotReader reader(path), std::runtime_error);
+}
@@ -0,0 +1,35 @@
+#include "symbol_table.h"
+#include "types.h"
+#include <gtest/gtest.h>
+
+using namespace hdf;
+
+TEST(SymbolTableTest, AssignsDenseKeys) {
+    SymbolTable symbols;
+
+    EXPECT_EQ(symbols.internSecurity(Market::XSHG, "600030"), 0);
+    EXPECT_EQ(symbols.internSecurity(Market::XSHE, "000001"), 1);
+    EXPECT_EQ(symbols.internSecurity(Market::XSHG, "600030"), 0);
+    // 同一代码在不同市场是不同的股票
+    EXPECT_EQ(symbols.internSecurity(Market::XSHE, "600030"), 2);
+    EXPECT_EQ(symbols.securityCount(), 3);
+
+    EXPECT_EQ(symbols.internShareholder("SH001"), 0);
+    EXPECT_EQ(symbols.internShareholder("SH002"), 1);
+    EXPECT_EQ(symbols.findShareholder("SH001"), 0);
+    EXPECT_EQ(symbols.findShareholder("SH003"), INVALID_KEY);
+    EXPECT_EQ(symbols.findSecurity(Market::BJSE, "600030"), INVALID_KEY);
+}
+
+TEST(SymbolTableTest, InternOrder) {
+    SymbolTable symbols;
+    Order order;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.shareholderId = "SH001";
+
+    EXPECT_EQ(order.securityKey, INVALID_KEY);
+    symbols.intern(order);
+    EXPECT_EQ(order.securityKey, 0);
+    EXPECT_EQ(order.shareholderKey, 0);
+}
@@ -0,0 +1,74 @@
+#include "timer_wheel.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace hdf;
+
+TEST(TimerWheel, ExpiresInDeadlineOrderAcrossLevels) {
+    TimerWheel wheel(10);
+    wheel.advance(1000, [](uint64_t) {});
+
+    // 分别落在第0、1、2、3层，以及超出范围
+    std::vector<uint64_t> deadlines = {1005, 1640, 50000, 3000000,
+                                       200000000000};
+    for (size_t i = 0; i < deadlines.size(); i++) {
+        wheel.schedule(deadlines[i], i);
+    }
+    EXPECT_EQ(wheel.size(), deadlines.size());
+
+    for (size_t i = 0; i < deadlines.size(); i++) {
+        std::vector<uint64_t> fired;
+        auto collect = [&](uint64_t data) { fired.push_back(data); };
+        // 到期前一个刻度不触发，到期刻度（向上取整）触发
+        uint64_t tick = (deadlines[i] + 9) / 10 * 10;
+        EXPECT_EQ(wheel.advance(tick - 10, collect), 0u);
+        EXPECT_EQ(wheel.advance(tick, collect), 1u);
+        ASSERT_EQ(fired.size(), 1u);
+        EXPECT_EQ(fired[0], i);
+    }
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheel, CancelAndStaleHandles) {
+    TimerWheel wheel(1);
+    auto a = wheel.schedule(100, 1);
+    auto b = wheel.schedule(100, 2);
+    EXPECT_TRUE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.cancel(a));
+    EXPECT_FALSE(wheel.cancel(TimerWheel::INVALID_TIMER));
+
+    std::vector<uint64_t> fired;
+    wheel.advance(100, [&](uint64_t data) { fired.push_back(data); });
+    EXPECT_EQ(fired, std::vector<uint64_t>{2});
+    EXPECT_FALSE(wheel.cancel(b));
+
+    // 节点复用后旧句柄失效
+    auto c = wheel.schedule(200, 3);
+    EXPECT_FALSE(wheel.cancel(a));
+    EXPECT_TRUE(wheel.cancel(c));
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheel, RandomDeadlinesNeverEarlyOrLate) {
+    TimerWheel wheel(1);
+    std::mt19937_64 rng(7);
+    std::vector<uint64_t> deadlines;
+    for (int i = 0; i < 2000; i++) {
+        deadlines.push_back(1 + rng() % 300000);
+        wheel.schedule(deadlines.back(), i);
+    }
+    uint64_t now = 0;
+    size_t total = 0;
+    bool onTime = true;
+    while (wheel.size() > 0) {
+        now += 1 + rng() % 997;
+        total += wheel.advance(now, [&](uint64_t i) {
+            // 到期时刻落在本次推进的区间内
+            onTime = onTime && deadlines[i] <= now &&
+                     deadlines[i] + 997 + 1 > now;
+        });
+    }
+    EXPECT_TRUE(onTime);
+    EXPECT_EQ(total, deadlines.size());
+}
@@ -0,0 +1,304 @@
+#include "constants.h"
+#include "engine_metrics.h"
+#include "trade_system.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace hdf;
+using json = nlohmann::json;
+
+namespace {
+
+struct RecordingClientSink : ClientSink {
+    std::vector<OrderResponse> orders;
+    std::vector<CancelResponse> cancels;
+
+    void onOrderResponse(const OrderResponse &response) override {
+        orders.push_back(response);
+    }
+    void onCancelResponse(const CancelResponse &response) override {
+        cancels.push_back(response);
+    }
+};
+
+struct RecordingExchangeSink : ExchangeSink {
+    std::vector<Order> orders;
+    std::vector<CancelOrder> cancels;
+
+    void onOrder(const Order &order) override { orders.push_back(order); }
+    void onCancel(const CancelOrder &cancel) override {
+        cancels.push_back(cancel);
+    }
+};
+
+Order makeOrder(const std::string &clOrderId, Side side, double price,
+                uint32_t qty, const std::string &shareholderId) {
+    Order order;
+    order.clOrderId = clOrderId;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholderId;
+    return order;
+}
+
+} // namespace
+
+TEST(TradeSystemSink, TypedExecutionReports) {
+    TradeSystem system;
+    RecordingClientSink client;
+    system.setClientSink(&client);
+
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 300, "SH001"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.5, 500, "SH002"));
+
+    ASSERT_EQ(client.orders.size(), 4u);
+    EXPECT_EQ(client.orders[0].type, OrderResponse::CONFIRM);
+    EXPECT_EQ(client.orders[0].clOrderId, "S1");
+
+    // 被动方成交回报在前，主动方在后，成交信息相同
+    const auto &passive = client.orders[1];
+    const auto &active = client.orders[2];
+    EXPECT_EQ(passive.type, OrderResponse::EXECUTION);
+    EXPECT_EQ(passive.clOrderId, "S1");
+    EXPECT_EQ(active.type, OrderResponse::EXECUTION);
+    EXPECT_EQ(active.clOrderId, "B1");
+    EXPECT_EQ(active.side, Side::BUY);
+    EXPECT_EQ(active.qty, 500u);
+    EXPECT_EQ(active.execId, passive.execId);
+    EXPECT_EQ(active.execQty, 300u);
+    EXPECT_EQ(active.execPrice, Price::fromDouble(10.0));
+
+    // 剩余量入簿确认
+    EXPECT_EQ(client.orders[3].type, OrderResponse::CONFIRM);
+    EXPECT_EQ(client.orders[3].clOrderId, "B1");
+    EXPECT_EQ(client.orders[3].qty, 200u);
+}
+
+TEST(TradeSystemSink, ExtremePriceRejectedAndCancelSafe) {
+    TradeSystem system;
+    RecordingClientSink client;
+    system.setClientSink(&client);
+
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    // 超出价格上限的 JSON 订单按格式错误拒绝
+    system.handleOrderRaw(
+        R"({"clOrderId":"S2","market":"XSHG","securityId":"600030",)"
+        R"("side":"S","price":100000000.00,"qty":100,"shareholderId":"SH001"})");
+    // 价格合法但离本边挂单太远时拒绝
+    system.handleOrder(makeOrder("S3", Side::SELL, 99999.99, 100, "SH001"));
+    // 类型化订单同样校验取值，超出上限按格式错误拒绝
+    system.handleOrder(makeOrder("S4", Side::SELL, 1e8, 100, "SH001"));
+
+    ASSERT_EQ(client.orders.size(), 4u);
+    EXPECT_EQ(client.orders[1].rejectCode, ORDER_INVALID_FORMAT_REJECT_CODE);
+    EXPECT_EQ(client.orders[2].type, OrderResponse::REJECT);
+    EXPECT_EQ(client.orders[2].rejectCode,
+              ORDER_PRICE_OUT_OF_RANGE_REJECT_CODE);
+    EXPECT_EQ(client.orders[3].rejectCode, ORDER_INVALID_FORMAT_REJECT_CODE);
+
+    CancelOrder cancel;
+    cancel.clOrderId = "C1";
+    for (const char *id : {"S2", "S3", "S4"}) {
+        cancel.origClOrderId = id;
+        system.handleCancel(cancel);
+    }
+    cancel.origClOrderId = "S1";
+    system.handleCancel(cancel);
+    ASSERT_EQ(client.cancels.size(), 4u);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(client.cancels[i].rejectCode,
+                  CANCEL_ORDER_NOT_FOUND_REJECT_CODE);
+    }
+    EXPECT_EQ(client.cancels[3].type, CancelResponse::CONFIRM);
+}
+
+TEST(TradeSystemSink, TypedOrderValidatedBeforeMatching) {
+    TradeSystem system;
+    RecordingClientSink client;
+    system.setClientSink(&client);
+
+    // 非整数价位：按档位截断后会以高于买方限价的价格成交
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.005, 100, "SH001"));
+    // 零数量订单
+    system.handleOrder(makeOrder("S2", Side::SELL, 10.0, 0, "SH001"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+
+    ASSERT_EQ(client.orders.size(), 3u);
+    EXPECT_EQ(client.orders[0].type, OrderResponse::REJECT);
+    EXPECT_EQ(client.orders[0].clOrderId, "S1");
+    EXPECT_EQ(client.orders[0].rejectCode, ORDER_INVALID_FORMAT_REJECT_CODE);
+    EXPECT_EQ(client.orders[1].type, OrderResponse::REJECT);
+    EXPECT_EQ(client.orders[1].clOrderId, "S2");
+    EXPECT_EQ(client.orders[1].rejectCode, ORDER_INVALID_FORMAT_REJECT_CODE);
+    // B1 没有对手方，只入簿
+    EXPECT_EQ(client.orders[2].type, OrderResponse::CONFIRM);
+    EXPECT_EQ(client.orders[2].clOrderId, "B1");
+}
+
+TEST(TradeSystemSink, JsonAdapterProducesProtocolFields) {
+    TradeSystem system;
+    std::vector<json> outputs;
+    system.setSendToClient(
+        [&](const json &output) { outputs.push_back(output); });
+
+    system.handleOrder(json{{"clOrderId", "S1"},
+                            {"market", "XSHG"},
+                            {"securityId", "600030"},
+                            {"side", "S"},
+                            {"price", 10.0},
+                            {"qty", 100},
+                            {"shareholderId", "SH001"}});
+    system.handleOrder(json{{"clOrderId", "B1"},
+                            {"market", "XSHG"},
+                            {"securityId", "600030"},
+                            {"side", "B"},
+                            {"price", 10.0},
+                            {"qty", 100},
+                            {"shareholderId", "SH002"}});
+
+    ASSERT_EQ(outputs.size(), 3u);
+    EXPECT_EQ(outputs[0],
+              (json{{"clOrderId", "S1"},
+                    {"market", "XSHG"},
+                    {"securityId", "600030"},
+                    {"side", "S"},
+                    {"qty", 100},
+                    {"price", 10.0},
+                    {"shareholderId", "SH001"}}));
+    EXPECT_EQ(outputs[2]["clOrderId"], "B1");
+    EXPECT_EQ(outputs[2]["execId"], outputs[1]["execId"]);
+    EXPECT_EQ(outputs[2]["execQty"], 100);
+    EXPECT_EQ(outputs[2]["execPrice"], 10.0);
+    EXPECT_FALSE(outputs[2].contains("rejectCode"));
+}
+
+TEST(TradeSystemSink, InvalidFormatRejectKeepsClOrderId) {
+    TradeSystem system;
+    std::vector<json> outputs;
+    system.setSendToClient(
+        [&](const json &output) { outputs.push_back(output); });
+
+    system.handleOrder(json{{"clOrderId", "B1"}, {"market", "XSHG"}});
+    system.handleCancel(json{{"clOrderId", "C1"}, {"origClOrderId", "B1"}});
+
+    ASSERT_EQ(outputs.size(), 2u);
+    EXPECT_EQ(outputs[0]["clOrderId"], "B1");
+    EXPECT_EQ(outputs[0]["rejectCode"], ORDER_INVALID_FORMAT_REJECT_CODE);
+    EXPECT_FALSE(outputs[0].contains("market"));
+    EXPECT_EQ(outputs[1]["clOrderId"], "C1");
+    EXPECT_EQ(outputs[1]["origClOrderId"], "B1");
+    EXPECT_EQ(outputs[1]["rejectCode"], ORDER_INVALID_FORMAT_REJECT_CODE);
+}
+
+TEST(TradeSystemSink, PreExchangeWaitsForCancelConfirm) {
+    TradeSystem system;
+    RecordingClientSink client;
+    RecordingExchangeSink exchange;
+    system.setClientSink(&client);
+    system.setExchangeSink(&exchange);
+
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    ASSERT_EQ(exchange.orders.size(), 1u);
+    EXPECT_EQ(exchange.orders[0].clOrderId, "S1");
+
+    // 内部撮合成功，先向交易所撤回对手方订单
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+    ASSERT_EQ(exchange.cancels.size(), 1u);
+    EXPECT_EQ(exchange.cancels[0].origClOrderId, "S1");
+    EXPECT_TRUE(client.orders.empty());
+
+    CancelResponse confirm;
+    confirm.clOrderId = exchange.cancels[0].clOrderId;
+    confirm.origClOrderId = "S1";
+    confirm.type = CancelResponse::CONFIRM;
+    system.handleResponse(confirm);
+
+    ASSERT_EQ(client.orders.size(), 2u);
+    EXPECT_EQ(client.orders[0].clOrderId, "S1");
+    EXPECT_EQ(client.orders[1].clOrderId, "B1");
+    EXPECT_EQ(client.orders[1].execQty, 100u);
+    EXPECT_EQ(exchange.orders.size(), 1u);
+}
+
+TEST(TradeSystemSink, PreExchangeRegistersOnlyUnfilledRemainderInRisk) {
+    EngineMetrics metrics;
+    TradeSystem system;
+    RecordingClientSink client;
+    RecordingExchangeSink exchange;
+    system.setClientSink(&client);
+    system.setExchangeSink(&exchange);
+    system.setMetrics(&metrics);
+
+    auto confirmLastCancel = [&] {
+        CancelResponse confirm;
+        confirm.clOrderId = exchange.cancels.back().clOrderId;
+        confirm.origClOrderId = exchange.cancels.back().origClOrderId;
+        confirm.type = CancelResponse::CONFIRM;
+        system.handleResponse(confirm);
+    };
+    auto riskOrders = [&] {
+        system.publishMetrics();
+        return metrics.snapshot().gauge(MetricGauge::RISK_ORDERS);
+    };
+
+    // 主动方全部成交：对手方从风控移除，主动方不登记
+    system.handleOrder(makeOrder("S1", Side::SELL, 10.0, 100, "SH001"));
+    system.handleOrder(makeOrder("B1", Side::BUY, 10.0, 100, "SH002"));
+    EXPECT_EQ(riskOrders(), 1u);
+    confirmLastCancel();
+    ASSERT_EQ(client.orders.size(), 2u);
+    EXPECT_EQ(client.orders[1].clOrderId, "B1");
+    EXPECT_EQ(riskOrders(), 0u);
+
+    // 同一股东反向下单，已成交的 B1 不构成对敲
+    system.handleOrder(makeOrder("S2", Side::SELL, 10.0, 100, "SH002"));
+    EXPECT_EQ(client.orders.size(), 2u);
+    EXPECT_EQ(exchange.orders.back().clOrderId, "S2");
+    EXPECT_EQ(riskOrders(), 1u);
+
+    // 主动方部分成交：只有转发交易所的剩余部分登记到风控
+    system.handleOrder(makeOrder("B2", Side::BUY, 10.0, 300, "SH003"));
+    confirmLastCancel();
+    EXPECT_EQ(exchange.orders.back().clOrderId, "B2");
+    EXPECT_EQ(exchange.orders.back().qty, 200u);
+    EXPECT_EQ(riskOrders(), 1u);
+
+    // 剩余部分仍参与对敲检测
+    system.handleOrder(makeOrder("S3", Side::SELL, 10.0, 100, "SH003"));
+    ASSERT_EQ(client.orders.size(), 5u);
+    EXPECT_EQ(client.orders.back().clOrderId, "S3");
+    EXPECT_EQ(client.orders.back().type, OrderResponse::REJECT);
+    EXPECT_EQ(client.orders.back().rejectCode, ORDER_CROSS_TRADE_REJECT_CODE);
+    EXPECT_EQ(riskOrders(), 1u);
+}
+
+TEST(TradeSystemSink, CancelResponseJsonRoundTrip) {
+    CancelResponse response;
+    response.clOrderId = "C1";
+    response.origClOrderId = "B1";
+    response.market = Market::XSHE;
+    response.securityId = "000001";
+    response.shareholderId = "SZ001";
+    response.side = Side::BUY;
+    response.qty = 300;
+    response.price = Price::fromDouble(9.87);
+    response.cumQty = 100;
+    response.canceledQty = 200;
+
+    CancelResponse parsed = json(response).get<CancelResponse>();
+    EXPECT_EQ(parsed.type, CancelResponse::CONFIRM);
+    EXPECT_EQ(parsed.origClOrderId, "B1");
+    EXPECT_EQ(parsed.market, Market::XSHE);
+    EXPECT_EQ(parsed.price, response.price);
+    EXPECT_EQ(parsed.canceledQty, 200u);
+
+    response.type = CancelResponse::REJECT;
+    response.rejectCode = CANCEL_ORDER_NOT_FOUND_REJECT_CODE;
+    response.rejectText = CANCEL_ORDER_NOT_FOUND_REJECT_REASON;
+    json rejected = response;
+    EXPECT_FALSE(rejected.contains("market"));
+    EXPECT_EQ(rejected.get<CancelResponse>().type, CancelResponse::REJECT);
+}
@@ -0,0 +1,175 @@
+#include "constants.h"
+#include "trade_system.h"
+#include "wire_protocol.h"
+#include "wire_sink.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace hdf;
+
+namespace {
+
+Order makeOrder(const std::string &clOrderId, Side side, double price,
+                uint32_t qty, const std::string &shareholderId) {
+    Order order;
+    order.clOrderId = clOrderId;
+    order.market = Market::XSHG;
+    order.securityId = "600030";
+    order.side = side;
+    order.price = Price::fromDouble(price);
+    order.qty = qty;
+    order.shareholderId = shareholderId;
+    return order;
+}
+
+std::vector<uint8_t> encodeToVector(const auto &message) {
+    std::vector<uint8_t> buffer(wire::MAX_MESSAGE_SIZE);
+    buffer.resize(wire::encode(message, buffer.data()));
+    return buffer;
+}
+
+} // namespace
+
+TEST(WireProtocol, OrderLayoutIsLittleEndian) {
+    Order order = makeOrder("1001", Side::BUY, 10.5, 1000, "SH001");
+    auto bytes = encodeToVector(order);
+
+    ASSERT_EQ(bytes.size(), wire::HEADER_SIZE + wire::ORDER_FIELDS_SIZE);
+    // 消息头：blockLength, templateId, schemaId, version
+    EXPECT_EQ(bytes[0], wire::ORDER_FIELDS_SIZE & 0xFF);
+    EXPECT_EQ(bytes[2], 1);
+    EXPECT_EQ(bytes[3], 0);
+    // 价格紧跟在 clOrderId、market、securityId、side 之后
+    size_t priceOffset = wire::HEADER_SIZE + ClOrderId::CAPACITY + 1 +
+                         SecurityId::CAPACITY + 1;
+    int64_t raw = 0;
+    for (int i = 7; i >= 0; i--) {
+        raw = (raw << 8) | bytes[priceOffset + i];
+    }
+    EXPECT_EQ(raw, 105000);
+    EXPECT_EQ(bytes[priceOffset - 1], 'B');
+}
+
+TEST(WireProtocol, RoundTripAllMessages) {
+    Order order = makeOrder("1001", Side::SELL, 9.99, 300, "SH001");
+    Order decodedOrder;
+    ASSERT_EQ(wire::decode(encodeToVector(order), decodedOrder), nullptr);
+    EXPECT_EQ(decodedOrder.clOrderId, "1001");
+    EXPECT_EQ(decodedOrder.side, Side::SELL);
+    EXPECT_EQ(decodedOrder.price, order.price);
+    EXPECT_EQ(decodedOrder.qty, 300u);
+    EXPECT_EQ(decodedOrder.shareholderId, "SH001");
+
+    CancelOrder cancel{"C1", "1001", Market::BJSE, "430047", "BJ001",
+                       Side::BUY};
+    CancelOrder decodedCancel;
+    ASSERT_EQ(wire::decode(encodeToVector(cancel), decodedCancel), nullptr);
+    EXPECT_EQ(decodedCancel.origClOrderId, "1001");
+    EXPECT_EQ(decodedCancel.market, Market::BJSE);
+
+    OrderResponse exec;
+    exec.clOrderId = "1001";
+    exec.market = Market::XSHE;
+    exec.securityId = "000001";
+    exec.side = Side::BUY;
+    exec.qty = 500;
+    exec.price = Price::fromDouble(20.0);
+    exec.shareholderId = "SZ001";
+    exec.execId = "E42";
+    exec.execQty = 200;
+    exec.execPrice = Price::fromDouble(19.98);
+    exec.type = OrderResponse::EXECUTION;
+    OrderResponse decodedExec;
+    ASSERT_EQ(wire::decode(encodeToVector(exec), decodedExec), nullptr);
+    EXPECT_EQ(decodedExec.type, OrderResponse::EXECUTION);
+    EXPECT_EQ(decodedExec.execId, "E42");
+    EXPECT_EQ(decodedExec.execQty, 200u);
+    EXPECT_EQ(decodedExec.execPrice, exec.execPrice);
+
+    // 订单字段未知的拒绝回报
+    OrderResponse reject;
+    reject.clOrderId = "BAD";
+    reject.rejectCode = ORDER_INVALID_FORMAT_REJECT_CODE;
+    reject.rejectText = std::string(100, 'x');
+    reject.type = OrderResponse::REJECT;
+    OrderResponse decodedReject;
+    ASSERT_EQ(wire::decode(encodeToVector(reject), decodedReject), nullptr);
+    EXPECT_EQ(decodedReject.type, OrderResponse::REJECT);
+    EXPECT_EQ(decodedReject.market, Market::UNKNOWN);
+    EXPECT_EQ(decodedReject.rejectText.size(), wire::REJECT_TEXT_SIZE);
+
+    CancelResponse cancelConfirm;
+    cancelConfirm.clOrderId = "C1";
+    cancelConfirm.origClOrderId = "1001";
+    cancelConfirm.market = Market::XSHG;
+    cancelConfirm.securityId = "600030";
+    cancelConfirm.shareholderId = "SH001";
+    cancelConfirm.side = Side::SELL;
+    cancelConfirm.qty = 300;
+    cancelConfirm.price = Price::fromDouble(9.99);
+    cancelConfirm.cumQty = 100;
+    cancelConfirm.canceledQty = 200;
+    CancelResponse decodedCancelConfirm;
+    ASSERT_EQ(
+        wire::decode(encodeToVector(cancelConfirm), decodedCancelConfirm),
+        nullptr);
+    EXPECT_EQ(decodedCancelConfirm.type, CancelResponse::CONFIRM);
+    EXPECT_EQ(decodedCancelConfirm.cumQty, 100u);
+    EXPECT_EQ(decodedCancelConfirm.canceledQty, 200u);
+}
+
+TEST(WireProtocol, HeaderFraming) {
+    auto bytes = encodeToVector(makeOrder("1", Side::BUY, 1.0, 100, "SH"));
+    wire::MessageHeader header;
+
+    // 数据不足时返回0
+    EXPECT_EQ(wire::decodeHeader({bytes.data(), 4}, header), 0u);
+    EXPECT_EQ(wire::decodeHeader({bytes.data(), bytes.size() - 1}, header),
+              0u);
+    EXPECT_EQ(wire::decodeHeader(bytes, header), bytes.size());
+    EXPECT_EQ(header.templateId, wire::TemplateId::NEW_ORDER);
+
+    // 新版本在尾部追加的字段被跳过
+    std::vector<uint8_t> extended = bytes;
+    extended.resize(bytes.size() + 4);
+    extended[0] += 4;
+    EXPECT_EQ(wire::decodeHeader(extended, header), extended.size());
+
+    std::vector<uint8_t> badSchema = bytes;
+    badSchema[4] ^= 0xFF;
+    EXPECT_THROW(wire::decodeHeader(badSchema, header), std::invalid_argument);
+}
+
+TEST(WireProtocol, TradeSystemEndToEnd) {
+    TradeSystem system;
+    std::vector<std::vector<uint8_t>> outputs;
+    WireClientSink client([&](std::span<const uint8_t> message) {
+        outputs.emplace_back(message.begin(), message.end());
+    });
+    system.setClientSink(&client);
+
+    system.handleWire(
+        encodeToVector(makeOrder("S1", Side::SELL, 10.0, 100, "SH001")));
+    system.handleWire(
+        encodeToVector(makeOrder("B1", Side::BUY, 10.0, 100, "SH002")));
+    // 买单数量不是100的倍数
+    system.handleWire(
+        encodeToVector(makeOrder("B2", Side::BUY, 10.0, 50, "SH002")));
+
+    ASSERT_EQ(outputs.size(), 4u);
+    wire::MessageHeader header;
+    wire::decodeHeader(outputs[0], header);
+    EXPECT_EQ(header.templateId, wire::TemplateId::ORDER_CONFIRM);
+
+    OrderResponse active;
+    ASSERT_EQ(wire::decode(outputs[2], active), nullptr);
+    EXPECT_EQ(active.type, OrderResponse::EXECUTION);
+    EXPECT_EQ(active.clOrderId, "B1");
+    EXPECT_EQ(active.execQty, 100u);
+
+    OrderResponse reject;
+    ASSERT_EQ(wire::decode(outputs[3], reject), nullptr);
+    EXPECT_EQ(reject.type, OrderResponse::REJECT);
+    EXPECT_EQ(reject.clOrderId, "B2");
+    EXPECT_EQ(reject.rejectCode, ORDER_INVALID_FORMAT_REJECT_CODE);
+}